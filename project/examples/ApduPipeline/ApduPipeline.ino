@@ -0,0 +1,100 @@
+/*
+ * --------------------------------------------------------------------------------------------------------------------
+ * Example sketch/program sending a script of APDUs to an ISO/IEC 14443-4 card in one batch.
+ * --------------------------------------------------------------------------------------------------------------------
+ * This is a MFRC522 library example; for further details and other examples see: https://github.com/miguelbalboa/rfid
+ *
+ * MFRC522ApduPipeline runs the APDUs back to back with the frame waiting time and the CRC mode set up once
+ * for the whole script, stops at the first status word other than 90 00, and reports the latency of each
+ * exchange. The script below selects the NDEF application (NFC Forum Type 4 Tag) and reads its capability
+ * container; replace it with your own personalisation commands.
+ *
+ * Typical pin layout used:
+ * -----------------------------------------------------------------------------------------
+ *             MFRC522      Arduino       Arduino   Arduino    Arduino          Arduino
+ *             Reader/PCD   Uno/101       Mega      Nano v3    Leonardo/Micro   Pro Micro
+ * Signal      Pin          Pin           Pin       Pin        Pin              Pin
+ * -----------------------------------------------------------------------------------------
+ * RST/Reset   RST          9             5         D9         RESET/ICSP-5     RST
+ * SPI SS      SDA(SS)      10            53        D10        10               10
+ * SPI MOSI    MOSI         11 / ICSP-4   51        D11        ICSP-4           16
+ * SPI MISO    MISO         12 / ICSP-1   50        D12        ICSP-1           14
+ * SPI SCK     SCK          13 / ICSP-3   52        D13        ICSP-3           15
+ */
+
+#include <SPI.h>
+#include <MFRC522Extended.h>
+#include <MFRC522ApduPipeline.h>
+
+#define RST_PIN         9           // Configurable, see typical pin layout above
+#define SS_PIN          10          // Configurable, see typical pin layout above
+
+MFRC522Extended mfrc522(SS_PIN, RST_PIN);  // Create MFRC522 instance
+MFRC522ApduPipeline pipeline(mfrc522, true);
+
+const byte selectNdefApp[] = { 0x00, 0xA4, 0x04, 0x00, 0x07, 0xD2, 0x76, 0x00, 0x00, 0x85, 0x01, 0x01, 0x00 };
+const byte selectCC[]      = { 0x00, 0xA4, 0x00, 0x0C, 0x02, 0xE1, 0x03 };
+const byte readCC[]        = { 0x00, 0xB0, 0x00, 0x00, 0x0F };
+
+byte ccBuffer[32];
+
+MFRC522ApduPipeline::ComandoApdu script[] = {
+  { selectNdefApp, sizeof(selectNdefApp), NULL, 0 },
+  { selectCC, sizeof(selectCC), NULL, 0 },
+  { readCC, sizeof(readCC), ccBuffer, sizeof(ccBuffer) },
+};
+const byte scriptLength = sizeof(script) / sizeof(script[0]);
+
+void setup() {
+  Serial.begin(9600);        // Initialize serial communications with the PC
+  while (!Serial);           // Do nothing if no serial port is opened (added for Arduinos based on ATMEGA32U4)
+  SPI.begin();               // Init SPI bus
+  mfrc522.PCD_Init();        // Init MFRC522 card
+  Serial.println(F("Scan an ISO/IEC 14443-4 card."));
+}
+
+void loop() {
+  // Reset the loop if no new card present on the sensor/reader. This saves the entire process when idle.
+  if ( ! mfrc522.PICC_IsNewCardPresent()) {
+    return;
+  }
+
+  // Select one of the cards
+  if ( ! mfrc522.PICC_ReadCardSerial()) {
+    return;
+  }
+
+  if (mfrc522.PICC_GetType(&mfrc522.tag) != MFRC522::PICC_TYPE_ISO_14443_4) {
+    Serial.println(F("Not an ISO/IEC 14443-4 card."));
+    mfrc522.PICC_HaltA();
+    return;
+  }
+
+  byte executed;
+  MFRC522::StatusCode status = pipeline.Run(&mfrc522.tag, script, scriptLength, &executed);
+
+  for (byte i = 0; i < executed; i++) {
+    Serial.print(F("APDU "));
+    Serial.print(i);
+    Serial.print(F(": SW "));
+    Serial.print(script[i].sw, HEX);
+    Serial.print(F(", "));
+    Serial.print(script[i].latenciaUs);
+    Serial.println(F(" us"));
+  }
+  Serial.print(F("Total: "));
+  Serial.print(pipeline.GetTotalTime());
+  Serial.print(F(" us, "));
+  Serial.println(mfrc522.GetStatusCodeName(status));
+
+  if (status == MFRC522::STATUS_OK) {
+    Serial.print(F("Capability container:"));
+    for (uint16_t i = 0; i + 2 < script[2].tamanhoResposta; i++) {
+      Serial.print(ccBuffer[i] < 0x10 ? F(" 0") : F(" "));
+      Serial.print(ccBuffer[i], HEX);
+    }
+    Serial.println();
+  }
+
+  mfrc522.TCL_Deselect(&mfrc522.tag);
+}
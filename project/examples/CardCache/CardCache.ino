@@ -0,0 +1,151 @@
+/*
+ * --------------------------------------------------------------------------------------------------------------------
+ * Example sketch/program showing a UID-keyed record cache with SD card spill.
+ * --------------------------------------------------------------------------------------------------------------------
+ * This is a MFRC522 library example; for further details and other examples see: https://github.com/miguelbalboa/rfid
+ *
+ * The personal-data record lives in a MFRC522RecordStore (directory in block 4, copies in blocks 5 and 6
+ * of a MIFARE 1K card). Its directory carries a version counter, so a repeat swipe of an unchanged card
+ * costs one authentication and one block read: the record itself comes from the cache.
+ * Four records are kept in RAM; records pushed out of RAM are saved to the SD card, one file per card.
+ *
+ * Write a record first with the RecordStore example (same block layout).
+ *
+ * Typical pin layout used:
+ * -----------------------------------------------------------------------------------------
+ *             MFRC522      Arduino       Arduino   Arduino    Arduino          Arduino
+ *             Reader/PCD   Uno/101       Mega      Nano v3    Leonardo/Micro   Pro Micro
+ * Signal      Pin          Pin           Pin       Pin        Pin              Pin
+ * -----------------------------------------------------------------------------------------
+ * RST/Reset   RST          9             5         D9         RESET/ICSP-5     RST
+ * SPI SS      SDA(SS)      10            53        D10        10               10
+ * SPI MOSI    MOSI         11 / ICSP-4   51        D11        ICSP-4           16
+ * SPI MISO    MISO         12 / ICSP-1   50        D12        ICSP-1           14
+ * SPI SCK     SCK          13 / ICSP-3   52        D13        ICSP-3           15
+ */
+
+ * SD card CS: pin 4.
+ */
+
+#include <SPI.h>
+#include <SD.h>
+#include <MFRC522.h>
+#include <MFRC522RecordStore.h>
+#include <MFRC522CardCache.h>
+
+#define RST_PIN         9           // Configurable, see typical pin layout above
+#define SS_PIN          10          // Configurable, see typical pin layout above
+#define SD_CS_PIN       4           // Configurable, SD card chip select
+#define CACHE_ENTRIES   4           // Records kept in RAM
+
+// Saves records pushed out of RAM to the SD card, in a file named after the last 4 UID bytes.
+// The full UID is stored in the file and checked on load.
+class SdSpill : public MFRC522CardCache::Spill {
+public:
+  bool Load(const MFRC522::Uid *uid, uint16_t *version, byte *data, byte *length, byte capacity) {
+    char name[13];
+    FileName(uid, name);
+    File file = SD.open(name, FILE_READ);
+    if (!file) {
+      return false;
+    }
+    byte header[14];
+    bool found = file.read(header, sizeof(header)) == sizeof(header) && header[0] == uid->size
+                 && memcmp(&header[1], uid->uidByte, uid->size) == 0 && header[13] <= capacity
+                 && file.read(data, header[13]) == header[13];
+    file.close();
+    if (found) {
+      *version = header[11] | (header[12] << 8);
+      *length = header[13];
+    }
+    return found;
+  }
+
+  void Save(const MFRC522::Uid *uid, uint16_t version, const byte *data, byte length) {
+    char name[13];
+    FileName(uid, name);
+    SD.remove(name);
+    File file = SD.open(name, FILE_WRITE);
+    if (!file) {
+      return;
+    }
+    byte header[14] = { uid->size };
+    memcpy(&header[1], uid->uidByte, uid->size);
+    header[11] = version & 0xFF;
+    header[12] = version >> 8;
+    header[13] = length;
+    file.write(header, sizeof(header));
+    file.write(data, length);
+    file.close();
+  }
+
+private:
+  static void FileName(const MFRC522::Uid *uid, char *name) {
+    uint32_t tail = 0;
+    for (byte i = 0; i < uid->size; i++) {
+      tail = (tail << 8) | uid->uidByte[i];
+    }
+    sprintf(name, "%08lX.REC", (unsigned long)tail);
+  }
+};
+
+MFRC522 mfrc522(SS_PIN, RST_PIN);   // Create MFRC522 instance
+MFRC522RecordStore store(mfrc522, 4, 5, 6, 1); // Directory in block 4, copies in blocks 5 and 6
+SdSpill spill;
+MFRC522CardCache::Entrada cacheEntries[CACHE_ENTRIES];
+byte cacheData[CACHE_ENTRIES * 16];
+MFRC522CardCache cache(store, cacheEntries, cacheData, CACHE_ENTRIES, &spill);
+
+MFRC522::MIFARE_Key key;
+
+void setup() {
+  Serial.begin(9600);        // Initialize serial communications with the PC
+  while (!Serial);           // Do nothing if no serial port is opened (added for Arduinos based on ATMEGA32U4)
+  SPI.begin();               // Init SPI bus
+  mfrc522.PCD_Init();        // Init MFRC522 card
+  if (!SD.begin(SD_CS_PIN)) {
+    Serial.println(F("SD card not found, records are cached in RAM only."));
+  }
+
+  // Prepare key - all keys are set to FFFFFFFFFFFFh at chip delivery from the factory.
+  for (byte i = 0; i < 6; i++) key.keyByte[i] = 0xFF;
+
+  Serial.println(F("Scan a MIFARE 1K card to read its record."));
+}
+
+void loop() {
+  // Reset the loop if no new card present on the sensor/reader. This saves the entire process when idle.
+  if ( ! mfrc522.PICC_IsNewCardPresent()) {
+    return;
+  }
+
+  // Select one of the cards
+  if ( ! mfrc522.PICC_ReadCardSerial()) {
+    return;
+  }
+
+  byte record[16];
+  byte length = 0;
+  bool fromCache = false;
+  unsigned long start = millis();
+  MFRC522::StatusCode status = cache.Read(&(mfrc522.uid), MFRC522::PICC_CMD_MF_AUTH_KEY_A, &key, record, &length, &fromCache);
+  unsigned long elapsed = millis() - start;
+  if (status == MFRC522::STATUS_OK) {
+    Serial.print(fromCache ? F("Cached record (") : F("Card record ("));
+    Serial.print(elapsed);
+    Serial.print(F(" ms):"));
+    for (byte i = 0; i < length; i++) {
+      Serial.print(record[i] < 0x10 ? F(" 0") : F(" "));
+      Serial.print(record[i], HEX);
+    }
+    Serial.println();
+  } else {
+    Serial.print(F("Reading failed: "));
+    Serial.println(mfrc522.GetStatusCodeName(status));
+  }
+
+  // Halt PICC
+  mfrc522.PICC_HaltA();
+  // Stop encryption on PCD
+  mfrc522.PCD_StopCrypto1();
+}
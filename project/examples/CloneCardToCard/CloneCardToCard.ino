@@ -0,0 +1,110 @@
+/*
+ * --------------------------------------------------------------------------------------------------------------------
+ * Example sketch/program copying a MIFARE Classic PICC to another one, card to card, with two readers.
+ * --------------------------------------------------------------------------------------------------------------------
+ * This is a MFRC522 library example; for further details and other examples see: https://github.com/miguelbalboa/rfid
+ *
+ * The source card sits on reader 1 and the target card on reader 2; both readers share the SPI bus. The source is
+ * read sector by sector and each chunk of at most 4 blocks (64 bytes) is written to the target right away, so the
+ * card image is never held in RAM: a 4K card (4096 bytes) is copied on an Uno with 2 KB of RAM.
+ *
+ * A Gen1a ("magic", UID changeable) target gets everything, including block 0 (the UID) and every sector
+ * trailer, through the backdoor without any authentication. Any other target is written with one authentication
+ * per sector and keeps its block 0. MFRC522Magic tells them apart.
+ *
+ * Other destinations plug into the same MFRC522Clone::Stream() call: MFRC522ClonePrint writes the raw image to
+ * a File on an SD card, MFRC522CloneRam to a buffer, and any class derived from MFRC522CloneSink to anything else.
+ *
+ * Both cards must use the factory default key FFFFFFFFFFFFh as Key A.
+ *
+ * Typical pin layout used:
+ * -----------------------------------------------------------------------------------------
+ *             MFRC522      Arduino       Arduino   Arduino    Arduino          Arduino
+ *             Reader/PCD   Uno/101       Mega      Nano v3    Leonardo/Micro   Pro Micro
+ * Signal      Pin          Pin           Pin       Pin        Pin              Pin
+ * -----------------------------------------------------------------------------------------
+ * RST/Reset   RST          9             5         D9         RESET/ICSP-5     RST
+ * SPI SS 1    SDA(SS)      ** custom, take a unused pin, only HIGH/LOW required **
+ * SPI SS 2    SDA(SS)      ** custom, take a unused pin, only HIGH/LOW required **
+ * SPI MOSI    MOSI         11 / ICSP-4   51        D11        ICSP-4           16
+ * SPI MISO    MISO         12 / ICSP-1   50        D12        ICSP-1           14
+ * SPI SCK     SCK          13 / ICSP-3   52        D13        ICSP-3           15
+ */
+
+#include <SPI.h>
+#include <MFRC522.h>
+#include <MFRC522Clone.h>
+#include <MFRC522Magic.h>
+
+#define RST_PIN         9           // Configurable, see typical pin layout above
+#define SS_SOURCE_PIN   10          // Configurable, take a unused pin, only HIGH/LOW required, must be different to SS_TARGET_PIN
+#define SS_TARGET_PIN   8           // Configurable, take a unused pin, only HIGH/LOW required, must be different to SS_SOURCE_PIN
+
+MFRC522 source;                     // Reader with the card to copy
+MFRC522 target;                     // Reader with the blank card
+MFRC522Clone clone(source);
+MFRC522Magic magic(target);
+
+void setup() {
+  Serial.begin(9600);       // Initialize serial communications with the PC
+  while (!Serial);          // Do nothing if no serial port is opened (added for Arduinos based on ATMEGA32U4)
+  SPI.begin();              // Init SPI bus
+  source.PCD_Init(SS_SOURCE_PIN, RST_PIN);
+  target.PCD_Init(SS_TARGET_PIN, RST_PIN);
+  Serial.println(F("Place the source card on reader 1 and the target card on reader 2."));
+}
+
+// Selects a card on the reader, false if there is none
+bool selectCard(MFRC522 &reader) {
+  return reader.PICC_IsNewCardPresent() && reader.PICC_ReadCardSerial();
+}
+
+void loop() {
+  if (!selectCard(source) || !selectCard(target)) {
+    return;
+  }
+
+  MFRC522::PICC_Type piccType = source.PICC_GetType(source.uid.sak);
+  Serial.print(F("Source: "));
+  Serial.println(source.PICC_GetTypeName(piccType));
+  if (MFRC522Clone::GetBlockCount(piccType) == 0) {
+    Serial.println(F("Only MIFARE Classic cards can be copied."));
+    source.PICC_HaltA();
+    target.PICC_HaltA();
+    return;
+  }
+
+  MFRC522::MIFARE_Key key;
+  for (byte i = 0; i < MFRC522::MF_KEY_SIZE; i++) {
+    key.keyByte[i] = 0xFF;
+  }
+
+  MFRC522Magic::Generation generation;
+  MFRC522::StatusCode status = magic.Identify(&target.uid, &key, false, &generation);
+  if (status == MFRC522::STATUS_OK) {
+    Serial.print(F("Target: "));
+    Serial.println(MFRC522Magic::GetGenerationName(generation));
+
+    unsigned long start = millis();
+    MFRC522CloneCard destination(target, &target.uid, &key, generation == MFRC522Magic::MAGIC_GEN1A);
+    status = clone.Stream(&source.uid, piccType, &key, destination);
+    Serial.print(F("Copy took "));
+    Serial.print(millis() - start);
+    Serial.println(F(" ms"));
+  }
+
+  if (status == MFRC522::STATUS_OK) {
+    Serial.println(F("Copy done."));
+  } else {
+    Serial.print(F("Copy failed at source block "));
+    Serial.print(clone.GetLastBlock());
+    Serial.print(F(": "));
+    Serial.println(MFRC522::GetStatusCodeName(status));
+  }
+
+  source.PICC_HaltA();
+  source.PCD_StopCrypto1();
+  target.PICC_HaltA();
+  target.PCD_StopCrypto1();
+  delay(2000);
+}
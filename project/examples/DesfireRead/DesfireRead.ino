@@ -0,0 +1,124 @@
+/*
+ * --------------------------------------------------------------------------------------------------------------------
+ * Example sketch/program listing the applications and files of a MIFARE DESFire EV1/EV2 PICC and dumping a file.
+ * --------------------------------------------------------------------------------------------------------------------
+ * This is a MFRC522 library example; for further details and other examples see: https://github.com/miguelbalboa/rfid
+ *
+ * MFRC522Desfire sends the native DESFire commands (or ISO/IEC 7816-4 wrapped ones) and follows the
+ * ADDITIONAL_FRAME (0xAF) continuation itself. The data of each response frame is handed to a callback as
+ * it arrives, so a file of any size is dumped with one frame of RAM. Only files with plain communication
+ * and free read access can be read: authentication is not part of the library.
+ *
+ * Typical pin layout used:
+ * -----------------------------------------------------------------------------------------
+ *             MFRC522      Arduino       Arduino   Arduino    Arduino          Arduino
+ *             Reader/PCD   Uno/101       Mega      Nano v3    Leonardo/Micro   Pro Micro
+ * Signal      Pin          Pin           Pin       Pin        Pin              Pin
+ * -----------------------------------------------------------------------------------------
+ * RST/Reset   RST          9             5         D9         RESET/ICSP-5     RST
+ * SPI SS      SDA(SS)      10            53        D10        10               10
+ * SPI MOSI    MOSI         11 / ICSP-4   51        D11        ICSP-4           16
+ * SPI MISO    MISO         12 / ICSP-1   50        D12        ICSP-1           14
+ * SPI SCK     SCK          13 / ICSP-3   52        D13        ICSP-3           15
+ */
+
+#include <SPI.h>
+#include <MFRC522Extended.h>
+#include <MFRC522Desfire.h>
+
+#define RST_PIN         9           // Configurable, see typical pin layout above
+#define SS_PIN          10          // Configurable, see typical pin layout above
+
+MFRC522Extended mfrc522(SS_PIN, RST_PIN);  // Create MFRC522 instance
+MFRC522Desfire desfire(mfrc522);
+
+uint32_t firstAid = 0;              // First application found, 0 if none
+byte firstFile = 0xFF;              // First file of that application, 0xFF if none
+uint32_t dumped = 0;                // Bytes of the file dumped so far
+
+bool printAids(const byte *data, byte length, void *) {
+  for (byte i = 0; i + 2 < length; i += 3) {
+    uint32_t aid = data[i] | ((uint32_t)data[i + 1] << 8) | ((uint32_t)data[i + 2] << 16);
+    Serial.print(F("Application "));
+    Serial.println(aid, HEX);
+    if (!firstAid) {
+      firstAid = aid;
+    }
+  }
+  return true;
+}
+
+bool printFiles(const byte *data, byte length, void *) {
+  for (byte i = 0; i < length; i++) {
+    Serial.print(F("  File "));
+    Serial.println(data[i]);
+    if (firstFile == 0xFF) {
+      firstFile = data[i];
+    }
+  }
+  return true;
+}
+
+bool printData(const byte *data, byte length, void *) {
+  for (byte i = 0; i < length; i++, dumped++) {
+    if (dumped % 16 == 0) {
+      Serial.println();
+    }
+    Serial.print(data[i] < 0x10 ? F(" 0") : F(" "));
+    Serial.print(data[i], HEX);
+  }
+  return true;
+}
+
+void setup() {
+  Serial.begin(9600);        // Initialize serial communications with the PC
+  while (!Serial);           // Do nothing if no serial port is opened (added for Arduinos based on ATMEGA32U4)
+  SPI.begin();               // Init SPI bus
+  mfrc522.PCD_Init();        // Init MFRC522 card
+  Serial.println(F("Scan a MIFARE DESFire PICC."));
+}
+
+void loop() {
+  // Reset the loop if no new card present on the sensor/reader. This saves the entire process when idle.
+  if ( ! mfrc522.PICC_IsNewCardPresent()) {
+    return;
+  }
+
+  // Select one of the cards
+  if ( ! mfrc522.PICC_ReadCardSerial()) {
+    return;
+  }
+
+  if (mfrc522.PICC_GetType(&mfrc522.tag) != MFRC522::PICC_TYPE_MIFARE_DESFIRE) {
+    Serial.println(F("Not a MIFARE DESFire PICC."));
+    mfrc522.PICC_HaltA();
+    return;
+  }
+
+  firstAid = 0;
+  firstFile = 0xFF;
+  dumped = 0;
+
+  MFRC522::StatusCode status = desfire.GetApplicationIDs(printAids, NULL);
+  if (status == MFRC522::STATUS_OK && firstAid) {
+    status = desfire.SelectApplication(firstAid);
+  }
+  if (status == MFRC522::STATUS_OK && firstAid) {
+    status = desfire.GetFileIDs(printFiles, NULL);
+  }
+  if (status == MFRC522::STATUS_OK && firstFile != 0xFF) {
+    Serial.print(F("File "));
+    Serial.print(firstFile);
+    Serial.print(F(":"));
+    status = desfire.ReadData(firstFile, 0, 0, printData, NULL);
+    Serial.println();
+    Serial.print(dumped);
+    Serial.println(F(" bytes"));
+  }
+
+  Serial.print(mfrc522.GetStatusCodeName(status));
+  Serial.print(F(", DESFire status 0x"));
+  Serial.println(desfire.GetLastStatus(), HEX);
+
+  mfrc522.TCL_Deselect(&mfrc522.tag);
+}
@@ -0,0 +1,66 @@
+/*
+ * --------------------------------------------------------------------------------------------------------------------
+ * Example sketch/program writing a compact binary dump of a MIFARE Classic or Ultralight PICC to Serial.
+ * --------------------------------------------------------------------------------------------------------------------
+ * This is a MFRC522 library example; for further details and other examples see: https://github.com/miguelbalboa/rfid
+ *
+ * The DumpInfo example prints every byte as padded hex text. This one streams the same content through
+ * MFRC522DumpBinary: a header with UID/SAK/type, one record per sector and per block with its status, and a
+ * CRC32 at the end. A 1K card dump is about 1.2 KB instead of about 6 KB of text. Any Print works as output,
+ * for example a File on an SD card.
+ *
+ * Capture the serial output to a file on the computer and decode it with extras/mfrc522_dump.py:
+ *   python3 mfrc522_dump.py hex card.mfd
+ *   python3 mfrc522_dump.py json card.mfd
+ *   python3 mfrc522_dump.py diff card1.mfd card2.mfd
+ *
+ * Typical pin layout used:
+ * -----------------------------------------------------------------------------------------
+ *             MFRC522      Arduino       Arduino   Arduino    Arduino          Arduino
+ *             Reader/PCD   Uno/101       Mega      Nano v3    Leonardo/Micro   Pro Micro
+ * Signal      Pin          Pin           Pin       Pin        Pin              Pin
+ * -----------------------------------------------------------------------------------------
+ * RST/Reset   RST          9             5         D9         RESET/ICSP-5     RST
+ * SPI SS      SDA(SS)      10            53        D10        10               10
+ * SPI MOSI    MOSI         11 / ICSP-4   51        D11        ICSP-4           16
+ * SPI MISO    MISO         12 / ICSP-1   50        D12        ICSP-1           14
+ * SPI SCK     SCK          13 / ICSP-3   52        D13        ICSP-3           15
+ */
+
+#include <SPI.h>
+#include <MFRC522.h>
+#include <MFRC522Dump.h>
+
+#define RST_PIN         9           // Configurable, see typical pin layout above
+#define SS_PIN          10          // Configurable, see typical pin layout above
+
+MFRC522 mfrc522(SS_PIN, RST_PIN);   // Create MFRC522 instance
+MFRC522DumpReader reader(mfrc522);
+
+void setup() {
+  Serial.begin(115200);      // Initialize serial communications with the PC
+  while (!Serial);           // Do nothing if no serial port is opened (added for Arduinos based on ATMEGA32U4)
+  SPI.begin();               // Init SPI bus
+  mfrc522.PCD_Init();        // Init MFRC522 card
+}
+
+void loop() {
+  // Reset the loop if no new card present on the sensor/reader. This saves the entire process when idle.
+  if ( ! mfrc522.PICC_IsNewCardPresent()) {
+    return;
+  }
+
+  // Select one of the cards
+  if ( ! mfrc522.PICC_ReadCardSerial()) {
+    return;
+  }
+
+  // All keys are set to FFFFFFFFFFFFh at chip delivery from the factory.
+  MFRC522::MIFARE_Key key;
+  for (byte i = 0; i < 6; i++) {
+    key.keyByte[i] = 0xFF;
+  }
+
+  MFRC522DumpBinary dump(Serial);
+  reader.Read(&(mfrc522.uid), 0, &key, dump, false);
+}
@@ -0,0 +1,136 @@
+/*
+ * --------------------------------------------------------------------------------------------------------------------
+ * Example sketch/program reading and writing NDEF messages on NTAG21x / MIFARE Ultralight PICCs.
+ * --------------------------------------------------------------------------------------------------------------------
+ * This is a MFRC522 library example; for further details and other examples see: https://github.com/miguelbalboa/rfid
+ *
+ * The tag is identified with MFRC522Ultralight to find its user pages. Every NDEF record on the tag is
+ * printed, payload included, through a 16 byte buffer: the message is never held in RAM as a whole.
+ * Send 'w' over the serial monitor before scanning to write a two record message (a URI and a text)
+ * instead; the pages are written as soon as each one is complete.
+ *
+ * WARNING: writing overwrites the NDEF message on the tag.
+ *
+ * Typical pin layout used:
+ * -----------------------------------------------------------------------------------------
+ *             MFRC522      Arduino       Arduino   Arduino    Arduino          Arduino
+ *             Reader/PCD   Uno/101       Mega      Nano v3    Leonardo/Micro   Pro Micro
+ * Signal      Pin          Pin           Pin       Pin        Pin              Pin
+ * -----------------------------------------------------------------------------------------
+ * RST/Reset   RST          9             5         D9         RESET/ICSP-5     RST
+ * SPI SS      SDA(SS)      10            53        D10        10               10
+ * SPI MOSI    MOSI         11 / ICSP-4   51        D11        ICSP-4           16
+ * SPI MISO    MISO         12 / ICSP-1   50        D12        ICSP-1           14
+ * SPI SCK     SCK          13 / ICSP-3   52        D13        ICSP-3           15
+ */
+
+#include <SPI.h>
+#include <MFRC522.h>
+#include <MFRC522Ultralight.h>
+#include <MFRC522Ndef.h>
+
+#define RST_PIN         9           // Configurable, see typical pin layout above
+#define SS_PIN          10          // Configurable, see typical pin layout above
+
+MFRC522 mfrc522(SS_PIN, RST_PIN);   // Create MFRC522 instance
+MFRC522Ultralight ultralight(mfrc522);
+
+bool writeNext = false;
+
+const byte uriType[] = { 'U' };
+const byte uriPayload[] = { 0x04, 'g', 'i', 't', 'h', 'u', 'b', '.', 'c', 'o', 'm', '/', 'm', 'i', 'g', 'u', 'e', 'l', 'b', 'a', 'l', 'b', 'o', 'a', '/', 'r', 'f', 'i', 'd' }; // 0x04 = "https://"
+const byte textType[] = { 'T' };
+const byte textPayload[] = { 0x02, 'e', 'n', 'H', 'e', 'l', 'l', 'o', ' ', 'N', 'D', 'E', 'F' };           // UTF-8, language "en"
+
+void setup() {
+  Serial.begin(9600);        // Initialize serial communications with the PC
+  while (!Serial);           // Do nothing if no serial port is opened (added for Arduinos based on ATMEGA32U4)
+  SPI.begin();               // Init SPI bus
+  mfrc522.PCD_Init();        // Init MFRC522 card
+  Serial.println(F("Scan an NTAG21x or Ultralight tag to print its NDEF records. Send 'w' to write a message instead."));
+}
+
+void printRecords(MFRC522NdefReader &reader) {
+  MFRC522NdefReader::NdefRecord record;
+  MFRC522::StatusCode status;
+  while ((status = reader.NextRecord(&record)) == MFRC522::STATUS_OK) {
+    Serial.print(F("TNF "));
+    Serial.print(record.header & NDEF_TNF_MASK);
+    Serial.print(F(", type \""));
+    for (byte i = 0; i < record.typeLength && i < MFRC522NdefReader::MAX_TYPE_LENGTH; i++) {
+      Serial.write(record.type[i]);
+    }
+    Serial.print(F("\", "));
+    Serial.print(record.payloadLength);
+    Serial.print(record.header & NDEF_FLAG_CF ? F(" bytes (chunk): ") : F(" bytes: "));
+
+    byte chunk[16];
+    uint16_t length;
+    while ((status = reader.ReadPayload(chunk, sizeof(chunk), &length)) == MFRC522::STATUS_OK && length) {
+      for (uint16_t i = 0; i < length; i++) {
+        Serial.write(chunk[i] >= 0x20 && chunk[i] < 0x7F ? chunk[i] : '.');
+      }
+    }
+    Serial.println();
+    if (status != MFRC522::STATUS_OK) {
+      break;
+    }
+  }
+  if (status != MFRC522::STATUS_NO_ROOM) {
+    Serial.print(F("Read failed: "));
+    Serial.println(mfrc522.GetStatusCodeName(status));
+  }
+}
+
+MFRC522::StatusCode writeMessage(MFRC522NdefWriter &writer) {
+  uint16_t messageLength = MFRC522NdefWriter::RecordSize(sizeof(uriType), sizeof(uriPayload))
+                         + MFRC522NdefWriter::RecordSize(sizeof(textType), sizeof(textPayload));
+  MFRC522::StatusCode status = writer.Begin(messageLength);
+  if (status == MFRC522::STATUS_OK) status = writer.AddRecord(NDEF_FLAG_MB | NDEF_TNF_WELL_KNOWN, uriType, sizeof(uriType), sizeof(uriPayload));
+  if (status == MFRC522::STATUS_OK) status = writer.Write(uriPayload, sizeof(uriPayload));
+  if (status == MFRC522::STATUS_OK) status = writer.AddRecord(NDEF_FLAG_ME | NDEF_TNF_WELL_KNOWN, textType, sizeof(textType), sizeof(textPayload));
+  if (status == MFRC522::STATUS_OK) status = writer.Write(textPayload, sizeof(textPayload));
+  if (status == MFRC522::STATUS_OK) status = writer.End();
+  return status;
+}
+
+void loop() {
+  if (Serial.available() && Serial.read() == 'w') {
+    writeNext = true;
+    Serial.println(F("The next tag will be written."));
+  }
+
+  // Reset the loop if no new card present on the sensor/reader. This saves the entire process when idle.
+  if ( ! mfrc522.PICC_IsNewCardPresent()) {
+    return;
+  }
+
+  // Select one of the cards
+  if ( ! mfrc522.PICC_ReadCardSerial()) {
+    return;
+  }
+
+  MFRC522Ultralight::Product product;
+  MFRC522::StatusCode status = ultralight.Identify(&(mfrc522.uid), &product);
+  if (status != MFRC522::STATUS_OK) {
+    Serial.print(F("Identify() failed: "));
+    Serial.println(mfrc522.GetStatusCodeName(status));
+    return;
+  }
+  MFRC522Ultralight::Geometria geometry = MFRC522Ultralight::GetGeometry(product);
+  Serial.println(MFRC522Ultralight::GetProductName(product));
+
+  if (writeNext) {
+    MFRC522NdefWriter writer(mfrc522, geometry.primeiraPaginaUsuario, geometry.ultimaPaginaUsuario);
+    status = writeMessage(writer);
+    Serial.print(F("Write: "));
+    Serial.println(mfrc522.GetStatusCodeName(status));
+    writeNext = false;
+  } else {
+    MFRC522NdefReader reader(mfrc522, geometry.primeiraPaginaUsuario, geometry.ultimaPaginaUsuario, geometry.fastRead);
+    printRecords(reader);
+  }
+
+  // Halt PICC
+  mfrc522.PICC_HaltA();
+}
@@ -0,0 +1,109 @@
+/*
+ * --------------------------------------------------------------------------------------------------------------------
+ * Example sketch/program comparing MIFARE_Read() with FAST_READ on NTAG21x / MIFARE Ultralight EV1 PICCs.
+ * --------------------------------------------------------------------------------------------------------------------
+ * This is a MFRC522 library example; for further details and other examples see: https://github.com/miguelbalboa/rfid
+ *
+ * The user memory size is taken from the Capability Container (page 3). The whole user memory is read
+ * twice: once with the 4-page MIFARE_Read() loop and once with MIFARE_Ultralight_FastRead(), which needs
+ * only a handful of frames. Both timings are printed and the contents are compared.
+ * An NTAG216 has 888 bytes of user memory: 56 frames with MIFARE_Read(), 4 frames with FAST_READ.
+ *
+ * Typical pin layout used:
+ * -----------------------------------------------------------------------------------------
+ *             MFRC522      Arduino       Arduino   Arduino    Arduino          Arduino
+ *             Reader/PCD   Uno/101       Mega      Nano v3    Leonardo/Micro   Pro Micro
+ * Signal      Pin          Pin           Pin       Pin        Pin              Pin
+ * -----------------------------------------------------------------------------------------
+ * RST/Reset   RST          9             5         D9         RESET/ICSP-5     RST
+ * SPI SS      SDA(SS)      10            53        D10        10               10
+ * SPI MOSI    MOSI         11 / ICSP-4   51        D11        ICSP-4           16
+ * SPI MISO    MISO         12 / ICSP-1   50        D12        ICSP-1           14
+ * SPI SCK     SCK          13 / ICSP-3   52        D13        ICSP-3           15
+ */
+
+#include <SPI.h>
+#include <MFRC522.h>
+
+#define RST_PIN         9           // Configurable, see typical pin layout above
+#define SS_PIN          10          // Configurable, see typical pin layout above
+
+#define MAX_USER_BYTES  888         // NTAG216 user memory
+
+MFRC522 mfrc522(SS_PIN, RST_PIN);   // Create MFRC522 instance
+
+byte loopData[MAX_USER_BYTES + 2];  // MIFARE_Read() always returns 16 data bytes and the CRC_A
+byte fastData[MAX_USER_BYTES];
+
+void setup() {
+  Serial.begin(9600);        // Initialize serial communications with the PC
+  while (!Serial);           // Do nothing if no serial port is opened (added for Arduinos based on ATMEGA32U4)
+  SPI.begin();               // Init SPI bus
+  mfrc522.PCD_Init();        // Init MFRC522 card
+  Serial.println(F("Scan an NTAG21x or Ultralight EV1 tag."));
+}
+
+void loop() {
+  // Reset the loop if no new card present on the sensor/reader. This saves the entire process when idle.
+  if ( ! mfrc522.PICC_IsNewCardPresent()) {
+    return;
+  }
+
+  // Select one of the cards
+  if ( ! mfrc522.PICC_ReadCardSerial()) {
+    return;
+  }
+
+  // The Capability Container in page 3 holds the data area size divided by 8
+  byte buffer[18];
+  byte size = sizeof(buffer);
+  MFRC522::StatusCode status = mfrc522.MIFARE_Read(3, buffer, &size);
+  if (status != MFRC522::STATUS_OK) {
+    Serial.print(F("MIFARE_Read() failed: "));
+    Serial.println(mfrc522.GetStatusCodeName(status));
+    mfrc522.PICC_HaltA();
+    return;
+  }
+  uint16_t userBytes = buffer[2] * 8;
+  if (userBytes == 0 || userBytes > MAX_USER_BYTES) {
+    userBytes = MAX_USER_BYTES;
+  }
+  byte lastPage = 4 + userBytes / 4 - 1;
+  Serial.print(F("User memory: "));
+  Serial.print(userBytes);
+  Serial.println(F(" bytes"));
+
+  // 4 pages per frame
+  unsigned long start = millis();
+  for (uint16_t offset = 0; offset < userBytes && status == MFRC522::STATUS_OK; offset += 16) {
+    size = 18;
+    status = mfrc522.MIFARE_Read(4 + offset / 4, &loopData[offset], &size);
+  }
+  unsigned long loopTime = millis() - start;
+  if (status != MFRC522::STATUS_OK) {
+    Serial.print(F("MIFARE_Read() failed: "));
+    Serial.println(mfrc522.GetStatusCodeName(status));
+  } else {
+    Serial.print(F("MIFARE_Read() loop: "));
+    Serial.print(loopTime);
+    Serial.println(F(" ms"));
+  }
+
+  // Whole range with FAST_READ
+  uint16_t fastSize = sizeof(fastData);
+  start = millis();
+  status = mfrc522.MIFARE_Ultralight_FastRead(4, lastPage, fastData, &fastSize);
+  unsigned long fastTime = millis() - start;
+  if (status != MFRC522::STATUS_OK) {
+    Serial.print(F("MIFARE_Ultralight_FastRead() failed: "));
+    Serial.println(mfrc522.GetStatusCodeName(status));
+  } else {
+    Serial.print(F("FAST_READ: "));
+    Serial.print(fastTime);
+    Serial.print(F(" ms, contents "));
+    Serial.println(memcmp(loopData, fastData, userBytes) == 0 ? F("match") : F("DIFFER"));
+  }
+
+  // Halt PICC
+  mfrc522.PICC_HaltA();
+}
@@ -0,0 +1,106 @@
+/*
+ * --------------------------------------------------------------------------------------------------------------------
+ * Example sketch/program reading and writing password protected NTAG213/215/216 PICCs with one PWD_AUTH per swipe.
+ * --------------------------------------------------------------------------------------------------------------------
+ * This is a MFRC522 library example; for further details and other examples see: https://github.com/miguelbalboa/rfid
+ *
+ * The tag is identified with MFRC522Ultralight to find its user pages. MFRC522NtagSession then sends
+ * PWD_AUTH once, checks the PACK the tag answers with, and runs a FAST_READ of the whole user memory and
+ * a write of one page inside the authenticated session. Wrong passwords are counted per tag and the
+ * session stops trying after ATTEMPT_LIMIT of them, so the AUTHLIM counter of the tag is never exhausted.
+ * See the Ntag216_AUTH example for how to set the password, PACK and AUTH0 on a tag.
+ *
+ * WARNING: this overwrites the first user page of the tag.
+ *
+ * Typical pin layout used:
+ * -----------------------------------------------------------------------------------------
+ *             MFRC522      Arduino       Arduino   Arduino    Arduino          Arduino
+ *             Reader/PCD   Uno/101       Mega      Nano v3    Leonardo/Micro   Pro Micro
+ * Signal      Pin          Pin           Pin       Pin        Pin              Pin
+ * -----------------------------------------------------------------------------------------
+ * RST/Reset   RST          9             5         D9         RESET/ICSP-5     RST
+ * SPI SS      SDA(SS)      10            53        D10        10               10
+ * SPI MOSI    MOSI         11 / ICSP-4   51        D11        ICSP-4           16
+ * SPI MISO    MISO         12 / ICSP-1   50        D12        ICSP-1           14
+ * SPI SCK     SCK          13 / ICSP-3   52        D13        ICSP-3           15
+ */
+
+#include <SPI.h>
+#include <MFRC522.h>
+#include <MFRC522Ultralight.h>
+#include <MFRC522NtagSession.h>
+
+#define RST_PIN         9           // Configurable, see typical pin layout above
+#define SS_PIN          10          // Configurable, see typical pin layout above
+#define ATTEMPT_LIMIT   3           // Keep below the AUTHLIM configured on the tag
+
+MFRC522 mfrc522(SS_PIN, RST_PIN);   // Create MFRC522 instance
+MFRC522Ultralight ultralight(mfrc522);
+MFRC522NtagSession session(mfrc522, ATTEMPT_LIMIT);
+
+const byte password[] = { 0xFF, 0xFF, 0xFF, 0xFF };
+const byte pack[] = { 0x00, 0x00 };
+
+byte buffer[4 * 60];                // 60 pages per FAST_READ batch
+
+void setup() {
+  Serial.begin(9600);        // Initialize serial communications with the PC
+  while (!Serial);           // Do nothing if no serial port is opened (added for Arduinos based on ATMEGA32U4)
+  SPI.begin();               // Init SPI bus
+  mfrc522.PCD_Init();        // Init MFRC522 card
+  Serial.println(F("Scan a password protected NTAG213/215/216."));
+}
+
+void loop() {
+  // Reset the loop if no new card present on the sensor/reader. This saves the entire process when idle.
+  if ( ! mfrc522.PICC_IsNewCardPresent()) {
+    return;
+  }
+
+  // Select one of the cards
+  if ( ! mfrc522.PICC_ReadCardSerial()) {
+    return;
+  }
+
+  MFRC522Ultralight::Product product;
+  MFRC522::StatusCode status = ultralight.Identify(&(mfrc522.uid), &product);
+  if (status != MFRC522::STATUS_OK || !MFRC522Ultralight::GetGeometry(product).paginaPwd) {
+    Serial.println(F("Not a tag with PWD_AUTH."));
+    mfrc522.PICC_HaltA();
+    return;
+  }
+  MFRC522Ultralight::Geometria geometry = MFRC522Ultralight::GetGeometry(product);
+  Serial.println(MFRC522Ultralight::GetProductName(product));
+
+  session.Begin(&(mfrc522.uid));  // New selection: the previous authentication no longer holds
+  status = session.Authenticate(&(mfrc522.uid), password, pack);
+  if (status != MFRC522::STATUS_OK) {
+    Serial.print(F("Authentication failed: "));
+    Serial.print(mfrc522.GetStatusCodeName(status));
+    Serial.print(F(", wrong passwords so far: "));
+    Serial.println(session.GetFailedAttempts());
+    session.End();
+    return;
+  }
+
+  // Read the user memory in batches, all inside the authenticated session
+  uint32_t checksum = 0;
+  for (uint16_t page = geometry.primeiraPaginaUsuario; page <= geometry.ultimaPaginaUsuario && status == MFRC522::STATUS_OK; page += 60) {
+    uint16_t last = min(page + 59, (uint16_t)geometry.ultimaPaginaUsuario);
+    uint16_t size = sizeof(buffer);
+    status = session.Read(page, last, buffer, &size);
+    for (uint16_t i = 0; status == MFRC522::STATUS_OK && i < size; i++) {
+      checksum += buffer[i];
+    }
+  }
+  if (status == MFRC522::STATUS_OK) {
+    Serial.print(F("User memory checksum: "));
+    Serial.println(checksum);
+    byte page[] = { 'M', 'F', 'R', 'C' };
+    status = session.Write(geometry.primeiraPaginaUsuario, page, sizeof(page));
+  }
+  Serial.println(mfrc522.GetStatusCodeName(status));
+
+  // Halt PICC and close the session
+  session.End();
+}
@@ -0,0 +1,104 @@
+/*
+ * --------------------------------------------------------------------------------------------------------------------
+ * Example sketch/program timing page writes on NTAG21x / MIFARE Ultralight PICCs.
+ * --------------------------------------------------------------------------------------------------------------------
+ * This is a MFRC522 library example; for further details and other examples see: https://github.com/miguelbalboa/rfid
+ *
+ * The tag is identified with MFRC522Ultralight to find its user pages. A test pattern is then written
+ * to the whole user memory twice: once with one MIFARE_Ultralight_Write() call per page and once with
+ * MIFARE_Ultralight_WritePages(). The pages/second rate of both is printed.
+ *
+ * WARNING: this overwrites the whole user memory of the tag (NDEF message included).
+ *
+ * Typical pin layout used:
+ * -----------------------------------------------------------------------------------------
+ *             MFRC522      Arduino       Arduino   Arduino    Arduino          Arduino
+ *             Reader/PCD   Uno/101       Mega      Nano v3    Leonardo/Micro   Pro Micro
+ * Signal      Pin          Pin           Pin       Pin        Pin              Pin
+ * -----------------------------------------------------------------------------------------
+ * RST/Reset   RST          9             5         D9         RESET/ICSP-5     RST
+ * SPI SS      SDA(SS)      10            53        D10        10               10
+ * SPI MOSI    MOSI         11 / ICSP-4   51        D11        ICSP-4           16
+ * SPI MISO    MISO         12 / ICSP-1   50        D12        ICSP-1           14
+ * SPI SCK     SCK          13 / ICSP-3   52        D13        ICSP-3           15
+ */
+
+#include <SPI.h>
+#include <MFRC522.h>
+#include <MFRC522Ultralight.h>
+
+#define RST_PIN         9           // Configurable, see typical pin layout above
+#define SS_PIN          10          // Configurable, see typical pin layout above
+
+MFRC522 mfrc522(SS_PIN, RST_PIN);   // Create MFRC522 instance
+MFRC522Ultralight ultralight(mfrc522);
+
+byte pattern[888];                  // Largest user memory (NTAG216)
+
+void setup() {
+  Serial.begin(9600);        // Initialize serial communications with the PC
+  while (!Serial);           // Do nothing if no serial port is opened (added for Arduinos based on ATMEGA32U4)
+  SPI.begin();               // Init SPI bus
+  mfrc522.PCD_Init();        // Init MFRC522 card
+  for (uint16_t i = 0; i < sizeof(pattern); i++) pattern[i] = i;
+  Serial.println(F("Scan an NTAG21x or Ultralight tag. Its user memory will be OVERWRITTEN."));
+}
+
+void printRate(const __FlashStringHelper *name, uint16_t pages, unsigned long elapsed) {
+  Serial.print(name);
+  Serial.print(pages);
+  Serial.print(F(" pages in "));
+  Serial.print(elapsed);
+  Serial.print(F(" ms = "));
+  Serial.print(elapsed ? pages * 1000UL / elapsed : 0);
+  Serial.println(F(" pages/s"));
+}
+
+void loop() {
+  // Reset the loop if no new card present on the sensor/reader. This saves the entire process when idle.
+  if ( ! mfrc522.PICC_IsNewCardPresent()) {
+    return;
+  }
+
+  // Select one of the cards
+  if ( ! mfrc522.PICC_ReadCardSerial()) {
+    return;
+  }
+
+  MFRC522Ultralight::Product product;
+  MFRC522::StatusCode status = ultralight.Identify(&(mfrc522.uid), &product);
+  if (status != MFRC522::STATUS_OK) {
+    Serial.print(F("Identify() failed: "));
+    Serial.println(mfrc522.GetStatusCodeName(status));
+    return;
+  }
+  MFRC522Ultralight::Geometria geometry = MFRC522Ultralight::GetGeometry(product);
+  byte firstPage = geometry.primeiraPaginaUsuario;
+  uint16_t pages = geometry.ultimaPaginaUsuario - firstPage + 1;
+  Serial.println(MFRC522Ultralight::GetProductName(product));
+
+  // One call per page
+  uint16_t written = 0;
+  unsigned long start = millis();
+  for (; written < pages; written++) {
+    status = mfrc522.MIFARE_Ultralight_Write(firstPage + written, &pattern[written * 4], 4);
+    if (status != MFRC522::STATUS_OK) {
+      break;
+    }
+  }
+  printRate(F("MIFARE_Ultralight_Write():     "), written, millis() - start);
+
+  // All pages in one call
+  if (status == MFRC522::STATUS_OK) {
+    start = millis();
+    status = mfrc522.MIFARE_Ultralight_WritePages(firstPage, pattern, pages * 4, &written);
+    printRate(F("MIFARE_Ultralight_WritePages(): "), written, millis() - start);
+  }
+  if (status != MFRC522::STATUS_OK) {
+    Serial.print(F("Write failed: "));
+    Serial.println(mfrc522.GetStatusCodeName(status));
+  }
+
+  // Halt PICC
+  mfrc522.PICC_HaltA();
+}
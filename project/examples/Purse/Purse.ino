@@ -0,0 +1,103 @@
+/*
+ * --------------------------------------------------------------------------------------------------------------------
+ * Example sketch/program showing a vending purse on MIFARE Classic Value Blocks.
+ * --------------------------------------------------------------------------------------------------------------------
+ * This is a MFRC522 library example; for further details and other examples see: https://github.com/miguelbalboa/rfid
+ *
+ * The balance is kept in Value Block 5 and a backup in Value Block 6 (sector 1 of a MIFARE 1K card).
+ * Every swipe debits one item price; the previous balance is copied to the backup first, so a card
+ * removed halfway through a debit is repaired by the next swipe. The balance is tracked locally,
+ * without reading the Value Block back, and the transaction time is printed.
+ *
+ * A card with empty blocks 5 and 6 is formatted and loaded with an initial balance.
+ *
+ * Typical pin layout used:
+ * -----------------------------------------------------------------------------------------
+ *             MFRC522      Arduino       Arduino   Arduino    Arduino          Arduino
+ *             Reader/PCD   Uno/101       Mega      Nano v3    Leonardo/Micro   Pro Micro
+ * Signal      Pin          Pin           Pin       Pin        Pin              Pin
+ * -----------------------------------------------------------------------------------------
+ * RST/Reset   RST          9             5         D9         RESET/ICSP-5     RST
+ * SPI SS      SDA(SS)      10            53        D10        10               10
+ * SPI MOSI    MOSI         11 / ICSP-4   51        D11        ICSP-4           16
+ * SPI MISO    MISO         12 / ICSP-1   50        D12        ICSP-1           14
+ * SPI SCK     SCK          13 / ICSP-3   52        D13        ICSP-3           15
+ */
+
+#include <SPI.h>
+#include <MFRC522.h>
+#include <MFRC522Purse.h>
+
+#define RST_PIN         9           // Configurable, see typical pin layout above
+#define SS_PIN          10          // Configurable, see typical pin layout above
+
+#define ITEM_PRICE      150         // Price of one item, in cents
+#define INITIAL_BALANCE 1000        // Balance loaded on a new card, in cents
+
+MFRC522 mfrc522(SS_PIN, RST_PIN);   // Create MFRC522 instance
+MFRC522Purse purse(mfrc522, 5, 6);  // Balance in block 5, backup in block 6
+
+MFRC522::MIFARE_Key key;
+
+void setup() {
+  Serial.begin(9600);        // Initialize serial communications with the PC
+  while (!Serial);           // Do nothing if no serial port is opened (added for Arduinos based on ATMEGA32U4)
+  SPI.begin();               // Init SPI bus
+  mfrc522.PCD_Init();        // Init MFRC522 card
+
+  // Prepare key - all keys are set to FFFFFFFFFFFFh at chip delivery from the factory.
+  for (byte i = 0; i < 6; i++) key.keyByte[i] = 0xFF;
+
+  Serial.println(F("Scan a MIFARE 1K card to buy an item."));
+}
+
+void loop() {
+  // Reset the loop if no new card present on the sensor/reader. This saves the entire process when idle.
+  if ( ! mfrc522.PICC_IsNewCardPresent()) {
+    return;
+  }
+
+  // Select one of the cards
+  if ( ! mfrc522.PICC_ReadCardSerial()) {
+    return;
+  }
+
+  unsigned long start = millis();
+  MFRC522::StatusCode status = purse.Begin(&(mfrc522.uid), MFRC522::PICC_CMD_MF_AUTH_KEY_A, &key);
+  if (status == MFRC522::STATUS_CRC_WRONG) {
+    // Neither block is a Value Block yet: format both (the sector is still authenticated)
+    Serial.println(F("New card, loading initial balance."));
+    status = mfrc522.MIFARE_SetValue(5, INITIAL_BALANCE);
+    if (status == MFRC522::STATUS_OK) {
+      status = mfrc522.MIFARE_SetValue(6, INITIAL_BALANCE);
+    }
+    if (status == MFRC522::STATUS_OK) {
+      status = purse.Begin(&(mfrc522.uid), MFRC522::PICC_CMD_MF_AUTH_KEY_A, &key);
+    }
+  }
+
+  if (status == MFRC522::STATUS_OK) {
+    status = purse.Debit(ITEM_PRICE);
+    unsigned long elapsed = millis() - start;
+    if (status == MFRC522::STATUS_OK) {
+      Serial.print(F("Item sold, balance left: "));
+    } else if (status == MFRC522::STATUS_INVALID) {
+      Serial.print(F("Insufficient balance: "));
+    }
+    if (status == MFRC522::STATUS_OK || status == MFRC522::STATUS_INVALID) {
+      Serial.print(purse.GetBalance());
+      Serial.print(F(" ("));
+      Serial.print(elapsed);
+      Serial.println(F(" ms)"));
+    }
+  }
+  if (status != MFRC522::STATUS_OK && status != MFRC522::STATUS_INVALID) {
+    Serial.print(F("Transaction failed, swipe again: "));
+    Serial.println(mfrc522.GetStatusCodeName(status));
+  }
+
+  // Halt PICC
+  mfrc522.PICC_HaltA();
+  // Stop encryption on PCD
+  mfrc522.PCD_StopCrypto1();
+}
@@ -31,6 +31,7 @@
 
 #include <SPI.h>
 #include <MFRC522.h>
+#include <MFRC522ReaderGroup.h>
 
 #define RST_PIN         9          // Configurable, see typical pin layout above
 #define SS_1_PIN        10         // Configurable, take a unused pin, only HIGH/LOW required, must be different to SS 2
@@ -41,6 +42,7 @@
 byte ssPins[] = {SS_1_PIN, SS_2_PIN};
 
 MFRC522 mfrc522[NR_OF_READERS];   // Create MFRC522 instance.
+MFRC522ReaderGroup readers(mfrc522, NR_OF_READERS); // Looks for cards on all readers at once
 
 /**
  * Initialize.
@@ -66,10 +68,12 @@ void setup() {
  */
 void loop() {
 
-  for (uint8_t reader = 0; reader < NR_OF_READERS; reader++) {
-    // Look for new cards
+  // Look for new cards on every reader at once: the scan takes as long as the slowest reader,
+  // not the sum of all of them (an empty reader waits for the whole timeout).
+  byte present = readers.Scan();
 
-    if (mfrc522[reader].PICC_IsNewCardPresent() && mfrc522[reader].PICC_ReadCardSerial()) {
+  for (uint8_t reader = 0; reader < NR_OF_READERS; reader++) {
+    if ((present & (1 << reader)) && mfrc522[reader].PICC_ReadCardSerial()) {
       Serial.print(F("Reader "));
       Serial.print(reader);
       // Show some details of the PICC (that is: the tag/card)
@@ -84,7 +88,7 @@ void loop() {
       mfrc522[reader].PICC_HaltA();
       // Stop encryption on PCD
       mfrc522[reader].PCD_StopCrypto1();
-    } //if (mfrc522[reader].PICC_IsNewC
+    } //if ((present & (1 << reader))
   } //for(uint8_t reader
 }
 
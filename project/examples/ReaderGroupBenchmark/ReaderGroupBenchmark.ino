@@ -0,0 +1,92 @@
+/**
+ * --------------------------------------------------------------------------------------------------------------------
+ * Example sketch/program comparing a sequential scan of several readers with MFRC522ReaderGroup.
+ * --------------------------------------------------------------------------------------------------------------------
+ * This is a MFRC522 library example; for further details and other examples see: https://github.com/miguelbalboa/rfid
+ *
+ * Calling PICC_IsNewCardPresent() on each reader in turn leaves the Arduino idle during the RF exchange of every
+ * chip, and an empty reader waits for the whole timeout (25 ms by default): the scan takes the sum of all readers.
+ * MFRC522ReaderGroup starts the REQA on every reader and then harvests the answers, so the scan takes as long as the
+ * slowest reader. Set NR_OF_READERS (2 to 8) and ssPins[] to your setup and keep the readers empty: every
+ * reader then waits for the full timeout, which is the case the group is meant for.
+ *
+ * Expected with empty readers: sequential ~ NR_OF_READERS * 25 ms, grouped ~ 25 ms.
+ *
+ * Optionally wire the IRQ pin of each reader and list it in irqPins[]: the group then only reads a reader over
+ * SPI once its IRQ line is asserted.
+ *
+ * @license Released into the public domain.
+ *
+ * Typical pin layout used:
+ * -----------------------------------------------------------------------------------------
+ *             MFRC522      Arduino       Arduino   Arduino    Arduino          Arduino
+ *             Reader/PCD   Uno/101       Mega      Nano v3    Leonardo/Micro   Pro Micro
+ * Signal      Pin          Pin           Pin       Pin        Pin              Pin
+ * -----------------------------------------------------------------------------------------
+ * RST/Reset   RST          9             5         D9         RESET/ICSP-5     RST
+ * SPI SS 1    SDA(SS)      ** custom, take a unused pin, only HIGH/LOW required **
+ * SPI SS 2    SDA(SS)      ** custom, take a unused pin, only HIGH/LOW required **
+ * SPI MOSI    MOSI         11 / ICSP-4   51        D11        ICSP-4           16
+ * SPI MISO    MISO         12 / ICSP-1   50        D12        ICSP-1           14
+ * SPI SCK     SCK          13 / ICSP-3   52        D13        ICSP-3           15
+ *
+ * More pin layouts for other boards can be found here: https://github.com/miguelbalboa/rfid#pin-layout
+ *
+ */
+
+#include <SPI.h>
+#include <MFRC522.h>
+#include <MFRC522ReaderGroup.h>
+
+#define RST_PIN         9          // Configurable, see typical pin layout above
+#define NR_OF_READERS   2          // 2 to 8 (MFRC522ReaderGroup::MAX_READERS)
+#define NR_OF_ROUNDS    20         // Scans measured per method
+
+byte ssPins[NR_OF_READERS] = {10, 8};  // Configurable, one unused pin per reader
+byte irqPins[NR_OF_READERS] = {MFRC522ReaderGroup::NO_IRQ_PIN, MFRC522ReaderGroup::NO_IRQ_PIN};  // Optional IRQ pins
+
+MFRC522 mfrc522[NR_OF_READERS];   // Create MFRC522 instances.
+MFRC522ReaderGroup readers(mfrc522, NR_OF_READERS);
+
+/**
+ * Initialize.
+ */
+void setup() {
+  Serial.begin(9600); // Initialize serial communications with the PC
+  while (!Serial);    // Do nothing if no serial port is opened (added for Arduinos based on ATMEGA32U4)
+
+  SPI.begin();        // Init SPI bus
+
+  for (uint8_t reader = 0; reader < NR_OF_READERS; reader++) {
+    mfrc522[reader].PCD_Init(ssPins[reader], RST_PIN); // Init each MFRC522 card
+    readers.SetIrqPin(reader, irqPins[reader]);         // After PCD_Init(), which resets the IRQ setup
+  }
+  Serial.print(NR_OF_READERS);
+  Serial.println(F(" readers, remove all cards for the worst case."));
+}
+
+/**
+ * Main loop.
+ */
+void loop() {
+  unsigned long start = millis();
+  for (uint8_t round = 0; round < NR_OF_ROUNDS; round++) {
+    for (uint8_t reader = 0; reader < NR_OF_READERS; reader++) {
+      mfrc522[reader].PICC_IsNewCardPresent();
+    }
+  }
+  unsigned long sequential = millis() - start;
+
+  start = millis();
+  for (uint8_t round = 0; round < NR_OF_ROUNDS; round++) {
+    readers.Scan();
+  }
+  unsigned long grouped = millis() - start;
+
+  Serial.print(F("Scan of all readers: sequential "));
+  Serial.print(sequential / NR_OF_ROUNDS);
+  Serial.print(F(" ms, grouped "));
+  Serial.print(grouped / NR_OF_ROUNDS);
+  Serial.println(F(" ms"));
+  delay(1000);
+}
@@ -0,0 +1,96 @@
+/*
+ * --------------------------------------------------------------------------------------------------------------------
+ * Example sketch/program showing how to keep a tear-safe record on a MIFARE Classic PICC.
+ * --------------------------------------------------------------------------------------------------------------------
+ * This is a MFRC522 library example; for further details and other examples see: https://github.com/miguelbalboa/rfid
+ *
+ * The record is kept in two copies plus a directory block in sector 1 of a MIFARE 1K card:
+ * block 4 holds the directory, blocks 5 and 6 hold copies A and B. Every write goes to the
+ * inactive copy and is committed by one final write of the directory block, so removing the
+ * card halfway through a write never leaves a torn record behind.
+ *
+ * Typical pin layout used:
+ * -----------------------------------------------------------------------------------------
+ *             MFRC522      Arduino       Arduino   Arduino    Arduino          Arduino
+ *             Reader/PCD   Uno/101       Mega      Nano v3    Leonardo/Micro   Pro Micro
+ * Signal      Pin          Pin           Pin       Pin        Pin              Pin
+ * -----------------------------------------------------------------------------------------
+ * RST/Reset   RST          9             5         D9         RESET/ICSP-5     RST
+ * SPI SS      SDA(SS)      10            53        D10        10               10
+ * SPI MOSI    MOSI         11 / ICSP-4   51        D11        ICSP-4           16
+ * SPI MISO    MISO         12 / ICSP-1   50        D12        ICSP-1           14
+ * SPI SCK     SCK          13 / ICSP-3   52        D13        ICSP-3           15
+ */
+
+#include <SPI.h>
+#include <MFRC522.h>
+#include <MFRC522RecordStore.h>
+
+#define RST_PIN         9           // Configurable, see typical pin layout above
+#define SS_PIN          10          // Configurable, see typical pin layout above
+
+MFRC522 mfrc522(SS_PIN, RST_PIN);   // Create MFRC522 instance
+MFRC522RecordStore store(mfrc522, 4, 5, 6, 1); // Directory in block 4, copies in blocks 5 and 6
+
+MFRC522::MIFARE_Key key;
+
+void setup() {
+  Serial.begin(9600);        // Initialize serial communications with the PC
+  while (!Serial);           // Do nothing if no serial port is opened (added for Arduinos based on ATMEGA32U4)
+  SPI.begin();               // Init SPI bus
+  mfrc522.PCD_Init();        // Init MFRC522 card
+
+  // Prepare key - all keys are set to FFFFFFFFFFFFh at chip delivery from the factory.
+  for (byte i = 0; i < 6; i++) key.keyByte[i] = 0xFF;
+
+  Serial.println(F("Scan a MIFARE 1K card to read and update its swipe counter record."));
+}
+
+void loop() {
+  // Reset the loop if no new card present on the sensor/reader. This saves the entire process when idle.
+  if ( ! mfrc522.PICC_IsNewCardPresent()) {
+    return;
+  }
+
+  // Select one of the cards
+  if ( ! mfrc522.PICC_ReadCardSerial()) {
+    return;
+  }
+
+  byte record[16];
+  byte length = 0;
+  uint16_t version = 0;
+  MFRC522::StatusCode status = store.Read(&(mfrc522.uid), MFRC522::PICC_CMD_MF_AUTH_KEY_A, &key, record, &length, &version);
+  if (status == MFRC522::STATUS_CRC_WRONG) {
+    // Damaged directory: rebuild it from a consistent copy, or start over if there is none
+    if (store.Recover(&(mfrc522.uid), MFRC522::PICC_CMD_MF_AUTH_KEY_A, &key) == MFRC522::STATUS_OK) {
+      status = store.Read(&(mfrc522.uid), MFRC522::PICC_CMD_MF_AUTH_KEY_A, &key, record, &length, &version);
+    } else {
+      store.Format(&(mfrc522.uid), MFRC522::PICC_CMD_MF_AUTH_KEY_A, &key);
+    }
+  }
+  if (status == MFRC522::STATUS_OK && length == 4) {
+    Serial.print(F("Record version "));
+    Serial.print(version);
+    Serial.print(F(", swipes so far: "));
+    Serial.println(*(uint32_t *)record);
+  } else {
+    Serial.print(F("No valid record yet ("));
+    Serial.print(mfrc522.GetStatusCodeName(status));
+    Serial.println(F("), starting a new one."));
+    memset(record, 0, sizeof(record));
+  }
+
+  // Increment the counter and commit it
+  (*(uint32_t *)record)++;
+  status = store.Write(&(mfrc522.uid), MFRC522::PICC_CMD_MF_AUTH_KEY_A, &key, record, 4);
+  if (status != MFRC522::STATUS_OK) {
+    Serial.print(F("Write failed, previous record kept: "));
+    Serial.println(mfrc522.GetStatusCodeName(status));
+  }
+
+  // Halt PICC
+  mfrc522.PICC_HaltA();
+  // Stop encryption on PCD
+  mfrc522.PCD_StopCrypto1();
+}
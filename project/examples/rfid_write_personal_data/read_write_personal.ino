@@ -68,7 +68,7 @@ void loop()
     Serial.println(mfrc522.PICC_GetTypeName(tipoPICC));
 
     byte buffer[34];
-    byte bloco;
+    byte escritos;
     MFRC522::StatusCode status;
     byte len;
 
@@ -76,100 +76,37 @@ void loop()
     // Solicita dados pessoais: Sobrenome
     Serial.println(F("Digite o sobrenome, terminando com #"));
     len = Serial.readBytesUntil('#', (char *)buffer, 30); // Lê o sobrenome da porta serial
-    for (byte i = len; i < 30; i++)
+    for (byte i = len; i < 32; i++)
         buffer[i] = ' '; // Preenche com espaços
 
-    bloco = 1;
-    // Serial.println(F("Autenticando usando chave A..."));
-    status = mfrc522.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, bloco, &chave, &(mfrc522.uid));
+    // Escreve nos blocos 1 e 2. Apenas os blocos que diferem do cartão são escritos,
+    // com uma única autenticação para o setor.
+    status = mfrc522.MIFARE_WriteDiff(&(mfrc522.uid), MFRC522::PICC_CMD_MF_AUTH_KEY_A, &chave, 1, 2, buffer, nullptr, &escritos);
     if (status != MFRC522::STATUS_OK)
     {
-        Serial.print(F("PCD_Authenticate() falhou: "));
+        Serial.print(F("MIFARE_WriteDiff() falhou: "));
         Serial.println(mfrc522.GetStatusCodeName(status));
         return;
     }
-    else
-        Serial.println(F("PCD_Authenticate() com sucesso: "));
-
-    // Escreve no bloco
-    status = mfrc522.MIFARE_Write(bloco, buffer, 16);
-    if (status != MFRC522::STATUS_OK)
-    {
-        Serial.print(F("MIFARE_Write() falhou: "));
-        Serial.println(mfrc522.GetStatusCodeName(status));
-        return;
-    }
-    else
-        Serial.println(F("MIFARE_Write() com sucesso: "));
-
-    bloco = 2;
-    // Serial.println(F("Autenticando usando chave A..."));
-    status = mfrc522.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, bloco, &chave, &(mfrc522.uid));
-    if (status != MFRC522::STATUS_OK)
-    {
-        Serial.print(F("PCD_Authenticate() falhou: "));
-        Serial.println(mfrc522.GetStatusCodeName(status));
-        return;
-    }
-
-    // Escreve no bloco
-    status = mfrc522.MIFARE_Write(bloco, &buffer[16], 16);
-    if (status != MFRC522::STATUS_OK)
-    {
-        Serial.print(F("MIFARE_Write() falhou: "));
-        Serial.println(mfrc522.GetStatusCodeName(status));
-        return;
-    }
-    else
-        Serial.println(F("MIFARE_Write() com sucesso: "));
+    Serial.print(F("MIFARE_WriteDiff() com sucesso, blocos escritos: "));
+    Serial.println(escritos);
 
     // Solicita dados pessoais: Nome
     Serial.println(F("Digite o nome, terminando com #"));
     len = Serial.readBytesUntil('#', (char *)buffer, 20); // Lê o nome da porta serial
-    for (byte i = len; i < 20; i++)
+    for (byte i = len; i < 32; i++)
         buffer[i] = ' '; // Preenche com espaços
 
-    bloco = 4;
-    // Serial.println(F("Autenticando usando chave A..."));
-    status = mfrc522.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, bloco, &chave, &(mfrc522.uid));
-    if (status != MFRC522::STATUS_OK)
-    {
-        Serial.print(F("PCD_Authenticate() falhou: "));
-        Serial.println(mfrc522.GetStatusCodeName(status));
-        return;
-    }
-
-    // Escreve no bloco
-    status = mfrc522.MIFARE_Write(bloco, buffer, 16);
-    if (status != MFRC522::STATUS_OK)
-    {
-        Serial.print(F("MIFARE_Write() falhou: "));
-        Serial.println(mfrc522.GetStatusCodeName(status));
-        return;
-    }
-    else
-        Serial.println(F("MIFARE_Write() com sucesso: "));
-
-    bloco = 5;
-    // Serial.println(F("Autenticando usando chave A..."));
-    status = mfrc522.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, bloco, &chave, &(mfrc522.uid));
-    if (status != MFRC522::STATUS_OK)
-    {
-        Serial.print(F("PCD_Authenticate() falhou: "));
-        Serial.println(mfrc522.GetStatusCodeName(status));
-        return;
-    }
-
-    // Escreve no bloco
-    status = mfrc522.MIFARE_Write(bloco, &buffer[16], 16);
+    // Escreve nos blocos 4 e 5
+    status = mfrc522.MIFARE_WriteDiff(&(mfrc522.uid), MFRC522::PICC_CMD_MF_AUTH_KEY_A, &chave, 4, 2, buffer, nullptr, &escritos);
     if (status != MFRC522::STATUS_OK)
     {
-        Serial.print(F("MIFARE_Write() falhou: "));
+        Serial.print(F("MIFARE_WriteDiff() falhou: "));
         Serial.println(mfrc522.GetStatusCodeName(status));
         return;
     }
-    else
-        Serial.println(F("MIFARE_Write() com sucesso: "));
+    Serial.print(F("MIFARE_WriteDiff() com sucesso, blocos escritos: "));
+    Serial.println(escritos);
 
     Serial.println(" ");
     mfrc522.PICC_HaltA();      // Finaliza o PICC
@@ -62,7 +62,7 @@ void loop() {
   Serial.println(mfrc522.PICC_GetTypeName(piccType));
 
   byte buffer[34];
-  byte block;
+  byte written;
   MFRC522::StatusCode status;
   byte len;
 
@@ -70,85 +70,33 @@ void loop() {
   // Ask personal data: Family name
   Serial.println(F("Type Family name, ending with #"));
   len = Serial.readBytesUntil('#', (char *) buffer, 30) ; // read family name from serial
-  for (byte i = len; i < 30; i++) buffer[i] = ' ';     // pad with spaces
+  for (byte i = len; i < 32; i++) buffer[i] = ' ';     // pad with spaces
 
-  block = 1;
-  //Serial.println(F("Authenticating using key A..."));
-  status = mfrc522.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, block, &key, &(mfrc522.uid));
+  // Write blocks 1 and 2. Only blocks that differ from the card are written,
+  // using a single authentication for the sector.
+  status = mfrc522.MIFARE_WriteDiff(&(mfrc522.uid), MFRC522::PICC_CMD_MF_AUTH_KEY_A, &key, 1, 2, buffer, nullptr, &written);
   if (status != MFRC522::STATUS_OK) {
-    Serial.print(F("PCD_Authenticate() failed: "));
+    Serial.print(F("MIFARE_WriteDiff() failed: "));
     Serial.println(mfrc522.GetStatusCodeName(status));
     return;
   }
-  else Serial.println(F("PCD_Authenticate() success: "));
-
-  // Write block
-  status = mfrc522.MIFARE_Write(block, buffer, 16);
-  if (status != MFRC522::STATUS_OK) {
-    Serial.print(F("MIFARE_Write() failed: "));
-    Serial.println(mfrc522.GetStatusCodeName(status));
-    return;
-  }
-  else Serial.println(F("MIFARE_Write() success: "));
-
-  block = 2;
-  //Serial.println(F("Authenticating using key A..."));
-  status = mfrc522.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, block, &key, &(mfrc522.uid));
-  if (status != MFRC522::STATUS_OK) {
-    Serial.print(F("PCD_Authenticate() failed: "));
-    Serial.println(mfrc522.GetStatusCodeName(status));
-    return;
-  }
-
-  // Write block
-  status = mfrc522.MIFARE_Write(block, &buffer[16], 16);
-  if (status != MFRC522::STATUS_OK) {
-    Serial.print(F("MIFARE_Write() failed: "));
-    Serial.println(mfrc522.GetStatusCodeName(status));
-    return;
-  }
-  else Serial.println(F("MIFARE_Write() success: "));
+  Serial.print(F("MIFARE_WriteDiff() success, blocks written: "));
+  Serial.println(written);
 
   // Ask personal data: First name
   Serial.println(F("Type First name, ending with #"));
   len = Serial.readBytesUntil('#', (char *) buffer, 20) ; // read first name from serial
-  for (byte i = len; i < 20; i++) buffer[i] = ' ';     // pad with spaces
-
-  block = 4;
-  //Serial.println(F("Authenticating using key A..."));
-  status = mfrc522.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, block, &key, &(mfrc522.uid));
-  if (status != MFRC522::STATUS_OK) {
-    Serial.print(F("PCD_Authenticate() failed: "));
-    Serial.println(mfrc522.GetStatusCodeName(status));
-    return;
-  }
-
-  // Write block
-  status = mfrc522.MIFARE_Write(block, buffer, 16);
-  if (status != MFRC522::STATUS_OK) {
-    Serial.print(F("MIFARE_Write() failed: "));
-    Serial.println(mfrc522.GetStatusCodeName(status));
-    return;
-  }
-  else Serial.println(F("MIFARE_Write() success: "));
-
-  block = 5;
-  //Serial.println(F("Authenticating using key A..."));
-  status = mfrc522.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, block, &key, &(mfrc522.uid));
-  if (status != MFRC522::STATUS_OK) {
-    Serial.print(F("PCD_Authenticate() failed: "));
-    Serial.println(mfrc522.GetStatusCodeName(status));
-    return;
-  }
+  for (byte i = len; i < 32; i++) buffer[i] = ' ';     // pad with spaces
 
-  // Write block
-  status = mfrc522.MIFARE_Write(block, &buffer[16], 16);
+  // Write blocks 4 and 5
+  status = mfrc522.MIFARE_WriteDiff(&(mfrc522.uid), MFRC522::PICC_CMD_MF_AUTH_KEY_A, &key, 4, 2, buffer, nullptr, &written);
   if (status != MFRC522::STATUS_OK) {
-    Serial.print(F("MIFARE_Write() failed: "));
+    Serial.print(F("MIFARE_WriteDiff() failed: "));
     Serial.println(mfrc522.GetStatusCodeName(status));
     return;
   }
-  else Serial.println(F("MIFARE_Write() success: "));
+  Serial.print(F("MIFARE_WriteDiff() success, blocks written: "));
+  Serial.println(written);
 
 
   Serial.println(" ");
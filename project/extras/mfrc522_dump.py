@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""
+Decodificador dos despejos binários gerados por MFRC522DumpBinary (veja src/MFRC522Dump.h).
+
+Uso:
+  mfrc522_dump.py hex  CARTAO.mfd           Exibe os blocos em hexadecimal
+  mfrc522_dump.py json CARTAO.mfd           Converte o despejo para JSON
+  mfrc522_dump.py diff CARTAO1.mfd CARTAO2.mfd
+                                            Lista os blocos diferentes entre dois cartões
+
+O arquivo pode conter texto antes do despejo (por exemplo, a saída serial capturada): a leitura
+começa na primeira assinatura 'M' 'F' 'D'.
+"""
+
+import json
+import struct
+import sys
+import zlib
+
+VERSAO = 1
+
+TIPOS = {
+    0x00: "PICC_TYPE_UNKNOWN",
+    0x01: "PICC_TYPE_ISO_14443_4",
+    0x02: "PICC_TYPE_ISO_18092",
+    0x03: "PICC_TYPE_MIFARE_MINI",
+    0x04: "PICC_TYPE_MIFARE_1K",
+    0x05: "PICC_TYPE_MIFARE_4K",
+    0x06: "PICC_TYPE_MIFARE_UL",
+    0x07: "PICC_TYPE_MIFARE_PLUS",
+    0x08: "PICC_TYPE_MIFARE_DESFIRE",
+    0x09: "PICC_TYPE_TNP3XXX",
+    0x0A: "PICC_TYPE_MIFARE_2K",
+    0xFF: "PICC_TYPE_NOT_COMPLETE",
+}
+
+STATUS = {
+    0x00: "STATUS_OK",
+    0x01: "STATUS_ERROR",
+    0x02: "STATUS_COLLISION",
+    0x03: "STATUS_TIMEOUT",
+    0x04: "STATUS_NO_ROOM",
+    0x05: "STATUS_INTERNAL_ERROR",
+    0x06: "STATUS_INVALID",
+    0x07: "STATUS_CRC_WRONG",
+    0x08: "STATUS_PENDING",
+    0xFF: "STATUS_MIFARE_NACK",
+}
+
+
+class ErroDespejo(Exception):
+    pass
+
+
+def decodifica(dados):
+    """Decodifica um despejo e retorna um dicionário com o cabeçalho, os setores e os blocos."""
+    inicio = dados.find(b"MFD")
+    if inicio < 0:
+        raise ErroDespejo("assinatura 'MFD' não encontrada")
+    dados = dados[inicio:]
+    if len(dados) < 20:
+        raise ErroDespejo("cabeçalho incompleto")
+    versao, tipo, sak, atqa, tamanho_uid = struct.unpack_from("<BBBHB", dados, 3)
+    if versao != VERSAO:
+        raise ErroDespejo("versão %d não suportada" % versao)
+    uid = dados[9:9 + min(tamanho_uid, 10)]
+    tamanho_bloco = dados[19]
+
+    despejo = {
+        "tipo": TIPOS.get(tipo, "0x%02X" % tipo),
+        "sak": "%02X" % sak,
+        "atqa": "%04X" % atqa,
+        "uid": uid.hex().upper(),
+        "tamanho_bloco": tamanho_bloco,
+        "setores": [],
+        "blocos": {},
+    }
+
+    pos = 20
+    while True:
+        if pos >= len(dados):
+            raise ErroDespejo("registro final ausente")
+        marca = dados[pos:pos + 1]
+        if marca == b"S":
+            setor, primeiro, numero, status = struct.unpack_from("<BBBB", dados, pos + 1)
+            despejo["setores"].append({
+                "setor": setor,
+                "primeiro_bloco": primeiro,
+                "blocos": numero,
+                "status": STATUS.get(status, "0x%02X" % status),
+            })
+            pos += 5
+        elif marca == b"B":
+            endereco, status = struct.unpack_from("<BB", dados, pos + 1)
+            pos += 3
+            bloco = {"status": STATUS.get(status, "0x%02X" % status)}
+            if status == 0:
+                bloco["dados"] = dados[pos:pos + tamanho_bloco].hex().upper()
+                pos += tamanho_bloco
+            despejo["blocos"][endereco] = bloco
+        elif marca == b"E":
+            if pos + 5 > len(dados):
+                raise ErroDespejo("CRC32 incompleto")
+            (crc,) = struct.unpack_from("<I", dados, pos + 1)
+            calculado = zlib.crc32(dados[:pos + 1]) & 0xFFFFFFFF
+            if crc != calculado:
+                raise ErroDespejo("CRC32 inválido: %08X, esperado %08X" % (crc, calculado))
+            return despejo
+        else:
+            raise ErroDespejo("registro desconhecido 0x%02X na posição %d" % (dados[pos], inicio + pos))
+
+
+def le(caminho):
+    with open(caminho, "rb") as arquivo:
+        return decodifica(arquivo.read())
+
+
+def exibe_hex(despejo):
+    print("UID %s  SAK %s  ATQA %s  %s" % (despejo["uid"], despejo["sak"], despejo["atqa"], despejo["tipo"]))
+    for setor in despejo["setores"]:
+        if setor["status"] != "STATUS_OK":
+            print("setor %2d: %s" % (setor["setor"], setor["status"]))
+    for endereco in sorted(despejo["blocos"]):
+        bloco = despejo["blocos"][endereco]
+        conteudo = bloco.get("dados")
+        if conteudo is None:
+            print("%3d  %s" % (endereco, bloco["status"]))
+        else:
+            print("%3d  %s" % (endereco, " ".join(conteudo[i:i + 2] for i in range(0, len(conteudo), 2))))
+
+
+def compara(a, b):
+    """Exibe os blocos diferentes; retorna o número de diferenças."""
+    diferencas = 0
+    for campo in ("uid", "sak", "atqa", "tipo"):
+        if a[campo] != b[campo]:
+            print("%s: %s != %s" % (campo, a[campo], b[campo]))
+            diferencas += 1
+    for endereco in sorted(set(a["blocos"]) | set(b["blocos"])):
+        da = a["blocos"].get(endereco, {}).get("dados")
+        db = b["blocos"].get(endereco, {}).get("dados")
+        if da != db:
+            print("%3d  %s" % (endereco, da or "-"))
+            print("     %s" % (db or "-"))
+            diferencas += 1
+    return diferencas
+
+
+def main(argumentos):
+    if len(argumentos) == 2 and argumentos[0] == "hex":
+        exibe_hex(le(argumentos[1]))
+    elif len(argumentos) == 2 and argumentos[0] == "json":
+        print(json.dumps(le(argumentos[1]), indent=2))
+    elif len(argumentos) == 3 and argumentos[0] == "diff":
+        return 1 if compara(le(argumentos[1]), le(argumentos[2])) else 0
+    else:
+        print(__doc__.strip())
+        return 2
+    return 0
+
+
+if __name__ == "__main__":
+    try:
+        sys.exit(main(sys.argv[1:]))
+    except ErroDespejo as erro:
+        print("erro: %s" % erro, file=sys.stderr)
+        sys.exit(1)
@@ -1,5 +1,6 @@
 #include <SPI.h>
 #include <MFRC522.h>
+#include <MFRC522BusArbiter.h>
 #include <SD.h> // Inclui a biblioteca SD.h
 
 
@@ -10,6 +11,11 @@
 #define VERMELHO 7 // Pino do LED vermelho
 
 MFRC522 rfid(SS_PIN, RST_PIN);
+File arquivo; // Aberto uma vez em setup()
+
+// O leitor e o cartão SD dividem o barramento SPI: os IDs vão para uma fila na RAM e são gravados
+// no SD enquanto o leitor espera a resposta de RF, fora do caminho entre o cartão e os LEDs
+MFRC522BusArbiter barramento(rfid, arquivo);
 void setup()
 {
     // Inicializa a comunicação serial
@@ -33,12 +39,19 @@ void setup()
         Serial.println("Falha ao inicializar o cartão SD");
         return;
     }
+
+    // Abre o arquivo uma vez; os IDs são gravados nele pelo árbitro do barramento
+    arquivo = SD.open("alunos.txt", FILE_WRITE);
+    if (!arquivo)
+    {
+        Serial.println("Erro ao abrir o arquivo no cartão SD.");
+    }
 }
 
 void loop()
 {
     // Verifica se há um novo cartão
-    if (!rfid.PICC_IsNewCardPresent() || !rfid.PICC_ReadCardSerial())
+    if (!barramento.PICC_IsNewCardPresent() || !barramento.PICC_ReadCardSerial())
         return;
 
     // Obtém o tipo do cartão
@@ -67,19 +80,6 @@ void loop()
     Serial.print("Aproxime o cartão chave: ");
     Serial.println(strID);
 
-    // Grava o ID no cartão SD
-    File arquivo = SD.open("alunos.txt", FILE_WRITE);
-    if (arquivo)
-    {
-        arquivo.println(strID);
-        arquivo.close();
-        Serial.println("ID gravado no cartão SD.");
-    }
-    else
-    {
-        Serial.println("Erro ao abrir o arquivo no cartão SD.");
-    }
-
     // Verifica se o cartão é a chave correta
     if (strID.indexOf("20:6B:18:83") >= 0)
     {
@@ -93,13 +93,23 @@ void loop()
     }
 
     // Para a comunicação com o cartão
+    barramento.BeginRfid();
     rfid.PICC_HaltA();
     rfid.PCD_StopCrypto1();
+    barramento.EndRfid();
+
+    // Coloca o ID na fila; ele é gravado no cartão SD durante a próxima espera do leitor
+    if (arquivo)
+    {
+        barramento.println(strID);
+        Serial.println("ID enviado para o cartão SD.");
+    }
 }
 
 /*
 Este código abrirá um arquivo chamado "alunos.txt"
 no cartão SD e escreverá os IDs dos cartões RFID nele.
+Os LEDs respondem ao cartão antes da gravação, que acontece enquanto o leitor espera o próximo cartão.
 Certifique-se de que o cartão SD
 esteja formatado corretamente e inserido no leitor antes de executar o código.
 */
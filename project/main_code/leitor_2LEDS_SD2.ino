@@ -1,5 +1,6 @@
 #include <SPI.h>
 #include <MFRC522.h>
+#include <MFRC522BusArbiter.h>
 #include <SD.h> // Inclui a biblioteca SD.h
 
 #define chipSelect 4 // Define o pino CS do cartão SD
@@ -11,6 +12,10 @@
 MFRC522 rfid(SS_PIN, RST_PIN);
 File arquivo; // Declaração global do objeto de arquivo
 
+// O leitor e o cartão SD dividem o barramento SPI: os IDs vão para uma fila na RAM e são gravados
+// no SD enquanto o leitor espera a resposta de RF, fora do caminho entre o cartão e os LEDs
+MFRC522BusArbiter barramento(rfid, arquivo);
+
 // Defina as chaves permitidas como uma matriz de strings
 String chavesPermitidas[] = {
     "20:6B:18:83",
@@ -62,7 +67,7 @@ void setup()
 void loop()
 {
     // Verifica se há um novo cartão
-    if (!rfid.PICC_IsNewCardPresent() || !rfid.PICC_ReadCardSerial())
+    if (!barramento.PICC_IsNewCardPresent() || !barramento.PICC_ReadCardSerial())
         return;
 
     // Obtém o tipo do cartão
@@ -100,24 +105,6 @@ void loop()
         }
     }
 
-    // Grava o ID no cartão SD com tratamento de exceções
-    try
-    {
-        if (arquivo)
-        {
-            arquivo.println(strID);
-            Serial.println("ID gravado no cartão SD.");
-        }
-        else
-        {
-            throw "Erro ao escrever no arquivo no cartão SD.";
-        }
-    }
-    catch (const char *error)
-    {
-        Serial.println(error);
-    }
-
     // Verifica se a chave é autorizada e atua com base nisso
     if (chaveAutorizada)
     {
@@ -131,6 +118,26 @@ void loop()
     }
 
     // Para a comunicação com o cartão
+    barramento.BeginRfid();
     rfid.PICC_HaltA();
     rfid.PCD_StopCrypto1();
+    barramento.EndRfid();
+
+    // Coloca o ID na fila com tratamento de exceções; ele é gravado no cartão SD durante a próxima espera do leitor
+    try
+    {
+        if (arquivo)
+        {
+            barramento.println(strID);
+            Serial.println("ID enviado para o cartão SD.");
+        }
+        else
+        {
+            throw "Erro ao escrever no arquivo no cartão SD.";
+        }
+    }
+    catch (const char *error)
+    {
+        Serial.println(error);
+    }
 }
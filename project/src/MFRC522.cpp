@@ -6,6 +6,48 @@
 
 #include <Arduino.h>
 #include "MFRC522.h"
+#include "MFRC522Layout.h"
+#include "MFRC522Log.h"
+#include "MFRC522Dump.h"
+#include "MFRC522Identify.h"
+
+/**
+ * Acrescenta um byte a um CRC_A em cálculo.
+ */
+static inline uint16_t AtualizaCRC_A(uint16_t crc, byte dado)
+{
+	dado ^= crc & 0xFF;
+	dado ^= dado << 4;
+	return (crc >> 8) ^ ((uint16_t)dado << 8) ^ ((uint16_t)dado << 3) ^ (dado >> 4);
+} // Fim de AtualizaCRC_A()
+
+/**
+ * Número de bytes em uma lista de segmentos.
+ */
+static inline byte TamanhoSegmentos(const MFRC522::FifoSegment *segmentos, byte quantidade)
+{
+	byte total = 0;
+	for (byte i = 0; i < quantidade; i++)
+	{
+		total += segmentos[i].size;
+	}
+	return total;
+} // Fim de TamanhoSegmentos()
+
+/**
+ * Primeiro byte de uma lista de segmentos (o comando), ou 0 se estiver vazia.
+ */
+static inline byte PrimeiroByte(const MFRC522::FifoSegment *segmentos, byte quantidade)
+{
+	for (byte i = 0; i < quantidade; i++)
+	{
+		if (segmentos[i].size)
+		{
+			return segmentos[i].data[0];
+		}
+	}
+	return 0;
+} // Fim de PrimeiroByte()
 
 /////////////////////////////////////////////////////////////////////////////////////
 // Funções para configurar o Arduino
@@ -33,6 +75,8 @@ MFRC522::MFRC522(byte chipSelectPin, byte resetPowerDownPin)
 {
 	_chipSelectPin = chipSelectPin;
 	_resetPowerDownPin = resetPowerDownPin;
+	_timeoutUs = TIMEOUT_DEFAULT_US;
+	_burstDepth = 0;
 } // Fim do construtor
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -45,12 +89,18 @@ MFRC522::MFRC522(byte chipSelectPin, byte resetPowerDownPin)
  */
 void MFRC522::PCD_WriteRegister(PCD_Register reg, byte value)
 {
-	SPI.beginTransaction(SPISettings(MFRC522_SPICLOCK, MSBFIRST, SPI_MODE0)); // Configurações para trabalhar com o barramento SPI
+	if (!_burstDepth)
+	{
+		SPI.beginTransaction(SPISettings(MFRC522_SPICLOCK, MSBFIRST, SPI_MODE0)); // Configurações para trabalhar com o barramento SPI
+	}
 	digitalWrite(_chipSelectPin, LOW);										  // Seleciona o escravo
 	SPI.transfer(reg);														  // MSB == 0 é para escrita. LSB não é usado no endereço. Seção 8.1.2.3 do datasheet.
 	SPI.transfer(value);
 	digitalWrite(_chipSelectPin, HIGH); // Libera o escravo
-	SPI.endTransaction();				// Para de usar o barramento SPI
+	if (!_burstDepth)
+	{
+		SPI.endTransaction(); // Para de usar o barramento SPI
+	}
 } // Fim de PCD_WriteRegister()
 
 /**
@@ -59,7 +109,10 @@ void MFRC522::PCD_WriteRegister(PCD_Register reg, byte value)
  */
 void MFRC522::PCD_WriteRegister(PCD_Register reg, byte count, byte *values)
 {
-	SPI.beginTransaction(SPISettings(MFRC522_SPICLOCK, MSBFIRST, SPI_MODE0)); // Configurações para trabalhar com o barramento SPI
+	if (!_burstDepth)
+	{
+		SPI.beginTransaction(SPISettings(MFRC522_SPICLOCK, MSBFIRST, SPI_MODE0)); // Configurações para trabalhar com o barramento SPI
+	}
 	digitalWrite(_chipSelectPin, LOW);										  // Seleciona o escravo
 	SPI.transfer(reg);														  // MSB == 0 é para escrita. LSB não é usado no endereço. Seção 8.1.2.3 do datasheet.
 	for (byte index = 0; index < count; index++)
@@ -67,7 +120,10 @@ void MFRC522::PCD_WriteRegister(PCD_Register reg, byte count, byte *values)
 		SPI.transfer(values[index]);
 	}
 	digitalWrite(_chipSelectPin, HIGH); // Libera o escravo
-	SPI.endTransaction();				// Para de usar o barramento SPI
+	if (!_burstDepth)
+	{
+		SPI.endTransaction(); // Para de usar o barramento SPI
+	}
 } // Fim de PCD_WriteRegister()
 
 /**
@@ -77,12 +133,18 @@ void MFRC522::PCD_WriteRegister(PCD_Register reg, byte count, byte *values)
 byte MFRC522::PCD_ReadRegister(PCD_Register reg)
 {
 	byte value;
-	SPI.beginTransaction(SPISettings(MFRC522_SPICLOCK, MSBFIRST, SPI_MODE0)); // Configurações para trabalhar com o barramento SPI
+	if (!_burstDepth)
+	{
+		SPI.beginTransaction(SPISettings(MFRC522_SPICLOCK, MSBFIRST, SPI_MODE0)); // Configurações para trabalhar com o barramento SPI
+	}
 	digitalWrite(_chipSelectPin, LOW);										  // Seleciona o escravo
 	SPI.transfer(0x80 | reg);												  // MSB == 1 é para leitura. LSB não é usado no endereço. Seção 8.1.2.3 do datasheet.
 	value = SPI.transfer(0);												  // Lê o valor de volta. Envia 0 para parar a leitura.
 	digitalWrite(_chipSelectPin, HIGH);										  // Libera o escravo
-	SPI.endTransaction();													  // Para de usar o barramento SPI
+	if (!_burstDepth)
+	{
+		SPI.endTransaction(); // Para de usar o barramento SPI
+	}
 	return value;
 } // Fim de PCD_ReadRegister()
 
@@ -99,7 +161,10 @@ void MFRC522::PCD_ReadRegister(PCD_Register reg, byte count, byte *values, byte
 	// Serial.print(F("Lendo ")); 	Serial.print(count); Serial.println(F(" bytes do registro."));
 	byte address = 0x80 | reg;												  // MSB == 1 é para leitura. LSB não é usado no endereço. Seção 8.1.2.3 do datasheet.
 	byte index = 0;															  // Índice no array de valores.
-	SPI.beginTransaction(SPISettings(MFRC522_SPICLOCK, MSBFIRST, SPI_MODE0)); // Configurações para trabalhar com o barramento SPI
+	if (!_burstDepth)
+	{
+		SPI.beginTransaction(SPISettings(MFRC522_SPICLOCK, MSBFIRST, SPI_MODE0)); // Configurações para trabalhar com o barramento SPI
+	}
 	digitalWrite(_chipSelectPin, LOW);										  // Seleciona o escravo
 	count--;																  // Uma leitura é realizada fora do loop
 	SPI.transfer(address);													  // Diz ao MFRC522 qual endereço queremos ler
@@ -120,9 +185,36 @@ void MFRC522::PCD_ReadRegister(PCD_Register reg, byte count, byte *values, byte
 	}
 	values[index] = SPI.transfer(0);	// Leia o último byte. Envie 0 para parar a leitura.
 	digitalWrite(_chipSelectPin, HIGH); // Libera o escravo
-	SPI.endTransaction();				// Para de usar o barramento SPI
+	if (!_burstDepth)
+	{
+		SPI.endTransaction(); // Para de usar o barramento SPI
+	}
 } // Fim de PCD_ReadRegister()
 
+/**
+ * Inicia uma rajada de acessos: as configurações do barramento SPI são aplicadas uma vez aqui, e não a cada acesso
+ * a registro, até PCD_EndBurst(). As chamadas podem ser aninhadas.
+ * Nenhum outro dispositivo do barramento (ex.: cartão SD) pode ser usado durante a rajada.
+ */
+void MFRC522::PCD_BeginBurst()
+{
+	if (_burstDepth++ == 0)
+	{
+		SPI.beginTransaction(SPISettings(MFRC522_SPICLOCK, MSBFIRST, SPI_MODE0)); // Configurações para trabalhar com o barramento SPI
+	}
+} // Fim de PCD_BeginBurst()
+
+/**
+ * Encerra a rajada iniciada por PCD_BeginBurst() e libera o barramento SPI.
+ */
+void MFRC522::PCD_EndBurst()
+{
+	if (_burstDepth && --_burstDepth == 0)
+	{
+		SPI.endTransaction(); // Para de usar o barramento SPI
+	}
+} // Fim de PCD_EndBurst()
+
 /**
  * Define os bits dados em mask no registro reg.
  */
@@ -181,6 +273,26 @@ MFRC522::StatusCode MFRC522::PCD_CalculateCRC(byte *data, byte length, byte *res
 	return STATUS_TIMEOUT;
 } // Fim de PCD_CalculateCRC()
 
+/**
+ * Calcula um CRC_A (ISO/IEC 14443-3: polinômio 0x8408 refletido, valor inicial 0x6363) no MCU.
+ *
+ * Para quadros longos isso é mais rápido que o coprocessador, que exige copiar os dados para o FIFO
+ * pelo SPI e aguardar o resultado, e não tem o limite de 64 bytes do FIFO.
+ */
+void MFRC522::CalculateCRC_A(const byte *data, ///< Dados sobre os quais o CRC_A é calculado.
+							 uint16_t length,  ///< Número de bytes.
+							 byte *result	   ///< Recebe o CRC_A, 2 bytes (LSB primeiro, como é transmitido).
+)
+{
+	uint16_t crc = 0x6363;
+	for (uint16_t i = 0; i < length; i++)
+	{
+		crc = AtualizaCRC_A(crc, data[i]);
+	}
+	result[0] = crc & 0xFF;
+	result[1] = crc >> 8;
+} // Fim de CalculateCRC_A()
+
 /////////////////////////////////////////////////////////////////////////////////////
 // Funções para manipular o MFRC522
 /////////////////////////////////////////////////////////////////////////////////////
@@ -232,6 +344,7 @@ void MFRC522::PCD_Init()
 	PCD_WriteRegister(TPrescalerReg, 0xA9); // TPreScaler = TModeReg[3..0]:TPrescalerReg, ou seja, 0x0A9 = 169 => f_timer=40kHz, ou seja, um período de temporização de 25μs.
 	PCD_WriteRegister(TReloadRegH, 0x03);	// Recarregar temporizador com 0x3E8 = 1000, ou seja, 25ms antes do timeout.
 	PCD_WriteRegister(TReloadRegL, 0xE8);
+	_timeoutUs = TIMEOUT_DEFAULT_US;
 
 	PCD_WriteRegister(TxASKReg, 0x40); // Padrão 0x00. Força uma modulação ASK de 100 % independente da configuração do registro ModGsPReg
 	PCD_WriteRegister(ModeReg, 0x3D);  // Padrão 0x3F. Defina o valor predefinido para o coprocessador CRC para o comando CalcCRC como 0x6363 (ISO 14443-3 parte 6.2.4)
@@ -324,100 +437,50 @@ void MFRC522::PCD_SetAntennaGain(byte mascara)
 } // Fim de PCD_SetAntennaGain()
 
 /**
- * Realiza um autoteste do MFRC522
- * Consulte a seção 16.1.1 em http://www.nxp.com/documents/data_sheet/MFRC522.pdf
- *
- * @return Se o teste passou ou não. Ou falso se nenhuma referência de firmware estiver disponível.
+ * Programa o timeout do temporizador do MFRC522 usado nas comunicações com o PICC.
+ * Até 65535 * 25μs (~1,6s) o temporizador tem período de 25μs (veja PCD_Init()) e o timeout é arredondado
+ * para cima para um múltiplo de 25μs. Acima disso o prescaler é levado ao máximo (período de ~604μs), o que
+ * cobre o maior Frame Waiting Time da ISO/IEC 14443-4 (~4,9s) multiplicado por WTXM, até ~39s.
+ * Use TIMEOUT_DEFAULT_US para voltar ao valor configurado por PCD_Init().
  */
-
-bool MFRC522::PCD_PerformSelfTest()
+void MFRC522::PCD_SetTimeout(uint32_t timeoutUs ///< Tempo máximo de espera pela resposta do PICC, em microssegundos.
+)
 {
-	// Isso segue diretamente os passos descritos na seção 16.1.1
-	// 1. Realize uma reinicialização suave.
-	PCD_Reset();
-
-	// 2. Limpe o buffer interno escrevendo 25 bytes de 00h
-	byte ZEROES[25] = {0x00};
-	PCD_WriteRegister(FIFOLevelReg, 0x80);		// limpe o buffer FIFO
-	PCD_WriteRegister(FIFODataReg, 25, ZEROES); // escreva 25 bytes de 00h no FIFO
-	PCD_WriteRegister(CommandReg, PCD_Mem);		// transfira para o buffer interno
-
-	// 3. Ative o autoteste
-	PCD_WriteRegister(AutoTestReg, 0x09);
-
-	// 4. Escreva 00h no buffer FIFO
-	PCD_WriteRegister(FIFODataReg, 0x00);
-
-	// 5. Inicie o autoteste emitindo o comando CalcCRC
-	PCD_WriteRegister(CommandReg, PCD_CalcCRC);
-
-	// 6. Aguarde o autoteste ser concluído
-	byte n;
-	for (uint8_t i = 0; i < 0xFF; i++)
+	uint32_t recarga = (timeoutUs + 24) / 25;
+	uint16_t prescaler = 0x0A9; // 13,56MHz / (2 * 169 + 1) = 40kHz, 25μs
+	uint32_t programado;
+	if (recarga == 0)
 	{
-		// O datasheet não especifica uma condição exata de conclusão, exceto
-		// que o buffer FIFO deve conter 64 bytes.
-		// Embora o autoteste seja iniciado pelo comando CalcCRC
-		// ele se comporta de forma diferente da computação de CRC normal,
-		// então não é possível usar com confiabilidade o DivIrqReg para verificar a conclusão.
-		// Relata-se que alguns dispositivos não acionam a bandeira CRCIRq
-		// durante o autoteste.
-		n = PCD_ReadRegister(FIFOLevelReg);
-		if (n >= 64)
-		{
-			break;
-		}
+		recarga = 1;
 	}
-	PCD_WriteRegister(CommandReg, PCD_Idle); // Pare de calcular o CRC para novo conteúdo no FIFO.
-
-	// 7. Leia os 64 bytes resultantes do buffer FIFO.
-	byte result[64];
-	PCD_ReadRegister(FIFODataReg, 64, result, 0);
-
-	// Autoteste automático concluído
-	// Redefina o registro AutoTestReg para 0 novamente. Necessário para operação normal.
-	PCD_WriteRegister(AutoTestReg, 0x00);
-
-	// Determine a versão do firmware (consulte a seção 9.3.4.8 no manual)
-	byte version = PCD_ReadRegister(VersionReg);
-
-	// Escolha os valores de referência apropriados
-	const byte *reference;
-	switch (version)
+	if (recarga <= 0xFFFF)
 	{
-	case 0x88: // Clone Fudan Semiconductor FM17522
-		reference = FM17522_firmware_reference;
-		break;
-	case 0x90: // Versão 0.0
-		reference = MFRC522_firmware_referenceV0_0;
-		break;
-	case 0x91: // Versão 1.0
-		reference = MFRC522_firmware_referenceV1_0;
-		break;
-	case 0x92: // Versão 2.0
-		reference = MFRC522_firmware_referenceV2_0;
-		break;
-	default:		  // Versão desconhecida
-		return false; // abortar teste
+		programado = recarga * 25;
 	}
-
-	// Verifique se os resultados correspondem às nossas expectativas
-	for (uint8_t i = 0; i < 64; i++)
+	else
 	{
-		if (result[i] != pgm_read_byte(&(reference[i])))
+		// 13,56MHz / (2 * 4095 + 1): período de 8191 / 13,56μs
+		prescaler = 0xFFF;
+		recarga = ((uint64_t)timeoutUs * 1356 + 819099) / 819100;
+		if (recarga > 0xFFFF)
 		{
-			return false;
+			recarga = 0xFFFF;
 		}
+		programado = (uint64_t)recarga * 819100 / 1356;
 	}
-
-	// 8. Realize uma reinicialização, pois o PCD não funciona após o teste.
-	// A redefinição não funciona como o esperado.
-	// "Autoteste automático concluído" não funciona como o esperado.
-	PCD_Init();
-
-	// Teste passou; tudo está bom.
-	return true;
-} // Fim PCD_PerformSelfTest()
+	if (programado == _timeoutUs)
+	{ // Já programado, evita escritas SPI
+		return;
+	}
+	if ((prescaler == 0xFFF) != (_timeoutUs > 0xFFFFUL * 25))
+	{ // O prescaler muda apenas ao cruzar ~1,6s
+		PCD_WriteRegister(TModeReg, 0x80 | (prescaler >> 8)); // TAuto=1, TPrescaler_Hi
+		PCD_WriteRegister(TPrescalerReg, prescaler & 0xFF);
+	}
+	PCD_WriteRegister(TReloadRegH, recarga >> 8);
+	PCD_WriteRegister(TReloadRegL, recarga & 0xFF);
+	_timeoutUs = programado;
+} // Fim PCD_SetTimeout()
 
 /////////////////////////////////////////////////////////////////////////////////////
 // Controle de Energia
@@ -468,7 +531,10 @@ void MFRC522::PCD_SoftPowerUp()
 MFRC522::StatusCode MFRC522::PCD_TransceiveData(byte *sendData, byte sendLen, byte *backData, byte *backLen, byte *validBits, byte rxAlign, bool checkCRC)
 {
 	byte waitIRq = 0x30; // RxIRq e IdleIRq
-	return PCD_CommunicateWithPICC(PCD_Transceive, waitIRq, sendData, sendLen, backData, backLen, validBits, rxAlign, checkCRC);
+	MFRC522_TRACE_START(inicio);
+	MFRC522::StatusCode resultado = PCD_CommunicateWithPICC(PCD_Transceive, waitIRq, sendData, sendLen, backData, backLen, validBits, rxAlign, checkCRC);
+	MFRC522_TRACE_FRAME(sendLen ? sendData[0] : 0, sendLen, (resultado == STATUS_OK && backLen) ? *backLen : 0, resultado, inicio);
+	return resultado;
 } // Fim de PCD_TransceiveData()
 
 /**
@@ -479,8 +545,30 @@ MFRC522::StatusCode MFRC522::PCD_TransceiveData(byte *sendData, byte sendLen, by
  */
 MFRC522::StatusCode MFRC522::PCD_CommunicateWithPICC(byte command, byte waitIRq, byte *sendData, byte sendLen, byte *backData, byte *backLen, byte *validBits, byte rxAlign, bool checkCRC)
 {
-	// Prepare os valores para BitFramingReg
-	byte txLastBits = validBits ? *validBits : 0;
+	PCD_StartCommand(command, waitIRq, sendData, sendLen, validBits ? *validBits : 0, rxAlign);
+
+	MFRC522::StatusCode resultado;
+	while ((resultado = PCD_CheckCommand(backData, backLen, validBits, rxAlign, checkCRC)) == STATUS_PENDING)
+	{
+		yield();
+	}
+	return resultado;
+} // Fim de PCD_CommunicateWithPICC()
+
+/**
+ * Inicia um comando sem esperar por ele: transfere sendData para o FIFO, executa o comando e retorna.
+ * O MFRC522 conduz a troca de RF sozinho; o resultado é colhido com PCD_CheckCommand(), que pode ser chamado
+ * para vários leitores alternadamente (veja MFRC522ReaderGroup). Com ComIEnReg configurado, o pino IRQ
+ * sinaliza a conclusão.
+ */
+void MFRC522::PCD_StartCommand(byte command,	///< O comando a executar. Um dos enums PCD_Command.
+							   byte waitIRq,	///< Os bits de ComIrqReg que indicam a conclusão do comando.
+							   byte *sendData,	///< Ponteiro para os dados a serem transferidos para o FIFO.
+							   byte sendLen,	///< Número de bytes a transferir para o FIFO.
+							   byte txLastBits, ///< Número de bits válidos do último byte enviado. 0 para o byte inteiro.
+							   byte rxAlign		///< Posição do primeiro bit recebido a ser armazenado no primeiro byte.
+)
+{
 	byte bitFraming = (rxAlign << 4) + txLastBits; // RxAlign = BitFramingReg[6..4]. TxLastBits = BitFramingReg[2..0]
 
 	PCD_WriteRegister(CommandReg, PCD_Idle);		   // Pare qualquer comando ativo.
@@ -497,32 +585,40 @@ MFRC522::StatusCode MFRC522::PCD_CommunicateWithPICC(byte command, byte waitIRq,
 	// Em PCD_Init(), definimos a bandeira TAuto em TModeReg. Isso significa que o temporizador
 	// inicia automaticamente quando o PCD para de transmitir.
 	//
-	// Aguarde aqui até que o comando seja concluído. Os bits especificados no
-	// parâmetro 'waitIRq' definem quais bits constituem um comando concluído.
-	// Quando eles estão definidos no registro ComIrqReg, então o comando é
-	// considerado completo. Se o comando não for indicado como completo em
-	// ~36ms, considere o comando como expirado.
-	const uint32_t deadline = millis() + 36;
-	bool completed = false;
+	// Os bits especificados no parâmetro 'waitIRq' definem quais bits constituem um comando concluído.
+	// Quando eles estão definidos no registro ComIrqReg, então o comando é considerado completo.
+	// Se o comando não for indicado como completo em timeout do temporizador + ~11ms (~36ms com o padrão),
+	// considere o comando como expirado.
+	_waitIRq = waitIRq;
+	_deadline = millis() + (_timeoutUs / 1000) + 11;
+} // Fim de PCD_StartCommand()
 
-	do
-	{
-		byte n = PCD_ReadRegister(ComIrqReg); // Os bits ComIrqReg[7..0] são: Set1 TxIRq RxIRq IdleIRq HiAlertIRq LoAlertIRq ErrIRq TimerIRq
-		if (n & waitIRq)
-		{ // Um dos bits de interrupção que sinaliza o sucesso foi definido.
-			completed = true;
-			break;
-		}
+/**
+ * Verifica, com uma leitura de ComIrqReg, se o comando iniciado por PCD_StartCommand() terminou.
+ * Se terminou, trata erros e transfere os dados de volta do FIFO como PCD_CommunicateWithPICC().
+ * A validação do CRC só pode ser feita se backData e backLen forem especificados.
+ *
+ * @return STATUS_PENDING enquanto o comando estiver em andamento, STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522::PCD_CheckCommand(byte *backData,	///< nullptr ou ponteiro para o buffer dos dados recebidos.
+											  byte *backLen,	///< Entrada: Tamanho máximo de backData. Saída: Número de bytes recebidos.
+											  byte *validBits,	///< nullptr ou Saída: Número de bits válidos do último byte recebido.
+											  byte rxAlign,		///< O mesmo valor passado a PCD_StartCommand().
+											  bool checkCRC		///< true para validar o CRC_A dos dados recebidos.
+)
+{
+	byte n = PCD_ReadRegister(ComIrqReg); // Os bits ComIrqReg[7..0] são: Set1 TxIRq RxIRq IdleIRq HiAlertIRq LoAlertIRq ErrIRq TimerIRq
+	if (!(n & _waitIRq))
+	{ // Nenhum dos bits de interrupção que sinalizam o sucesso foi definido.
 		if (n & 0x01)
-		{ // Interrupção do temporizador - nada recebido em 25ms
+		{ // Interrupção do temporizador - nada recebido dentro do timeout programado
 			return STATUS_TIMEOUT;
 		}
-		yield();
-	} while (static_cast<uint32_t>(millis()) < deadline);
-
-	// 36ms e nada aconteceu. A comunicação com o MFRC522 pode estar inativa.
-	if (!completed)
-	{
+		if (static_cast<uint32_t>(millis()) < _deadline)
+		{
+			return STATUS_PENDING;
+		}
+		// O prazo passou e nada aconteceu. A comunicação com o MFRC522 pode estar inativa.
 		return STATUS_TIMEOUT;
 	}
 
@@ -585,7 +681,270 @@ MFRC522::StatusCode MFRC522::PCD_CommunicateWithPICC(byte command, byte waitIRq,
 	}
 
 	return STATUS_OK;
-} // Fim de PCD_CommunicateWithPICC()
+} // Fim de PCD_CheckCommand()
+
+/**
+ * Executa o comando Transceive para respostas maiores que o FIFO de 64 bytes.
+ *
+ * O FIFO é esvaziado enquanto a resposta ainda está sendo recebida, então a resposta pode ter qualquer
+ * tamanho que caiba em backData. A 106 kBd um byte chega a cada ~85μs, tempo suficiente para ler o FIFO
+ * mesmo em um AVR. Se checkCRC for true, o CRC_A é verificado no MCU enquanto os dados chegam e os dois
+ * bytes do CRC_A não são copiados para backData.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_MIFARE_NACK se o PICC respondeu com NAK, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522::PCD_TransceiveLong(byte *sendData,	 ///< Ponteiro para os dados a serem transferidos para o FIFO.
+												 byte sendLen,	 ///< Número de bytes a transferir, no máximo FIFO_SIZE.
+												 byte *backData, ///< Buffer para a resposta.
+												 uint16_t *backLen, ///< Entrada: tamanho de backData. Saída: número de bytes recebidos (sem o CRC_A, se checkCRC).
+												 bool checkCRC	 ///< true para verificar e remover o CRC_A da resposta.
+)
+{
+	byte fifo[FIFO_SIZE];
+	byte retidos[2];		   // Com checkCRC, os dois últimos bytes recebidos ficam retidos: no final eles são o CRC_A.
+	byte numeroRetidos = 0;
+	uint16_t crc = 0x6363;
+	uint16_t recebidos = 0;	   // Bytes copiados para backData
+	bool concluido = false;
+
+	if (sendLen > FIFO_SIZE)
+	{
+		return STATUS_INVALID;
+	}
+
+	PCD_WriteRegister(CommandReg, PCD_Idle);		   // Pare qualquer comando ativo.
+	PCD_WriteRegister(ComIrqReg, 0x7F);				   // Limpe todos os sete bits de solicitação de interrupção
+	PCD_WriteRegister(FIFOLevelReg, 0x80);			   // FlushBuffer = 1, inicialização do FIFO
+	PCD_WriteRegister(FIFODataReg, sendLen, sendData); // Escreva sendData no FIFO
+	PCD_WriteRegister(BitFramingReg, 0x00);			   // Bytes completos
+	PCD_WriteRegister(CommandReg, PCD_Transceive);
+	PCD_SetRegisterBitMask(BitFramingReg, 0x80);	   // StartSend=1, início da transmissão de dados
+
+	// Além do timeout do temporizador, o prazo inclui o tempo de recepção da resposta (~87μs por byte a 106 kBd).
+	const uint32_t deadline = millis() + (_timeoutUs / 1000) + 11 + (*backLen + 2) / 10;
+	do
+	{
+		byte irq = PCD_ReadRegister(ComIrqReg); // Lido antes do FIFO: se a recepção terminou, o FIFO já contém todo o resto.
+		byte n = PCD_ReadRegister(FIFOLevelReg) & 0x7F;
+		if (n)
+		{
+			PCD_ReadRegister(FIFODataReg, n, fifo);
+			for (byte i = 0; i < n; i++)
+			{
+				byte dado = fifo[i];
+				if (checkCRC)
+				{
+					if (numeroRetidos < 2)
+					{
+						retidos[numeroRetidos++] = dado;
+						continue;
+					}
+					byte liberado = retidos[0];
+					retidos[0] = retidos[1];
+					retidos[1] = dado;
+					dado = liberado;
+					crc = AtualizaCRC_A(crc, dado);
+				}
+				if (recebidos >= *backLen)
+				{
+					PCD_WriteRegister(CommandReg, PCD_Idle);
+					return STATUS_NO_ROOM;
+				}
+				backData[recebidos++] = dado;
+			}
+		}
+		if (irq & 0x30)
+		{ // RxIRq ou IdleIRq: recepção concluída e FIFO esvaziado
+			concluido = true;
+			break;
+		}
+		if (irq & 0x01)
+		{ // Interrupção do temporizador - nada recebido dentro do timeout programado
+			return STATUS_TIMEOUT;
+		}
+		yield();
+	} while (static_cast<uint32_t>(millis()) < deadline);
+
+	if (!concluido)
+	{
+		PCD_WriteRegister(CommandReg, PCD_Idle);
+		return STATUS_TIMEOUT;
+	}
+
+	byte errorRegValue = PCD_ReadRegister(ErrorReg); // WrErr TempErr reservado BufferOvfl CollErr CRCErr ParityErr ProtocolErr
+	byte bitsValidos = PCD_ReadRegister(ControlReg) & 0x07;
+	// Um NAK tem apenas 4 bits e, por isso, também causa um erro de paridade
+	if (recebidos + numeroRetidos == 1 && bitsValidos == 4)
+	{
+		return STATUS_MIFARE_NACK;
+	}
+	if (errorRegValue & 0x13)
+	{ // BufferOvfl ParityErr ProtocolErr
+		return STATUS_ERROR;
+	}
+	if (errorRegValue & 0x08)
+	{ // CollErr
+		return STATUS_COLLISION;
+	}
+	if (checkCRC && (numeroRetidos < 2 || bitsValidos != 0 || retidos[0] != (crc & 0xFF) || retidos[1] != (crc >> 8)))
+	{
+		return STATUS_CRC_WRONG;
+	}
+	*backLen = recebidos;
+	return STATUS_OK;
+} // Fim de PCD_TransceiveLong()
+
+/**
+ * Transmite um quadro formado por vários segmentos e distribui a resposta por vários buffers, sem montar o
+ * quadro em um buffer intermediário: os segmentos são escritos no FIFO um após o outro e a resposta é lida
+ * do FIFO diretamente para cada buffer, em ordem. Cada segmento de resposta é preenchido antes do próximo;
+ * ao retornar, backSegments[i].size contém o número de bytes recebidos nele.
+ *
+ * Com crcOnMcu, o CRC_A é calculado no MCU enquanto os segmentos são escritos e verificado enquanto a resposta
+ * é lida; sem ele, o CRC_A fica a cargo do MFRC522 (TxCRCEn/RxCRCEn) ou do chamador.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_NO_ROOM se a resposta não couber nos segmentos, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522::PCD_TransceiveSegments(const FifoSegment *sendSegments, ///< Segmentos a transmitir, em ordem.
+													byte sendCount,					 ///< Número de segmentos a transmitir.
+													FifoSegment *backSegments,		 ///< Segmentos para a resposta, em ordem.
+													byte backCount,					 ///< Número de segmentos para a resposta.
+													byte *backLen,					 ///< Recebe o número total de bytes recebidos (sem o CRC_A, se crcOnMcu).
+													bool crcOnMcu					 ///< true para acrescentar e verificar o CRC_A no MCU.
+)
+{
+	MFRC522_TRACE_START(inicio);
+	MFRC522::StatusCode resultado = PCD_ExchangeSegments(sendSegments, sendCount, backSegments, backCount, backLen, crcOnMcu);
+	MFRC522_TRACE_FRAME(PrimeiroByte(sendSegments, sendCount), TamanhoSegmentos(sendSegments, sendCount), (resultado == STATUS_OK && backLen) ? *backLen : 0, resultado, inicio);
+	return resultado;
+} // Fim de PCD_TransceiveSegments()
+
+/**
+ * Corpo de PCD_TransceiveSegments(), sem o registro de trace.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522::PCD_ExchangeSegments(const FifoSegment *sendSegments, byte sendCount, FifoSegment *backSegments, byte backCount, byte *backLen, bool crcOnMcu)
+{
+	uint16_t crc = 0x6363;
+	uint16_t total = crcOnMcu ? 2 : 0;
+
+	for (byte i = 0; i < sendCount; i++)
+	{
+		total += sendSegments[i].size;
+	}
+	if (total > FIFO_SIZE)
+	{
+		return STATUS_INVALID;
+	}
+
+	PCD_WriteRegister(CommandReg, PCD_Idle); // Pare qualquer comando ativo.
+	PCD_WriteRegister(ComIrqReg, 0x7F);		 // Limpe todos os sete bits de solicitação de interrupção
+	PCD_WriteRegister(FIFOLevelReg, 0x80);	 // FlushBuffer = 1, inicialização do FIFO
+	for (byte i = 0; i < sendCount; i++)
+	{
+		if (sendSegments[i].size == 0)
+		{
+			continue;
+		}
+		PCD_WriteRegister(FIFODataReg, sendSegments[i].size, sendSegments[i].data);
+		for (byte j = 0; crcOnMcu && j < sendSegments[i].size; j++)
+		{
+			crc = AtualizaCRC_A(crc, sendSegments[i].data[j]);
+		}
+	}
+	if (crcOnMcu)
+	{
+		PCD_WriteRegister(FIFODataReg, crc & 0xFF);
+		PCD_WriteRegister(FIFODataReg, crc >> 8);
+	}
+	PCD_WriteRegister(BitFramingReg, 0x00);		 // Bytes completos
+	PCD_WriteRegister(CommandReg, PCD_Transceive);
+	PCD_SetRegisterBitMask(BitFramingReg, 0x80); // StartSend=1, início da transmissão de dados
+
+	const uint32_t deadline = millis() + (_timeoutUs / 1000) + 11;
+	bool concluido = false;
+	do
+	{
+		byte irq = PCD_ReadRegister(ComIrqReg);
+		if (irq & 0x30)
+		{ // RxIRq ou IdleIRq
+			concluido = true;
+			break;
+		}
+		if (irq & 0x01)
+		{ // Interrupção do temporizador - nada recebido dentro do timeout programado
+			return STATUS_TIMEOUT;
+		}
+		yield();
+	} while (static_cast<uint32_t>(millis()) < deadline);
+
+	if (!concluido)
+	{
+		return STATUS_TIMEOUT;
+	}
+
+	byte errorRegValue = PCD_ReadRegister(ErrorReg); // WrErr TempErr reservado BufferOvfl CollErr CRCErr ParityErr ProtocolErr
+	byte n = PCD_ReadRegister(FIFOLevelReg) & 0x7F;
+	byte bitsValidos = PCD_ReadRegister(ControlReg) & 0x07;
+	// Um NAK tem apenas 4 bits e, por isso, também causa um erro de paridade
+	if (n == 1 && bitsValidos == 4)
+	{
+		return STATUS_MIFARE_NACK;
+	}
+	if (errorRegValue & 0x13)
+	{ // BufferOvfl ParityErr ProtocolErr
+		return STATUS_ERROR;
+	}
+	if (errorRegValue & 0x08)
+	{ // CollErr
+		return STATUS_COLLISION;
+	}
+	if (crcOnMcu)
+	{
+		if (n < 2 || bitsValidos != 0)
+		{
+			return STATUS_CRC_WRONG;
+		}
+		n -= 2;
+	}
+
+	// Distribui os bytes recebidos pelos segmentos
+	byte restantes = n;
+	crc = 0x6363;
+	for (byte i = 0; i < backCount; i++)
+	{
+		byte quantidade = (restantes < backSegments[i].size) ? restantes : backSegments[i].size;
+		if (backSegments[i].data && quantidade)
+		{
+			PCD_ReadRegister(FIFODataReg, quantidade, backSegments[i].data, 0);
+			for (byte j = 0; crcOnMcu && j < quantidade; j++)
+			{
+				crc = AtualizaCRC_A(crc, backSegments[i].data[j]);
+			}
+		}
+		else
+		{ // Sem buffer: os bytes são descartados
+			for (byte j = 0; j < quantidade; j++)
+			{
+				crc = AtualizaCRC_A(crc, PCD_ReadRegister(FIFODataReg));
+			}
+		}
+		backSegments[i].size = quantidade;
+		restantes -= quantidade;
+	}
+	if (restantes)
+	{
+		return STATUS_NO_ROOM;
+	}
+
+	if (crcOnMcu && (PCD_ReadRegister(FIFODataReg) != (crc & 0xFF) || PCD_ReadRegister(FIFODataReg) != (crc >> 8)))
+	{
+		return STATUS_CRC_WRONG;
+	}
+	*backLen = n;
+	return STATUS_OK;
+} // Fim de PCD_ExchangeSegments()
 
 /**
  * Transmite um comando REQuest, Tipo A. Convida os PICCs no estado IDLE a irem para o estado READY e se prepararem para anticollision ou seleção. Quadro de 7 bits.
@@ -610,13 +969,54 @@ MFRC522::StatusCode MFRC522::PICC_WakeupA(byte *bufferATQA, byte *bufferSize)
 } // Fim de PICC_WakeupA()
 
 /**
- * Transmite os comandos REQA ou WUPA.
- * Atenção: Quando dois PICCs estão no campo ao mesmo tempo, muitas vezes obtenho STATUS_TIMEOUT - provavelmente devido a um projeto de antena ruim.
- *
- * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ * Inicia um REQA, como PICC_IsNewCardPresent(), e retorna sem esperar a resposta. Conclua com PICC_CheckRequestA().
+ * As taxas de transmissão e ModWidthReg voltam aos valores de 106 kBd, e os bits recebidos após uma colisão são apagados.
  */
+void MFRC522::PICC_StartRequestA()
+{
+	byte comando = PICC_CMD_REQA;
+
+	// Redefine as taxas de transmissão
+	PCD_WriteRegister(TxModeReg, 0x00);
+	PCD_WriteRegister(RxModeReg, 0x00);
+	// Redefine ModWidthReg
+	PCD_WriteRegister(ModWidthReg, 0x26);
+
+	PCD_ClearRegisterBitMask(CollReg, 0x80);		   // ValuesAfterColl=1 => Bits recebidos após a colisão são apagados.
+	PCD_StartCommand(PCD_Transceive, 0x30, &comando, 1, 7); // RxIRq e IdleIRq; REQA é um quadro de 7 bits
+} // Fim de PICC_StartRequestA()
+
 /**
- * Transmite comandos SELECT/ANTICOLLISION para selecionar um único PICC.
+ * Verifica se o REQA iniciado por PICC_StartRequestA() terminou e confere o ATQA.
+ *
+ * @return STATUS_PENDING enquanto o REQA estiver em andamento, STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522::PICC_CheckRequestA(byte *bufferATQA, ///< Buffer para o ATQA.
+												byte *bufferSize  ///< Tamanho do buffer, pelo menos 2 bytes. Recebe o número de bytes do ATQA.
+)
+{
+	byte bitsValidos = 0;
+
+	if (bufferATQA == nullptr || *bufferSize < 2)
+	{ // O ATQA tem 2 bytes.
+		return STATUS_NO_ROOM;
+	}
+	MFRC522::StatusCode resultado = PCD_CheckCommand(bufferATQA, bufferSize, &bitsValidos);
+	if (resultado == STATUS_OK && (*bufferSize != 2 || bitsValidos != 0))
+	{ // O ATQA deve ter exatamente 16 bits.
+		return STATUS_ERROR;
+	}
+	return resultado;
+} // Fim de PICC_CheckRequestA()
+
+/**
+ * Transmite os comandos REQA ou WUPA.
+ * Atenção: Quando dois PICCs estão no campo ao mesmo tempo, muitas vezes obtenho STATUS_TIMEOUT - provavelmente devido a um projeto de antena ruim.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+/**
+ * Transmite comandos SELECT/ANTICOLLISION para selecionar um único PICC.
  * Antes de chamar esta função, os PICCs devem estar no estado READY(*) chamando PICC_RequestA() ou PICC_WakeupA().
  * Em caso de sucesso:
  *      - O PICC escolhido está no estado ACTIVE(*) e todos os outros PICCs retornaram ao estado IDLE/HALT. (Figura 7 do rascunho ISO/IEC 14443-3.)
@@ -860,7 +1260,11 @@ MFRC522::StatusCode MFRC522::PICC_HaltA()
 	//		Se o PICC responder com qualquer modulação durante um período de 1 ms após o final do quadro contendo o
 	//		comando HLTA, essa resposta será interpretada como 'não reconhecida'.
 	// Interpretamos da seguinte forma: Apenas STATUS_TIMEOUT é um sucesso.
+	// Como o sucesso é o timeout, espera apenas a janela de 1 ms em vez do timeout atual.
+	const uint32_t timeoutAnterior = _timeoutUs;
+	PCD_SetTimeout(TIMEOUT_HALT_US);
 	resultado = PCD_TransceiveData(buffer, sizeof(buffer), nullptr, 0);
+	PCD_SetTimeout(timeoutAnterior);
 	if (resultado == STATUS_TIMEOUT)
 	{
 		return STATUS_OK;
@@ -982,6 +1386,70 @@ MFRC522::StatusCode MFRC522::MIFARE_Read(byte blocoAddr,  ///< MIFARE Classic: O
 	return PCD_TransceiveData(buffer, 4, buffer, bufferSize, nullptr, 0, true);
 } // Fim MIFARE_Read()
 
+/**
+ * Lê um intervalo de páginas de um PICC MIFARE Ultralight EV1 ou NTAG21x com o comando FAST_READ.
+ *
+ * MIFARE_Read() retorna 4 páginas por quadro; FAST_READ retorna todo o intervalo em um quadro. O intervalo
+ * é dividido em quadros de até pagesPerFrame páginas. Respostas maiores que o FIFO são recebidas com
+ * PCD_TransceiveLong(), que esvazia o FIFO durante a recepção; use UL_FAST_READ_FIFO_PAGES se o MCU
+ * não conseguir acompanhar a recepção. O CRC_A é calculado e verificado no MCU.
+ * O MIFARE Ultralight original não suporta FAST_READ e responde com NAK.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522::MIFARE_Ultralight_FastRead(byte paginaInicial,	   ///< Primeira página a ler.
+														byte paginaFinal,	   ///< Última página a ler, inclusive.
+														byte *buffer,		   ///< O buffer para armazenar os dados, 4 bytes por página.
+														uint16_t *bufferSize,  ///< Tamanho do buffer. Também é o número de bytes retornados se STATUS_OK.
+														byte paginasPorQuadro  ///< Máximo de páginas por quadro FAST_READ.
+)
+{
+	MFRC522::StatusCode resultado;
+	byte comando[5]; // FAST_READ, página inicial, página final, CRC_A
+
+	// Verificação de sanidade
+	if (paginaFinal < paginaInicial || paginasPorQuadro == 0)
+	{
+		return STATUS_INVALID;
+	}
+	const uint16_t total = ((uint16_t)paginaFinal - paginaInicial + 1) * 4;
+	if (buffer == nullptr || *bufferSize < total)
+	{
+		return STATUS_NO_ROOM;
+	}
+
+	uint16_t deslocamento = 0;
+	uint16_t pagina = paginaInicial;
+	while (pagina <= paginaFinal)
+	{
+		uint16_t ultima = pagina + paginasPorQuadro - 1;
+		if (ultima > paginaFinal)
+		{
+			ultima = paginaFinal;
+		}
+		comando[0] = PICC_CMD_UL_FAST_READ;
+		comando[1] = pagina;
+		comando[2] = ultima;
+		CalculateCRC_A(comando, 3, &comando[3]);
+
+		uint16_t esperado = (ultima - pagina + 1) * 4;
+		uint16_t tamanho = esperado;
+		resultado = PCD_TransceiveLong(comando, sizeof(comando), &buffer[deslocamento], &tamanho, true);
+		if (resultado != STATUS_OK)
+		{
+			return resultado;
+		}
+		if (tamanho != esperado)
+		{
+			return STATUS_ERROR;
+		}
+		deslocamento += tamanho;
+		pagina = ultima + 1;
+	}
+	*bufferSize = total;
+	return STATUS_OK;
+} // Fim MIFARE_Ultralight_FastRead()
+
 /**
  * Escreve 16 bytes no PICC ativo.
  *
@@ -1058,6 +1526,118 @@ MFRC522::StatusCode MFRC522::MIFARE_Ultralight_Write(	byte page, 		///< The page
 	return STATUS_OK;
 } // End MIFARE_Ultralight_Write()
 
+/**
+ * Monta um quadro WRITE (0xA2) de MIFARE Ultralight com o CRC_A, completando com zeros depois do fim dos dados.
+ */
+static void MontaQuadroEscritaUL(byte *quadro, byte pagina, const byte *dados, uint16_t deslocamento, uint16_t tamanho)
+{
+	quadro[0] = MFRC522::PICC_CMD_UL_WRITE;
+	quadro[1] = pagina;
+	for (byte i = 0; i < 4; i++)
+	{
+		quadro[2 + i] = (deslocamento + i < tamanho) ? dados[deslocamento + i] : 0x00;
+	}
+	MFRC522::CalculateCRC_A(quadro, 6, &quadro[6]);
+} // Fim MontaQuadroEscritaUL()
+
+/**
+ * Escreve várias páginas consecutivas em um PICC MIFARE Ultralight ou NTAG21x com o comando WRITE (0xA2).
+ *
+ * Em vez de uma chamada de MIFARE_Ultralight_Write() por página, as páginas são enviadas em sequência:
+ * - o comando Transceive do MFRC522 é iniciado uma vez e cada quadro só precisa de StartSend;
+ * - o CRC_A é calculado no MCU, e o quadro da próxima página é preparado enquanto o PICC grava a atual;
+ * - o timeout é programado para o tempo de gravação do EEPROM (TIMEOUT_UL_WRITE_US) em vez de 25ms.
+ * Se length não for múltiplo de 4, a última página é completada com zeros.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522::MIFARE_Ultralight_WritePages(byte paginaInicial,		///< Primeira página a escrever.
+														  const byte *dados,		///< Dados a escrever, 4 bytes por página.
+														  uint16_t tamanho,			///< Número de bytes em dados.
+														  uint16_t *paginasEscritas ///< Se não for nullptr, recebe o número de páginas confirmadas pelo PICC.
+)
+{
+	MFRC522::StatusCode resultado = STATUS_OK;
+	byte quadro[8]; // WRITE, página, 4 bytes de dados, CRC_A
+	byte resposta;
+
+	if (paginasEscritas)
+	{
+		*paginasEscritas = 0;
+	}
+	// Verificação de sanidade
+	if (dados == nullptr || tamanho == 0)
+	{
+		return STATUS_INVALID;
+	}
+	const uint16_t numeroPaginas = (tamanho + 3) / 4;
+	if ((uint16_t)paginaInicial + numeroPaginas > 256)
+	{
+		return STATUS_INVALID;
+	}
+
+	// Prepara o primeiro quadro
+	MontaQuadroEscritaUL(quadro, paginaInicial, dados, 0, tamanho);
+
+	const uint32_t timeoutAnterior = _timeoutUs;
+	PCD_SetTimeout(TIMEOUT_UL_WRITE_US);
+	PCD_WriteRegister(CommandReg, PCD_Idle);	// Pare qualquer comando ativo.
+	PCD_WriteRegister(BitFramingReg, 0x00);
+	PCD_WriteRegister(CommandReg, PCD_Transceive); // Permanece ativo: cada quadro é iniciado apenas com StartSend
+
+	for (uint16_t indice = 0; indice < numeroPaginas; indice++)
+	{
+		PCD_WriteRegister(ComIrqReg, 0x7F);			   // Limpe todos os sete bits de solicitação de interrupção
+		PCD_WriteRegister(FIFOLevelReg, 0x80);		   // FlushBuffer = 1, inicialização do FIFO
+		PCD_WriteRegister(FIFODataReg, 8, quadro);	   // Quadro completo, com o CRC_A
+		PCD_WriteRegister(BitFramingReg, 0x80);		   // StartSend=1, TxLastBits=0
+
+		// Enquanto o PICC grava a página (~4ms), prepara o próximo quadro.
+		if (indice + 1 < numeroPaginas)
+		{
+			MontaQuadroEscritaUL(quadro, paginaInicial + indice + 1, dados, (indice + 1) * 4, tamanho);
+		}
+
+		// Aguarda o ACK de 4 bits. O temporizador limita a espera ao tempo de gravação.
+		const uint32_t deadline = millis() + (_timeoutUs / 1000) + 11;
+		byte irq;
+		do
+		{
+			irq = PCD_ReadRegister(ComIrqReg); // Set1 TxIRq RxIRq IdleIRq HiAlertIRq LoAlertIRq ErrIRq TimerIRq
+			if (irq & 0x21)
+			{ // RxIRq ou TimerIRq
+				break;
+			}
+			yield();
+		} while (static_cast<uint32_t>(millis()) < deadline);
+
+		if (!(irq & 0x20))
+		{ // Nenhuma resposta
+			resultado = STATUS_TIMEOUT;
+			break;
+		}
+		resposta = PCD_ReadRegister(FIFODataReg);
+		if ((PCD_ReadRegister(ControlReg) & 0x07) != 4)
+		{ // O PICC deve responder com um ACK de 4 bits
+			resultado = STATUS_ERROR;
+			break;
+		}
+		if ((resposta & 0x0F) != MF_ACK)
+		{
+			resultado = STATUS_MIFARE_NACK;
+			break;
+		}
+		if (paginasEscritas)
+		{
+			(*paginasEscritas)++;
+		}
+	}
+
+	PCD_WriteRegister(CommandReg, PCD_Idle);
+	PCD_SetTimeout(timeoutAnterior);
+	return resultado;
+} // Fim MIFARE_Ultralight_WritePages()
+
 /**
  * MIFARE Decremento subtrai o delta do valor do bloco endereçado e armazena o resultado em uma memória volátil.
  * Somente para MIFARE Classic. O setor que contém o bloco deve estar autenticado antes de chamar esta função.
@@ -1127,7 +1707,12 @@ MFRC522::StatusCode MFRC522::MIFARE_TwoStepHelper(byte comando,	  ///< O comando
 	}
 
 	// Etapa 2: Transferir os dados
+	// O PICC não confirma esta etapa, apenas um NAK pode chegar. Em vez de esperar o timeout
+	// completo, usa uma janela curta que é suficiente para receber um eventual NAK.
+	uint32_t timeoutAnterior = _timeoutUs;
+	PCD_SetTimeout(TIMEOUT_MF_PASSIVE_ACK_US);
 	resultado = PCD_MIFARE_Transceive((byte *)&dados, 4, true); // Adiciona CRC_A e aceita timeout como sucesso.
+	PCD_SetTimeout(timeoutAnterior);
 	if (resultado != STATUS_OK)
 	{
 		return resultado;
@@ -1187,6 +1772,38 @@ MFRC522::StatusCode MFRC522::MIFARE_GetValue(byte blocoAddr, int32_t *valor)
 	return status;
 } // Fim MIFARE_GetValue()
 
+/**
+ * Valida o formato de um Bloco de Valor no MCU e extrai o valor.
+ *
+ * Um Bloco de Valor guarda o valor três vezes (normal, invertido, normal) e o endereço
+ * quatro vezes (normal, invertido, normal, invertido). Nenhuma comunicação com o PICC é feita.
+ *
+ * @param[in]   buffer      Os 16 bytes do bloco, por exemplo lidos com MIFARE_Read().
+ * @param[out]  valor       Valor do Bloco de Valor, se o formato for válido.
+ * @param[out]  enderecoValor Byte de endereço guardado no bloco, se não for nullptr.
+ * @return true se o bloco tem o formato de Bloco de Valor, false caso contrário.
+ */
+bool MFRC522::MIFARE_DecodeValueBlock(byte *buffer, int32_t *valor, byte *enderecoValor)
+{
+	for (byte i = 0; i < 4; i++)
+	{
+		if (buffer[i] != buffer[i + 8] || buffer[i] != (byte)~buffer[i + 4])
+		{
+			return false;
+		}
+	}
+	if (buffer[12] != buffer[14] || buffer[13] != buffer[15] || buffer[12] != (byte)~buffer[13])
+	{
+		return false;
+	}
+	*valor = (int32_t(buffer[3]) << 24) | (int32_t(buffer[2]) << 16) | (int32_t(buffer[1]) << 8) | int32_t(buffer[0]);
+	if (enderecoValor)
+	{
+		*enderecoValor = buffer[12];
+	}
+	return true;
+} // Fim MIFARE_DecodeValueBlock()
+
 /**
  * Rotina auxiliar para escrever um valor específico em um Bloco de Valor.
  *
@@ -1229,48 +1846,40 @@ MFRC522::StatusCode MFRC522::MIFARE_SetValue(byte blocoAddr, int32_t valor)
 } // Fim MIFARE_SetValue()
 
 /**
- * Autenticação com um NTAG216.
+ * Autenticação com senha (PWD_AUTH, 0x1B) de um NTAG213/215/216 ou MIFARE Ultralight EV1.
  *
- * Apenas para NTAG216. Primeiramente implementado por Gargantuanman.
+ * O PICC responde com o PACK (2 bytes) e o CRC_A; pACK só é preenchido se a resposta estiver correta.
+ * Se a senha estiver errada o PICC responde com NAK (STATUS_MIFARE_NACK), incrementa seu contador de falhas
+ * (limitado por AUTHLIM) e volta ao estado IDLE. Primeiramente implementado por Gargantuanman.
+ * Veja também MFRC522NtagSession, que autentica uma única vez por seleção e verifica o PACK.
  *
- * @param[in]   senha   senha.
- * @param[in]   pACK    resultado de sucesso???.
  * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
  */
-MFRC522::StatusCode MFRC522::PCD_NTAG216_AUTH(byte *senha, byte pACK[]) // Autenticação com senha de 32 bits
+MFRC522::StatusCode MFRC522::PCD_NTAG216_AUTH(const byte *senha, ///< Senha de 32 bits (4 bytes).
+											  byte pACK[]		 ///< Recebe o PACK (2 bytes) se STATUS_OK.
+)
 {
-	// TODO: Corrigir o comprimento de cmdBuffer e rxlength. Eles realmente deveriam ser iguais.
-	//       (Melhor ainda, rxlength nem deveria ser necessário.)
-
 	MFRC522::StatusCode resultado;
-	byte cmdBuffer[18]; // Precisamos de espaço para 16 bytes de dados e 2 bytes de CRC_A.
-
-	cmdBuffer[0] = 0x1B; // Comando de autenticação
-
-	for (byte i = 0; i < 4; i++)
-		cmdBuffer[i + 1] = senha[i];
+	byte comando[7];
+	byte resposta[4]; // PACK e CRC_A
 
-	resultado = PCD_CalculateCRC(cmdBuffer, 5, &cmdBuffer[5]);
+	comando[0] = PICC_CMD_UL_PWD_AUTH;
+	memcpy(&comando[1], senha, 4);
+	CalculateCRC_A(comando, 5, &comando[5]);
 
+	byte tamanho = sizeof(resposta);
+	resultado = PCD_TransceiveData(comando, sizeof(comando), resposta, &tamanho, nullptr, 0, true);
 	if (resultado != STATUS_OK)
 	{
 		return resultado;
 	}
-
-	// Transfira os dados, armazene a resposta em cmdBuffer[]
-	byte waitIRq = 0x30; // RxIRq e IdleIRq
-	byte validBits = 0;
-	byte rxlength = 5;
-	resultado = PCD_CommunicateWithPICC(PCD_Transceive, waitIRq, cmdBuffer, 7, cmdBuffer, &rxlength, &validBits);
-
-	pACK[0] = cmdBuffer[0];
-	pACK[1] = cmdBuffer[1];
-
-	if (resultado != STATUS_OK)
+	if (tamanho != sizeof(resposta))
 	{
-		return resultado;
+		return STATUS_ERROR;
 	}
 
+	pACK[0] = resposta[0];
+	pACK[1] = resposta[1];
 	return STATUS_OK;
 } // Fim PCD_NTAG216_AUTH()
 
@@ -1332,39 +1941,6 @@ MFRC522::StatusCode MFRC522::PCD_MIFARE_Transceive(byte *sendData,	  ///< Pontei
 	return STATUS_OK;
 } // Fim PCD_MIFARE_Transceive()
 
-/**
- * Retorna um ponteiro __FlashStringHelper para o nome do código de status.
- *
- * @return const __FlashStringHelper *
- */
-const __FlashStringHelper *MFRC522::GetStatusCodeName(MFRC522::StatusCode code ///< Um dos enums StatusCode.
-)
-{
-	switch (code)
-	{
-	case STATUS_OK:
-		return F("Sucesso.");
-	case STATUS_ERROR:
-		return F("Erro na comunicação.");
-	case STATUS_COLLISION:
-		return F("Colisão detectada.");
-	case STATUS_TIMEOUT:
-		return F("Timeout na comunicação.");
-	case STATUS_NO_ROOM:
-		return F("Um buffer não tem tamanho suficiente.");
-	case STATUS_INTERNAL_ERROR:
-		return F("Erro interno no código. Não deveria ocorrer.");
-	case STATUS_INVALID:
-		return F("Argumento inválido.");
-	case STATUS_CRC_WRONG:
-		return F("O CRC_A não corresponde.");
-	case STATUS_MIFARE_NACK:
-		return F("Um PICC MIFARE respondeu com NAK.");
-	default:
-		return F("Erro desconhecido");
-	}
-} // Fim GetStatusCodeName()
-
 /**
  * Traduz o SAK (Select Acknowledge) para um tipo de PICC.
  *
@@ -1375,71 +1951,10 @@ MFRC522::PICC_Type MFRC522::PICC_GetType(byte sak ///< O byte SAK retornado de P
 {
 	// http://www.nxp.com/documents/application_note/AN10833.pdf
 	// 3.2 Coding of Select Acknowledge (SAK)
-	// ignora 8 bits (iso14443 começa com LSBit = bit 1)
-	// corrige o tipo errado para o fabricante Infineon (http://nfc-tools.org/index.php?title=ISO14443A)
-	sak &= 0x7F;
-	switch (sak)
-	{
-	case 0x04:
-		return PICC_TYPE_NOT_COMPLETE; // UID não está completo
-	case 0x09:
-		return PICC_TYPE_MIFARE_MINI;
-	case 0x08:
-		return PICC_TYPE_MIFARE_1K;
-	case 0x18:
-		return PICC_TYPE_MIFARE_4K;
-	case 0x00:
-		return PICC_TYPE_MIFARE_UL;
-	case 0x10:
-	case 0x11:
-		return PICC_TYPE_MIFARE_PLUS;
-	case 0x01:
-		return PICC_TYPE_TNP3XXX;
-	case 0x20:
-		return PICC_TYPE_ISO_14443_4;
-	case 0x40:
-		return PICC_TYPE_ISO_18092;
-	default:
-		return PICC_TYPE_UNKNOWN;
-	}
+	// Sem o ATQA e o ATS, apenas o SAK é usado (veja MFRC522Identify.h)
+	return MFRC522Identify::GetDescriptor(MFRC522Identify::Identify(0, sak, NULL, 0)).tipo;
 } // Fim PICC_GetType()
 
-/**
- * Retorna um ponteiro __FlashStringHelper para o nome do tipo de PICC.
- *
- * @return const __FlashStringHelper *
- */
-const __FlashStringHelper *MFRC522::PICC_GetTypeName(PICC_Type piccType ///< Um dos enums PICC_Type.
-)
-{
-	switch (piccType)
-	{
-	case PICC_TYPE_ISO_14443_4:
-		return F("PICC compatível com ISO/IEC 14443-4");
-	case PICC_TYPE_ISO_18092:
-		return F("PICC compatível com ISO/IEC 18092 (NFC)");
-	case PICC_TYPE_MIFARE_MINI:
-		return F("MIFARE Mini, 320 bytes");
-	case PICC_TYPE_MIFARE_1K:
-		return F("MIFARE 1KB");
-	case PICC_TYPE_MIFARE_4K:
-		return F("MIFARE 4KB");
-	case PICC_TYPE_MIFARE_UL:
-		return F("MIFARE Ultralight ou Ultralight C");
-	case PICC_TYPE_MIFARE_PLUS:
-		return F("MIFARE Plus");
-	case PICC_TYPE_MIFARE_DESFIRE:
-		return F("MIFARE DESFire");
-	case PICC_TYPE_TNP3XXX:
-		return F("MIFARE TNP3XXX");
-	case PICC_TYPE_NOT_COMPLETE:
-		return F("SAK indica que o UID não está completo.");
-	case PICC_TYPE_UNKNOWN:
-	default:
-		return F("Tipo desconhecido");
-	}
-} // Fim PICC_GetTypeName()
-
 /**
  * Exibe informações de depuração sobre o PCD conectado no Serial.
  * Mostra todas as versões de firmware conhecidas.
@@ -1495,6 +2010,7 @@ void MFRC522::PICC_DumpToSerial(Uid *uid ///< Ponteiro para a estrutura Uid reto
 	{
 	case PICC_TYPE_MIFARE_MINI:
 	case PICC_TYPE_MIFARE_1K:
+	case PICC_TYPE_MIFARE_2K:
 	case PICC_TYPE_MIFARE_4K:
 		// Todas as chaves são definidas como FFFFFFFFFFFFh na entrega do chip de fábrica.
 		for (byte i = 0; i < 6; i++)
@@ -1565,39 +2081,14 @@ void MFRC522::PICC_DumpMifareClassicToSerial(Uid *uid,			 ///< Ponteiro para a e
 											 MIFARE_Key *key	 ///< Chave A usada para todos os setores.
 )
 {
-	byte no_of_sectors = 0;
-	switch (piccType)
+	if (!MifareClassicSectorCount(piccType)) // 0 se não for MIFARE Classic
 	{
-	case PICC_TYPE_MIFARE_MINI:
-		// Possui 5 setores * 4 blocos/setor * 16 bytes/bloco = 320 bytes.
-		no_of_sectors = 5;
-		break;
-
-	case PICC_TYPE_MIFARE_1K:
-		// Possui 16 setores * 4 blocos/setor * 16 bytes/bloco = 1024 bytes.
-		no_of_sectors = 16;
-		break;
-
-	case PICC_TYPE_MIFARE_4K:
-		// Possui (32 setores * 4 blocos/setor + 8 setores * 16 blocos/setor) * 16 bytes/bloco = 4096 bytes.
-		no_of_sectors = 40;
-		break;
-
-	default: // Não deveria acontecer. Ignorar.
-		break;
+		return;
 	}
-
+	MFRC522DumpText texto(Serial);
+	texto.Begin(uid, 0, piccType, 16);
 	// Exibe setores, começando pelo endereço mais alto.
-	if (no_of_sectors)
-	{
-		Serial.println(F("Setor Bloco   0  1  2  3   4  5  6  7   8  9 10 11  12 13 14 15  Bits de Acesso"));
-		for (int8_t i = no_of_sectors - 1; i >= 0; i--)
-		{
-			PICC_DumpMifareClassicSectorToSerial(uid, key, i);
-		}
-	}
-	PICC_HaltA(); // Interrompe o PICC antes de encerrar a sessão criptografada.
-	PCD_StopCrypto1();
+	MFRC522DumpReader(*this).ReadMifareClassic(uid, piccType, key, texto, true);
 } // Fim PICC_DumpMifareClassicToSerial()
 
 /**
@@ -1615,234 +2106,331 @@ void MFRC522::PICC_DumpMifareClassicSectorToSerial(Uid *uid,		///< Ponteiro para
 												   byte setor		///< O setor a ser exibido, 0..39.
 )
 {
-	MFRC522::StatusCode status;
-	byte primeiroBloco;	 // Endereço do bloco mais baixo a ser exibido (na verdade, o último bloco exibido).
-	byte numeroDeBlocos; // Número de blocos no setor
-	bool eSetorTrailer;	 // Define como true ao lidar com o "último" (ou seja, o endereço mais alto) no setor.
-
-	// Os bits de acesso são armazenados de forma peculiar.
-	// Existem quatro grupos:
-	// g[3]	Bits de acesso para o bloco 3 do trailer do setor (para setores 0-31) ou bloco 15 (para setores 32-39)
-	// g[2]	Bits de acesso para o bloco 2 (para setores 0-31) ou blocos 10-14 (para setores 32-39)
-	// g[1]	Bits de acesso para o bloco 1 (para setores 0-31) ou blocos 5-9 (para setores 32-39)
-	// g[0]	Bits de acesso para o bloco 0 (para setores 0-31) ou blocos 0-4 (para setores 32-39)
-	// Cada grupo possui bits de acesso [C1 C2 C3]. Neste código, C1 é o bit mais significativo e C3 é o menos significativo.
-	// Os quatro bits CX são armazenados juntos em um nibble cx e em um nibble cx_ invertido.
-	byte c1, c2, c3;	  // Nibbles
-	byte c1_, c2_, c3_;	  // Nibbles invertidos
-	bool erroInvertido;	  // True se um dos nibbles invertidos não corresponder
-	byte g[4];			  // Bits de acesso para cada um dos quatro grupos.
-	byte grupo;			  // 0-3 - grupo ativo para bits de acesso
-	bool primeiroNoGrupo; // True para o primeiro bloco exibido no grupo
-
-	// Determine a posição e o tamanho do setor.
-	if (setor < 32)
-	{ // Setores 0..31 têm 4 blocos cada
-		numeroDeBlocos = 4;
-		primeiroBloco = setor * numeroDeBlocos;
-	}
-	else if (setor < 40)
-	{ // Setores 32-39 têm 16 blocos cada
-		numeroDeBlocos = 16;
-		primeiroBloco = 128 + (setor - 32) * numeroDeBlocos;
+	// Exibe blocos, começando pelo endereço mais alto.
+	MFRC522DumpText texto(Serial);
+	MFRC522DumpReader(*this).ReadMifareClassicSector(uid, key, setor, texto, true);
+} // Fim PICC_DumpMifareClassicSectorToSerial()
+
+/**
+ * Exibe o conteúdo da memória de um PICC MIFARE Ultralight.
+ */
+void MFRC522::PICC_DumpMifareUltralightToSerial()
+{
+	MFRC522DumpText texto(Serial);
+	texto.Begin(&uid, 0, PICC_TYPE_MIFARE_UL, 4);
+	MFRC522DumpReader(*this).ReadMifareUltralight(texto);
+} // Fim PICC_DumpMifareUltralightToSerial()
+
+/**
+ * Calcula o padrão de bits necessário para os bits de acesso especificados. Nas tuplas [C1 C2 C3], C1 é o MSB (=4) e C3 é o LSB (=1).
+ */
+void MFRC522::MIFARE_SetAccessBits(byte *accessBitBuffer, ///< Ponteiro para o byte 6, 7 e 8 no trailer do setor. Bytes [0..2] serão definidos.
+								   byte g0,				  ///< Bits de acesso [C1 C2 C3] para o bloco 0 (para setores 0-31) ou blocos 0-4 (para setores 32-39)
+								   byte g1,				  ///< Bits de acesso [C1 C2 C3] para o bloco 1 (para setores 0-31) ou blocos 5-9 (para setores 32-39)
+								   byte g2,				  ///< Bits de acesso [C1 C2 C3] para o bloco 2 (para setores 0-31) ou blocos 10-14 (para setores 32-39)
+								   byte g3				  ///< Bits de acesso [C1 C2 C3] para o trailer do setor, bloco 3 (para setores 0-31) ou bloco 15 (para setores 32-39)
+)
+{
+	byte c1 = ((g3 & 4) << 1) | ((g2 & 4) << 0) | ((g1 & 4) >> 1) | ((g0 & 4) >> 2);
+	byte c2 = ((g3 & 2) << 2) | ((g2 & 2) << 1) | ((g1 & 2) << 0) | ((g0 & 2) >> 1);
+	byte c3 = ((g3 & 1) << 3) | ((g2 & 1) << 2) | ((g1 & 1) << 1) | ((g0 & 1) << 0);
+
+	accessBitBuffer[0] = (~c2 & 0xF) << 4 | (~c1 & 0xF);
+	accessBitBuffer[1] = c1 << 4 | (~c3 & 0xF);
+	accessBitBuffer[2] = c3 << 4 | c2;
+} // Fim MIFARE_SetAccessBits()
+
+/**
+ * Decodifica os bits de acesso de um trailer de setor. É o inverso de MIFARE_SetAccessBits().
+ *
+ * Os bits de acesso são armazenados de forma peculiar: os quatro bits CX (um por grupo) ficam juntos em um
+ * nibble cx e também em um nibble cx_ invertido. Nas tuplas [C1 C2 C3], C1 é o MSB (=4) e C3 é o LSB (=1).
+ *
+ * @return true se os nibbles invertidos conferem, false caso contrário (g é preenchido mesmo assim).
+ */
+bool MFRC522::MIFARE_GetAccessBits(const byte *accessBitBuffer, ///< Ponteiro para o byte 6, 7 e 8 no trailer do setor.
+								   byte *g						///< Recebe os bits de acesso [C1 C2 C3] dos grupos g0..g3, 4 bytes.
+)
+{
+	byte c1 = accessBitBuffer[1] >> 4;
+	byte c2 = accessBitBuffer[2] & 0xF;
+	byte c3 = accessBitBuffer[2] >> 4;
+	byte c1_ = accessBitBuffer[0] & 0xF;
+	byte c2_ = accessBitBuffer[0] >> 4;
+	byte c3_ = accessBitBuffer[1] & 0xF;
+	for (byte i = 0; i < 4; i++)
+	{
+		g[i] = (((c1 >> i) & 1) << 2) | (((c2 >> i) & 1) << 1) | ((c3 >> i) & 1);
 	}
-	else
-	{ // Entrada ilegal, nenhum PICC MIFARE Classic tem mais de 40 setores.
-		return;
+	return (c1 == (~c1_ & 0xF)) && (c2 == (~c2_ & 0xF)) && (c3 == (~c3_ & 0xF));
+} // Fim MIFARE_GetAccessBits()
+
+/**
+ * Compara um bloco desejado com o conteúdo atual. Para um trailer são comparados os bytes 6-9, a chave usada na
+ * autenticação e a outra chave. A outra chave só pode ser conhecida quando é a Chave B e os bits de acesso (g3)
+ * permitem lê-la; caso contrário o trailer é tratado como alterado, para nunca deixar de escrever uma chave nova.
+ */
+static bool BlocoDifere(const byte *desejado,		  ///< Bloco desejado, 16 bytes.
+						const byte *atual,			  ///< Bloco atual, 16 bytes, lido do cartão ou em cache.
+						bool trailer,				  ///< true se o bloco for o trailer do setor.
+						byte g3,					  ///< Bits de acesso atuais do trailer, ou 0xFF se desconhecidos.
+						const MFRC522::MIFARE_Key *chave, ///< Chave usada na autenticação.
+						bool chaveB					  ///< true se a autenticação usa a Chave B.
+)
+{
+	if (!trailer)
+	{
+		return memcmp(desejado, atual, 16) != 0;
+	}
+	if (memcmp(&desejado[6], &atual[6], 4) != 0)
+	{ // Bits de acesso e byte GPB
+		return true;
+	}
+	if (memcmp(&desejado[chaveB ? 10 : 0], chave->keyByte, MFRC522::MF_KEY_SIZE) != 0)
+	{ // A chave usada na autenticação é a chave atual
+		return true;
 	}
+	if (chaveB || g3 == 0xFF || !MifareClassicGeometry::TrailerAllows(g3, MifareClassicGeometry::TRAILER_READ_KEY_B, false))
+	{ // A Chave A nunca pode ser lida; a Chave B só quando os bits de acesso permitem
+		return true;
+	}
+	return memcmp(&desejado[10], &atual[10], MFRC522::MF_KEY_SIZE) != 0;
+} // Fim BlocoDifere()
 
-	// Exibe blocos, começando pelo endereço mais alto.
-	byte contadorDeBytes;
+/**
+ * Escreve em um PICC MIFARE Classic apenas os blocos que diferem entre a imagem desejada e a imagem atual.
+ *
+ * As imagens cobrem numeroDeBlocos blocos consecutivos a partir de primeiroBloco, 16 bytes por bloco.
+ * Os blocos alterados são agrupados por setor: cada setor com alterações é autenticado uma única vez e
+ * seus blocos são escritos em ordem crescente, de modo que o trailer do setor (se alterado) é sempre o
+ * último, e novos bits de acesso não bloqueiam as escritas restantes do mesmo setor.
+ * Cada escrita já é confirmada com ACK pelo PICC; além disso, cada bloco de dados escrito é lido de volta e
+ * conferido, ainda dentro da mesma autenticação (exceto os blocos que os bits de acesso conhecidos tornam ilegíveis
+ * para a chave usada). As leituras são feitas antes da escrita do trailer, cujos novos
+ * bits de acesso poderiam negá-las. O trailer não é verificado, pois a Chave A sempre é lida como zeros.
+ * O bloco 0 (dados do fabricante) nunca é escrito.
+ *
+ * Um trailer lido do cartão não revela as chaves. Ele é considerado alterado se diferir nos bytes 6-9 (bits de
+ * acesso e byte GPB) ou na chave usada para a autenticação (que é a chave atual). A outra chave só é comparada
+ * quando é a Chave B e os bits de acesso permitem lê-la; se ela não puder ser conhecida, o trailer é sempre
+ * escrito (ou a função retorna STATUS_INVALID se os bits de acesso não permitirem a escrita), para que uma
+ * chave nova nunca seja dada como gravada sem ter sido escrita.
+ *
+ * Se atual for nullptr, o conteúdo de cada bloco é lido do cartão (na mesma autenticação) antes da comparação.
+ * Caso contrário, atual é atualizado com os blocos escritos, mantendo a imagem em cache sincronizada com o cartão.
+ *
+ * Quando o trailer de um setor faz parte da imagem, seus bits de acesso atuais são conferidos no MCU
+ * antes de qualquer escrita naquele setor; uma escrita não permitida para a chave usada retorna STATUS_INVALID
+ * sem enviar comandos ao PICC.
+ *
+ * Lembre-se de chamar PICC_HaltA() e PCD_StopCrypto1() ao terminar a comunicação com o PICC.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522::MIFARE_WriteDiff(Uid *uid,				 ///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+											  byte comando,			 ///< PICC_CMD_MF_AUTH_KEY_A ou PICC_CMD_MF_AUTH_KEY_B
+											  MIFARE_Key *chave,	 ///< Chave usada para todos os setores alcançados pela imagem.
+											  byte primeiroBloco,	 ///< Endereço do primeiro bloco coberto pelas imagens.
+											  byte numeroDeBlocos,	 ///< Número de blocos cobertos pelas imagens.
+											  byte *desejado,		 ///< Imagem desejada, numeroDeBlocos * 16 bytes.
+											  byte *atual,			 ///< Imagem atual (em cache ou recém-lida), numeroDeBlocos * 16 bytes, ou nullptr.
+											  byte *blocosEscritos	 ///< Se não for nullptr, recebe o número de blocos escritos.
+)
+{
+	MFRC522::StatusCode resultado;
 	byte buffer[18];
-	byte enderecoDoBloco;
-	eSetorTrailer = true;
-	erroInvertido = false; // Evita o aviso de "variável não usada".
-	for (int8_t deslocamentoDoBloco = numeroDeBlocos - 1; deslocamentoDoBloco >= 0; deslocamentoDoBloco--)
-	{
-		enderecoDoBloco = primeiroBloco + deslocamentoDoBloco;
-		// Número do setor - apenas na primeira linha
-		if (eSetorTrailer)
-		{
-			if (setor < 10)
-				Serial.print(F("   ")); // Preenche com espaços
-			else
-				Serial.print(F("  ")); // Preenche com espaços
-			Serial.print(setor);
-			Serial.print(F("   "));
-		}
-		else
+	byte tamanho;
+
+	// Verificação de sanidade
+	if (desejado == nullptr || numeroDeBlocos == 0 || (uint16_t)primeiroBloco + numeroDeBlocos > 256)
+	{
+		return STATUS_INVALID;
+	}
+	if (blocosEscritos)
+	{
+		*blocosEscritos = 0;
+	}
+
+	const uint16_t fim = (uint16_t)primeiroBloco + numeroDeBlocos; // Primeiro bloco fora das imagens
+	uint16_t bloco = primeiroBloco;
+	while (bloco < fim)
+	{
+		// Determine a posição e o tamanho do setor que contém o bloco.
+		const byte setor = MifareClassicGeometry::SectorOf((byte)bloco);
+		const uint16_t inicioSetor = MifareClassicGeometry::FirstBlock(setor);
+		const uint16_t trailer = MifareClassicGeometry::TrailerBlock(setor);
+		uint16_t fimTrecho = trailer + 1;
+		if (fimTrecho > fim)
 		{
-			Serial.print(F("       "));
+			fimTrecho = fim;
 		}
-		// Número do bloco
-		if (enderecoDoBloco < 10)
-			Serial.print(F("   ")); // Preenche com espaços
-		else
+
+		// Marca os blocos alterados deste setor em um mapa de bits (no máximo 16 blocos por setor).
+		uint16_t alterados = 0;
+		bool autenticado = false;
+		bool acessoConhecido = false; // true se os bits de acesso atuais do setor estão na imagem atual ou foram lidos
+		byte g[4];
+		if (atual && trailer < fim)
 		{
-			if (enderecoDoBloco < 100)
-				Serial.print(F("  ")); // Preenche com espaços
-			else
-				Serial.print(F(" ")); // Preenche com espaços
+			acessoConhecido = MIFARE_GetAccessBits(&atual[(trailer - primeiroBloco) * 16 + 6], g);
 		}
-		Serial.print(enderecoDoBloco);
-		Serial.print(F("  "));
-		// Estabelece comunicação criptografada antes de ler o primeiro bloco
-		if (eSetorTrailer)
+		for (uint16_t b = bloco; b < fimTrecho; b++)
 		{
-			status = PCD_Authenticate(PICC_CMD_MF_AUTH_KEY_A, primeiroBloco, key, uid);
-			if (status != STATUS_OK)
+			if (b == 0)
+			{ // Bloco do fabricante, somente leitura
+				continue;
+			}
+			const byte *alvo = &desejado[(b - primeiroBloco) * 16];
+			if (atual)
 			{
-				Serial.print(F("PCD_Authenticate() falhou: "));
-				Serial.println(GetStatusCodeName(status));
-				return;
+				if (!BlocoDifere(alvo, &atual[(b - primeiroBloco) * 16], b == trailer, acessoConhecido ? g[3] : 0xFF, chave, comando == PICC_CMD_MF_AUTH_KEY_B))
+				{
+					continue;
+				}
 			}
-		}
-		// Lê o bloco
-		contadorDeBytes = sizeof(buffer);
-		status = MIFARE_Read(enderecoDoBloco, buffer, &contadorDeBytes);
-		if (status != STATUS_OK)
-		{
-			Serial.print(F("MIFARE_Read() falhou: "));
-			Serial.println(GetStatusCodeName(status));
-			continue;
-		}
-		// Exibe os dados
-		for (byte indice = 0; indice < 16; indice++)
-		{
-			if (buffer[indice] < 0x10)
-				Serial.print(F(" 0"));
 			else
-				Serial.print(F(" "));
-			Serial.print(buffer[indice], HEX);
-			if ((indice % 4) == 3)
 			{
-				Serial.print(F(" "));
+				if (!autenticado)
+				{
+					resultado = PCD_Authenticate(comando, (byte)b, chave, uid);
+					if (resultado != STATUS_OK)
+					{
+						return resultado;
+					}
+					autenticado = true;
+				}
+				tamanho = sizeof(buffer);
+				resultado = MIFARE_Read((byte)b, buffer, &tamanho);
+				if (resultado != STATUS_OK)
+				{
+					return resultado;
+				}
+				if (b == trailer)
+				{
+					acessoConhecido = MIFARE_GetAccessBits(&buffer[6], g);
+				}
+				if (!BlocoDifere(alvo, buffer, b == trailer, acessoConhecido ? g[3] : 0xFF, chave, comando == PICC_CMD_MF_AUTH_KEY_B))
+				{
+					continue;
+				}
 			}
-		}
-		// Analisa os dados do trailer do setor
-		if (eSetorTrailer)
-		{
-			c1 = buffer[7] >> 4;
-			c2 = buffer[8] & 0xF;
-			c3 = buffer[8] >> 4;
-			c1_ = buffer[6] & 0xF;
-			c2_ = buffer[6] >> 4;
-			c3_ = buffer[7] & 0xF;
-			erroInvertido = (c1 != (~c1_ & 0xF)) || (c2 != (~c2_ & 0xF)) || (c3 != (~c3_ & 0xF));
-			g[0] = ((c1 & 1) << 2) | ((c2 & 1) << 1) | ((c3 & 1) << 0);
-			g[1] = ((c1 & 2) << 1) | ((c2 & 2) << 0) | ((c3 & 2) >> 1);
-			g[2] = ((c1 & 4) << 0) | ((c2 & 4) >> 1) | ((c3 & 4) >> 2);
-			g[3] = ((c1 & 8) >> 1) | ((c2 & 8) >> 2) | ((c3 & 8) >> 3);
-			eSetorTrailer = false;
+			alterados |= (1u << (b - inicioSetor));
 		}
 
-		// Em qual grupo de acesso está este bloco?
-		if (numeroDeBlocos == 4)
+		// Com os bits de acesso atuais conhecidos, uma escrita não permitida é recusada aqui, antes de
+		// enviar um comando que terminaria em NAK e exigiria selecionar e autenticar o PICC novamente.
+		if (alterados && acessoConhecido)
 		{
-			grupo = deslocamentoDoBloco;
-			primeiroNoGrupo = true;
-		}
-		else
-		{
-			grupo = deslocamentoDoBloco / 5;
-			primeiroNoGrupo = (grupo == 3) || (grupo != (deslocamentoDoBloco + 1) / 5);
+			const bool chaveB = (comando == PICC_CMD_MF_AUTH_KEY_B);
+			for (uint16_t b = bloco; b < fimTrecho; b++)
+			{
+				if (!(alterados & (1u << (b - inicioSetor))))
+				{
+					continue;
+				}
+				bool permitido;
+				if (b == trailer)
+				{
+					permitido = MifareClassicGeometry::TrailerAllows(g[3], MifareClassicGeometry::TRAILER_WRITE_KEYS, chaveB) ||
+								MifareClassicGeometry::TrailerAllows(g[3], MifareClassicGeometry::TRAILER_WRITE_ACCESS_BITS, chaveB);
+				}
+				else
+				{
+					permitido = MifareClassicGeometry::BlockAllows(g, (byte)b, MifareClassicGeometry::ACCESS_WRITE, chaveB);
+				}
+				if (!permitido)
+				{
+					return STATUS_INVALID;
+				}
+			}
 		}
 
-		if (primeiroNoGrupo)
+		if (alterados)
 		{
-			// Exibe bits de acesso
-			Serial.print(F(" [ "));
-			Serial.print((g[grupo] >> 2) & 1, DEC);
-			Serial.print(F(" "));
-			Serial.print((g[grupo] >> 1) & 1, DEC);
-			Serial.print(F(" "));
-			Serial.print((g[grupo] >> 0) & 1, DEC);
-			Serial.print(F(" ] "));
-			if (erroInvertido)
+			// Uma única autenticação por setor alterado
+			if (!autenticado)
 			{
-				Serial.print(F(" Bits de acesso invertidos não coincidem! "));
+				resultado = PCD_Authenticate(comando, (byte)bloco, chave, uid);
+				if (resultado != STATUS_OK)
+				{
+					return resultado;
+				}
 			}
-		}
 
-		if (grupo != 3 && (g[grupo] == 1 || g[grupo] == 6))
-		{ // Não é um trailer de setor, um bloco de valor
-			int32_t valor = (int32_t(buffer[3]) << 24) | (int32_t(buffer[2]) << 16) | (int32_t(buffer[1]) << 8) | int32_t(buffer[0]);
-			Serial.print(F(" Valor=0x"));
-			Serial.print(valor, HEX);
-			Serial.print(F(" End=0x"));
-			Serial.print(buffer[12], HEX);
-		}
-		Serial.println();
-	}
+			// Escreve os blocos de dados alterados, em ordem crescente.
+			for (uint16_t b = bloco; b < fimTrecho; b++)
+			{
+				if (!(alterados & (1u << (b - inicioSetor))) || b == trailer)
+				{
+					continue;
+				}
+				resultado = MIFARE_Write((byte)b, &desejado[(b - primeiroBloco) * 16], 16);
+				if (resultado != STATUS_OK)
+				{
+					return resultado;
+				}
+				if (blocosEscritos)
+				{
+					(*blocosEscritos)++;
+				}
+			}
 
-	return;
-} // Fim PICC_DumpMifareClassicSectorToSerial()
+			// Confere cada bloco de dados escrito, antes do trailer: novos bits de acesso podem negar a leitura.
+			// Blocos que os bits de acesso atuais tornam ilegíveis para esta chave não podem ser conferidos.
+			for (uint16_t b = bloco; b < fimTrecho; b++)
+			{
+				if (!(alterados & (1u << (b - inicioSetor))) || b == trailer)
+				{
+					continue;
+				}
+				if (acessoConhecido && !MifareClassicGeometry::BlockAllows(g, (byte)b, MifareClassicGeometry::ACCESS_READ, comando == PICC_CMD_MF_AUTH_KEY_B))
+				{
+					continue;
+				}
+				tamanho = sizeof(buffer);
+				resultado = MIFARE_Read((byte)b, buffer, &tamanho);
+				if (resultado != STATUS_OK)
+				{
+					return resultado;
+				}
+				if (memcmp(buffer, &desejado[(b - primeiroBloco) * 16], 16) != 0)
+				{
+					return STATUS_ERROR;
+				}
+			}
 
-/**
- * Exibe o conteúdo da memória de um PICC MIFARE Ultralight.
- */
-void MFRC522::PICC_DumpMifareUltralightToSerial()
-{
-	MFRC522::StatusCode status;
-	byte contadorDeBytes;
-	byte buffer[18];
-	byte i;
-
-	Serial.println(F("Página  0  1  2  3"));
-	// Tenta as páginas do Ultralight original. O Ultralight C tem mais páginas.
-	for (byte pagina = 0; pagina < 16; pagina += 4)
-	{ // A leitura retorna dados para 4 páginas de cada vez.
-		// Lê as páginas
-		contadorDeBytes = sizeof(buffer);
-		status = MIFARE_Read(pagina, buffer, &contadorDeBytes);
-		if (status != STATUS_OK)
-		{
-			Serial.print(F("MIFARE_Read() falhou: "));
-			Serial.println(GetStatusCodeName(status));
-			break;
-		}
-		// Exibe os dados
-		for (byte deslocamento = 0; deslocamento < 4; deslocamento++)
-		{
-			i = pagina + deslocamento;
-			if (i < 10)
-				Serial.print(F("  ")); // Preenche com espaços
-			else
-				Serial.print(F(" ")); // Preenche com espaços
-			Serial.print(i);
-			Serial.print(F("  "));
-			for (byte indice = 0; indice < 4; indice++)
+			// O trailer é sempre o último bloco escrito do setor.
+			if (trailer < fimTrecho && (alterados & (1u << (trailer - inicioSetor))))
 			{
-				i = 4 * deslocamento + indice;
-				if (buffer[i] < 0x10)
-					Serial.print(F(" 0"));
-				else
-					Serial.print(F(" "));
-				Serial.print(buffer[i], HEX);
+				resultado = MIFARE_Write((byte)trailer, &desejado[(trailer - primeiroBloco) * 16], 16);
+				if (resultado != STATUS_OK)
+				{
+					return resultado;
+				}
+				if (blocosEscritos)
+				{
+					(*blocosEscritos)++;
+				}
+			}
+
+			// Mantém a imagem atual sincronizada com o cartão
+			if (atual)
+			{
+				for (uint16_t b = bloco; b < fimTrecho; b++)
+				{
+					if (alterados & (1u << (b - inicioSetor)))
+					{
+						memcpy(&atual[(b - primeiroBloco) * 16], &desejado[(b - primeiroBloco) * 16], 16);
+					}
+				}
 			}
-			Serial.println();
 		}
-	}
-} // Fim PICC_DumpMifareUltralightToSerial()
 
-/**
- * Calcula o padrão de bits necessário para os bits de acesso especificados. Nas tuplas [C1 C2 C3], C1 é o MSB (=4) e C3 é o LSB (=1).
- */
-void MFRC522::MIFARE_SetAccessBits(byte *accessBitBuffer, ///< Ponteiro para o byte 6, 7 e 8 no trailer do setor. Bytes [0..2] serão definidos.
-								   byte g0,				  ///< Bits de acesso [C1 C2 C3] para o bloco 0 (para setores 0-31) ou blocos 0-4 (para setores 32-39)
-								   byte g1,				  ///< Bits de acesso [C1 C2 C3] para o bloco 1 (para setores 0-31) ou blocos 5-9 (para setores 32-39)
-								   byte g2,				  ///< Bits de acesso [C1 C2 C3] para o bloco 2 (para setores 0-31) ou blocos 10-14 (para setores 32-39)
-								   byte g3				  ///< Bits de acesso [C1 C2 C3] para o trailer do setor, bloco 3 (para setores 0-31) ou bloco 15 (para setores 32-39)
-)
-{
-	byte c1 = ((g3 & 4) << 1) | ((g2 & 4) << 0) | ((g1 & 4) >> 1) | ((g0 & 4) >> 2);
-	byte c2 = ((g3 & 2) << 2) | ((g2 & 2) << 1) | ((g1 & 2) << 0) | ((g0 & 2) >> 1);
-	byte c3 = ((g3 & 1) << 3) | ((g2 & 1) << 2) | ((g1 & 1) << 1) | ((g0 & 1) << 0);
+		bloco = fimTrecho;
+	}
 
-	accessBitBuffer[0] = (~c2 & 0xF) << 4 | (~c1 & 0xF);
-	accessBitBuffer[1] = c1 << 4 | (~c3 & 0xF);
-	accessBitBuffer[2] = c3 << 4 | c2;
-} // Fim MIFARE_SetAccessBits()
+	return STATUS_OK;
+} // Fim MIFARE_WriteDiff()
 
 /**
  * Executa a "sequência mágica" necessária para permitir a gravação no setor 0 de cartões Mifare com UID chinês modificável.
@@ -1875,9 +2463,7 @@ bool MFRC522::MIFARE_OpenUidBackdoor(bool registrarErros)
 	{
 		if (registrarErros)
 		{
-			Serial.println(F("O cartão não respondeu ao comando 0x40 após o comando HALT. Você tem certeza de que é um cartão com UID modificável?"));
-			Serial.print(F("Nome do erro: "));
-			Serial.println(GetStatusCodeName(status));
+			MFRC522_LOG_ERROR_STATUS("O cartão não respondeu ao comando 0x40 após o comando HALT. Você tem certeza de que é um cartão com UID modificável? Nome do erro: ", status);
 		}
 		return false;
 	}
@@ -1885,11 +2471,7 @@ bool MFRC522::MIFARE_OpenUidBackdoor(bool registrarErros)
 	{
 		if (registrarErros)
 		{
-			Serial.print(F("Recebeu uma resposta ruim no comando 0x40 de backdoor: "));
-			Serial.print(response[0], HEX);
-			Serial.print(F(" ("));
-			Serial.print(validBits);
-			Serial.print(F(" bits válidos)\r\n"));
+			MFRC522_LOG_ERROR_HEX("Recebeu uma resposta ruim no comando 0x40 de backdoor: ", response[0]);
 		}
 		return false;
 	}
@@ -1901,9 +2483,7 @@ bool MFRC522::MIFARE_OpenUidBackdoor(bool registrarErros)
 	{
 		if (registrarErros)
 		{
-			Serial.println(F("Erro na comunicação no comando 0x43, após a execução bem-sucedida do comando 0x40"));
-			Serial.print(F("Nome do erro: "));
-			Serial.println(GetStatusCodeName(status));
+			MFRC522_LOG_ERROR_STATUS("Erro na comunicação no comando 0x43, após a execução bem-sucedida do comando 0x40 Nome do erro: ", status);
 		}
 		return false;
 	}
@@ -1911,11 +2491,7 @@ bool MFRC522::MIFARE_OpenUidBackdoor(bool registrarErros)
 	{
 		if (registrarErros)
 		{
-			Serial.print(F("Recebeu uma resposta ruim no comando 0x43 de backdoor: "));
-			Serial.print(response[0], HEX);
-			Serial.print(F(" ("));
-			Serial.print(validBits);
-			Serial.print(F(" bits válidos)\r\n"));
+			MFRC522_LOG_ERROR_HEX("Recebeu uma resposta ruim no comando 0x43 de backdoor: ", response[0]);
 		}
 		return false;
 	}
@@ -1939,7 +2515,7 @@ bool MFRC522::MIFARE_SetUid(byte *novoUid, byte tamanhoUid, bool registrarErros)
 	{
 		if (registrarErros)
 		{
-			Serial.println(F("Buffer de novo UID vazio, tamanho 0 ou tamanho > 15 fornecido"));
+			MFRC522_LOG_ERROR_MSG("Buffer de novo UID vazio, tamanho 0 ou tamanho > 15 fornecido");
 		}
 		return false;
 	}
@@ -1961,7 +2537,10 @@ bool MFRC522::MIFARE_SetUid(byte *novoUid, byte tamanhoUid, bool registrarErros)
 
 			if (!PICC_IsNewCardPresent() || !PICC_ReadCardSerial())
 			{
-				Serial.println(F("Nenhum cartão foi selecionado anteriormente e nenhum está disponível. Falha ao definir o UID."));
+				if (registrarErros)
+				{
+					MFRC522_LOG_ERROR_MSG("Nenhum cartão foi selecionado anteriormente e nenhum está disponível. Falha ao definir o UID.");
+				}
 				return false;
 			}
 
@@ -1971,8 +2550,7 @@ bool MFRC522::MIFARE_SetUid(byte *novoUid, byte tamanhoUid, bool registrarErros)
 				// Tentamos, hora de desistir
 				if (registrarErros)
 				{
-					Serial.println(F("Falha na autenticação do cartão para leitura, não foi possível definir o UID: "));
-					Serial.println(GetStatusCodeName(status));
+					MFRC522_LOG_ERROR_STATUS("Falha na autenticação do cartão para leitura, não foi possível definir o UID: ", status);
 				}
 				return false;
 			}
@@ -1981,8 +2559,7 @@ bool MFRC522::MIFARE_SetUid(byte *novoUid, byte tamanhoUid, bool registrarErros)
 		{
 			if (registrarErros)
 			{
-				Serial.print(F("PCD_Authenticate() falhou: "));
-				Serial.println(GetStatusCodeName(status));
+				MFRC522_LOG_ERROR_STATUS("PCD_Authenticate() falhou: ", status);
 			}
 			return false;
 		}
@@ -1996,9 +2573,8 @@ bool MFRC522::MIFARE_SetUid(byte *novoUid, byte tamanhoUid, bool registrarErros)
 	{
 		if (registrarErros)
 		{
-			Serial.print(F("MIFARE_Read() falhou: "));
-			Serial.println(GetStatusCodeName(status));
-			Serial.println(F("Você tem certeza de que seu KEY A para o setor 0 é 0xFFFFFFFFFFFF?"));
+			MFRC522_LOG_ERROR_STATUS("MIFARE_Read() falhou: ", status);
+			MFRC522_LOG_ERROR_MSG("Você tem certeza de que seu KEY A para o setor 0 é 0xFFFFFFFFFFFF?");
 		}
 		return false;
 	}
@@ -2022,7 +2598,7 @@ bool MFRC522::MIFARE_SetUid(byte *novoUid, byte tamanhoUid, bool registrarErros)
 	{
 		if (registrarErros)
 		{
-			Serial.println(F("Ativar a porta de entrada do UID falhou."));
+			MFRC522_LOG_ERROR_MSG("Ativar a porta de entrada do UID falhou.");
 		}
 		return false;
 	}
@@ -2033,8 +2609,7 @@ bool MFRC522::MIFARE_SetUid(byte *novoUid, byte tamanhoUid, bool registrarErros)
 	{
 		if (registrarErros)
 		{
-			Serial.print(F("MIFARE_Write() falhou: "));
-			Serial.println(GetStatusCodeName(status));
+			MFRC522_LOG_ERROR_STATUS("MIFARE_Write() falhou: ", status);
 		}
 		return false;
 	}
@@ -2062,8 +2637,7 @@ bool MFRC522::MIFARE_UnbrickUidSector(bool registrarErros)
 	{
 		if (registrarErros)
 		{
-			Serial.print(F("MIFARE_Write() falhou: "));
-			Serial.println(GetStatusCodeName(status));
+			MFRC522_LOG_ERROR_STATUS("MIFARE_Write() falhou: ", status);
 		}
 		return false;
 	}
@@ -2080,25 +2654,24 @@ bool MFRC522::MIFARE_UnbrickUidSector(bool registrarErros)
  *
  * @return bool
  */
-bool MFRC522::PICC_EstaNovoCartaoPresente()
+bool MFRC522::PICC_IsNewCardPresent()
 {
 	byte bufferATQA[2];
 	byte tamanhoBuffer = sizeof(bufferATQA);
 
-	// Redefine as taxas de transmissão
-	PCD_EscreveRegistro(TxModeReg, 0x00);
-	PCD_EscreveRegistro(RxModeReg, 0x00);
-	// Redefine ModWidthReg
-	PCD_EscreveRegistro(ModWidthReg, 0x26);
-
-	MFRC522::StatusCode resultado = PICC_RequerA(bufferATQA, &tamanhoBuffer);
-	return (resultado == STATUS_OK || resultado == STATUS_COLISAO);
-} // Fim PICC_EstaNovoCartaoPresente()
+	PICC_StartRequestA();
+	MFRC522::StatusCode resultado;
+	while ((resultado = PICC_CheckRequestA(bufferATQA, &tamanhoBuffer)) == STATUS_PENDING)
+	{
+		yield();
+	}
+	return (resultado == STATUS_OK || resultado == STATUS_COLLISION);
+} // Fim PICC_IsNewCardPresent()
 
 /**
  * Invólucro simples ao redor de PICC_Select.
  * Retorna verdadeiro se um UID puder ser lido.
- * Lembre-se de chamar PICC_EstaNovoCartaoPresente(), PICC_RequerA() ou PICC_DespertarA() primeiro.
+ * Lembre-se de chamar PICC_IsNewCardPresent(), PICC_RequerA() ou PICC_DespertarA() primeiro.
  * O UID lido está disponível na variável de classe uid.
  *
  * @return bool
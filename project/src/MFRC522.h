@@ -22,58 +22,28 @@
 #define MFRC522_SPICLOCK (4000000u)	// MFRC522 accept upto 10MHz, set to 4MHz.
 #endif
 
-// Firmware data for self-test
-// Reference values based on firmware version
-// Hint: if needed, you can remove unused self-test data to save flash memory
-//
-// Version 0.0 (0x90)
-// Philips Semiconductors; Preliminary Specification Revision 2.0 - 01 August 2005; 16.1 self-test
-const byte MFRC522_firmware_referenceV0_0[] PROGMEM = {
-	0x00, 0x87, 0x98, 0x0f, 0x49, 0xFF, 0x07, 0x19,
-	0xBF, 0x22, 0x30, 0x49, 0x59, 0x63, 0xAD, 0xCA,
-	0x7F, 0xE3, 0x4E, 0x03, 0x5C, 0x4E, 0x49, 0x50,
-	0x47, 0x9A, 0x37, 0x61, 0xE7, 0xE2, 0xC6, 0x2E,
-	0x75, 0x5A, 0xED, 0x04, 0x3D, 0x02, 0x4B, 0x78,
-	0x32, 0xFF, 0x58, 0x3B, 0x7C, 0xE9, 0x00, 0x94,
-	0xB4, 0x4A, 0x59, 0x5B, 0xFD, 0xC9, 0x29, 0xDF,
-	0x35, 0x96, 0x98, 0x9E, 0x4F, 0x30, 0x32, 0x8D
-};
-// Version 1.0 (0x91)
-// NXP Semiconductors; Rev. 3.8 - 17 September 2014; 16.1.1 self-test
-const byte MFRC522_firmware_referenceV1_0[] PROGMEM = {
-	0x00, 0xC6, 0x37, 0xD5, 0x32, 0xB7, 0x57, 0x5C,
-	0xC2, 0xD8, 0x7C, 0x4D, 0xD9, 0x70, 0xC7, 0x73,
-	0x10, 0xE6, 0xD2, 0xAA, 0x5E, 0xA1, 0x3E, 0x5A,
-	0x14, 0xAF, 0x30, 0x61, 0xC9, 0x70, 0xDB, 0x2E,
-	0x64, 0x22, 0x72, 0xB5, 0xBD, 0x65, 0xF4, 0xEC,
-	0x22, 0xBC, 0xD3, 0x72, 0x35, 0xCD, 0xAA, 0x41,
-	0x1F, 0xA7, 0xF3, 0x53, 0x14, 0xDE, 0x7E, 0x02,
-	0xD9, 0x0F, 0xB5, 0x5E, 0x25, 0x1D, 0x29, 0x79
-};
-// Version 2.0 (0x92)
-// NXP Semiconductors; Rev. 3.8 - 17 September 2014; 16.1.1 self-test
-const byte MFRC522_firmware_referenceV2_0[] PROGMEM = {
-	0x00, 0xEB, 0x66, 0xBA, 0x57, 0xBF, 0x23, 0x95,
-	0xD0, 0xE3, 0x0D, 0x3D, 0x27, 0x89, 0x5C, 0xDE,
-	0x9D, 0x3B, 0xA7, 0x00, 0x21, 0x5B, 0x89, 0x82,
-	0x51, 0x3A, 0xEB, 0x02, 0x0C, 0xA5, 0x00, 0x49,
-	0x7C, 0x84, 0x4D, 0xB3, 0xCC, 0xD2, 0x1B, 0x81,
-	0x5D, 0x48, 0x76, 0xD5, 0x71, 0x61, 0x21, 0xA9,
-	0x86, 0x96, 0x83, 0x38, 0xCF, 0x9D, 0x5B, 0x6D,
-	0xDC, 0x15, 0xBA, 0x3E, 0x7D, 0x95, 0x3B, 0x2F
-};
-// Clone
-// Fudan Semiconductor FM17522 (0x88)
-const byte FM17522_firmware_reference[] PROGMEM = {
-	0x00, 0xD6, 0x78, 0x8C, 0xE2, 0xAA, 0x0C, 0x18,
-	0x2A, 0xB8, 0x7A, 0x7F, 0xD3, 0x6A, 0xCF, 0x0B,
-	0xB1, 0x37, 0x63, 0x4B, 0x69, 0xAE, 0x91, 0xC7,
-	0xC3, 0x97, 0xAE, 0x77, 0xF4, 0x37, 0xD7, 0x9B,
-	0x7C, 0xF5, 0x3C, 0x11, 0x8F, 0x15, 0xC3, 0xD7,
-	0xC1, 0x5B, 0x00, 0x2A, 0xD0, 0x75, 0xDE, 0x9E,
-	0x51, 0x64, 0xAB, 0x3E, 0xE9, 0x15, 0xB5, 0xAB,
-	0x56, 0x9A, 0x98, 0x82, 0x26, 0xEA, 0x2A, 0x62
-};
+// Firmware references for the self-test (PCD_PerformSelfTest(), compiled in MFRC522SelfTest.cpp)
+// Only a CRC32 of the 64-byte result expected from each firmware version is stored, 4 bytes instead of 64.
+// Set a version to 0 (e.g. -DMFRC522_SELFTEST_V0_0=0) to remove its reference; the self-test then fails on that chip.
+#ifndef MFRC522_SELFTEST_V0_0
+#define MFRC522_SELFTEST_V0_0 1		// Version 0.0 (0x90)
+#endif
+#ifndef MFRC522_SELFTEST_V1_0
+#define MFRC522_SELFTEST_V1_0 1		// Version 1.0 (0x91)
+#endif
+#ifndef MFRC522_SELFTEST_V2_0
+#define MFRC522_SELFTEST_V2_0 1		// Version 2.0 (0x92)
+#endif
+#ifndef MFRC522_SELFTEST_FM17522
+#define MFRC522_SELFTEST_FM17522 1	// Clone Fudan Semiconductor FM17522 (0x88)
+#endif
+
+// Strings returned by GetStatusCodeName() and PICC_GetTypeName() (compiled in MFRC522Names.cpp)
+#define MFRC522_NAMES_SHORT 0		// Enum names without prefix, e.g. "TIMEOUT" or "MIFARE_1K"
+#define MFRC522_NAMES_FULL 1		// Descriptive messages (default)
+#ifndef MFRC522_NAMES
+#define MFRC522_NAMES MFRC522_NAMES_FULL
+#endif
 
 class MFRC522 {
 public:
@@ -212,7 +182,10 @@ public:
 		PICC_CMD_MF_TRANSFER	= 0xB0,		// Writes the contents of the internal data register to a block.
 		// The commands used for MIFARE Ultralight (from http://www.nxp.com/documents/data_sheet/MF0ICU1.pdf, Section 8.6)
 		// The PICC_CMD_MF_READ and PICC_CMD_MF_WRITE can also be used for MIFARE Ultralight.
-		PICC_CMD_UL_WRITE		= 0xA2		// Writes one 4 byte page to the PICC.
+		PICC_CMD_UL_WRITE		= 0xA2,		// Writes one 4 byte page to the PICC.
+		// MIFARE Ultralight EV1 and NTAG21x (from https://www.nxp.com/docs/en/data-sheet/NTAG213_215_216.pdf, Section 10)
+		PICC_CMD_UL_FAST_READ	= 0x3A,		// Reads a range of pages in a single frame.
+		PICC_CMD_UL_PWD_AUTH	= 0x1B		// 32 bit password authentication, answered with the 2 byte PACK.
 	};
 	
 	// MIFARE constants that does not fit anywhere else
@@ -221,6 +194,15 @@ public:
 		MF_KEY_SIZE				= 6			// A Mifare Crypto1 key is 6 bytes.
 	};
 	
+	// Pages in the largest FAST_READ response that fits the FIFO together with its CRC_A (15 * 4 + 2 = 62 bytes).
+	static constexpr byte UL_FAST_READ_FIFO_PAGES = 15;
+	
+	// Timeouts of the MFRC522 timer, in microseconds. The timer runs with a 25us period (see PCD_Init()).
+	static constexpr uint32_t TIMEOUT_DEFAULT_US		= 25000;	// Default timeout, set by PCD_Init().
+	static constexpr uint32_t TIMEOUT_MF_PASSIVE_ACK_US	= 2000;		// Window for a NAK after part 2 of MIFARE Increment/Decrement/Restore, which is not acknowledged.
+	static constexpr uint32_t TIMEOUT_UL_WRITE_US		= 5000;		// MIFARE Ultralight/NTAG WRITE: ACK follows EEPROM programming (max 4.1ms).
+	static constexpr uint32_t TIMEOUT_HALT_US			= 1500;		// HLTA: any answer within 1ms is a NAK, silence is success.
+	
 	// PICC types we can detect. Remember to update PICC_GetTypeName() if you add more.
 	// last value set to 0xff, then compiler uses less ram, it seems some optimisations are triggered
 	enum PICC_Type : byte {
@@ -234,6 +216,7 @@ public:
 		PICC_TYPE_MIFARE_PLUS	,	// MIFARE Plus
 		PICC_TYPE_MIFARE_DESFIRE,	// MIFARE DESFire
 		PICC_TYPE_TNP3XXX		,	// Only mentioned in NXP AN 10833 MIFARE Type Identification Procedure
+		PICC_TYPE_MIFARE_2K		,	// MIFARE Classic protocol, 2KB
 		PICC_TYPE_NOT_COMPLETE	= 0xff	// SAK indicates UID is not complete.
 	};
 	
@@ -248,6 +231,7 @@ public:
 		STATUS_INTERNAL_ERROR	,	// Internal error in the code. Should not happen ;-)
 		STATUS_INVALID			,	// Invalid argument.
 		STATUS_CRC_WRONG		,	// The CRC_A does not match
+		STATUS_PENDING			,	// The command started by PCD_StartCommand() is still running.
 		STATUS_MIFARE_NACK		= 0xff	// A MIFARE PICC responded with NAK.
 	};
 	
@@ -263,6 +247,12 @@ public:
 		byte		keyByte[MF_KEY_SIZE];
 	} MIFARE_Key;
 	
+	// A struct used for passing one piece of a frame to PCD_TransceiveSegments()
+	typedef struct {
+		byte		*data;			// Bytes to send, or buffer for received bytes (nullptr to discard them).
+		byte		size;			// Bytes to send, or buffer size. Set to the number of bytes received on return.
+	} FifoSegment;
+	
 	// Member variables
 	Uid uid;								// Used by PICC_ReadCardSerial().
 	
@@ -282,7 +272,10 @@ public:
 	void PCD_ReadRegister(PCD_Register reg, byte count, byte *values, byte rxAlign = 0);
 	void PCD_SetRegisterBitMask(PCD_Register reg, byte mask);
 	void PCD_ClearRegisterBitMask(PCD_Register reg, byte mask);
+	void PCD_BeginBurst();
+	void PCD_EndBurst();
 	StatusCode PCD_CalculateCRC(byte *data, byte length, byte *result);
+	static void CalculateCRC_A(const byte *data, uint16_t length, byte *result);
 	
 	/////////////////////////////////////////////////////////////////////////////////////
 	// Functions for manipulating the MFRC522
@@ -296,6 +289,8 @@ public:
 	byte PCD_GetAntennaGain();
 	void PCD_SetAntennaGain(byte mask);
 	bool PCD_PerformSelfTest();
+	void PCD_SetTimeout(uint32_t timeoutUs);
+	uint32_t PCD_GetTimeout() const { return _timeoutUs; };
 	
 	/////////////////////////////////////////////////////////////////////////////////////
 	// Power control functions
@@ -308,9 +303,15 @@ public:
 	/////////////////////////////////////////////////////////////////////////////////////
 	StatusCode PCD_TransceiveData(byte *sendData, byte sendLen, byte *backData, byte *backLen, byte *validBits = nullptr, byte rxAlign = 0, bool checkCRC = false);
 	StatusCode PCD_CommunicateWithPICC(byte command, byte waitIRq, byte *sendData, byte sendLen, byte *backData = nullptr, byte *backLen = nullptr, byte *validBits = nullptr, byte rxAlign = 0, bool checkCRC = false);
+	void PCD_StartCommand(byte command, byte waitIRq, byte *sendData, byte sendLen, byte txLastBits = 0, byte rxAlign = 0);
+	StatusCode PCD_CheckCommand(byte *backData = nullptr, byte *backLen = nullptr, byte *validBits = nullptr, byte rxAlign = 0, bool checkCRC = false);
+	StatusCode PCD_TransceiveLong(byte *sendData, byte sendLen, byte *backData, uint16_t *backLen, bool checkCRC = true);
+	StatusCode PCD_TransceiveSegments(const FifoSegment *sendSegments, byte sendCount, FifoSegment *backSegments, byte backCount, byte *backLen, bool crcOnMcu);
 	StatusCode PICC_RequestA(byte *bufferATQA, byte *bufferSize);
 	StatusCode PICC_WakeupA(byte *bufferATQA, byte *bufferSize);
 	StatusCode PICC_REQA_or_WUPA(byte command, byte *bufferATQA, byte *bufferSize);
+	void PICC_StartRequestA();
+	StatusCode PICC_CheckRequestA(byte *bufferATQA, byte *bufferSize);
 	virtual StatusCode PICC_Select(Uid *uid, byte validBits = 0);
 	StatusCode PICC_HaltA();
 
@@ -322,13 +323,16 @@ public:
 	StatusCode MIFARE_Read(byte blockAddr, byte *buffer, byte *bufferSize);
 	StatusCode MIFARE_Write(byte blockAddr, byte *buffer, byte bufferSize);
 	StatusCode MIFARE_Ultralight_Write(byte page, byte *buffer, byte bufferSize);
+	StatusCode MIFARE_Ultralight_WritePages(byte startPage, const byte *data, uint16_t length, uint16_t *pagesWritten = nullptr);
+	StatusCode MIFARE_Ultralight_FastRead(byte startPage, byte endPage, byte *buffer, uint16_t *bufferSize, byte pagesPerFrame = 4 * UL_FAST_READ_FIFO_PAGES);
 	StatusCode MIFARE_Decrement(byte blockAddr, int32_t delta);
 	StatusCode MIFARE_Increment(byte blockAddr, int32_t delta);
 	StatusCode MIFARE_Restore(byte blockAddr);
 	StatusCode MIFARE_Transfer(byte blockAddr);
 	StatusCode MIFARE_GetValue(byte blockAddr, int32_t *value);
 	StatusCode MIFARE_SetValue(byte blockAddr, int32_t value);
-	StatusCode PCD_NTAG216_AUTH(byte *passWord, byte pACK[]);
+	static bool MIFARE_DecodeValueBlock(byte *buffer, int32_t *value, byte *valueAddr = nullptr);
+	StatusCode PCD_NTAG216_AUTH(const byte *passWord, byte pACK[]);
 	
 	/////////////////////////////////////////////////////////////////////////////////////
 	// Support functions
@@ -352,6 +356,8 @@ public:
 	
 	// Advanced functions for MIFARE
 	void MIFARE_SetAccessBits(byte *accessBitBuffer, byte g0, byte g1, byte g2, byte g3);
+	static bool MIFARE_GetAccessBits(const byte *accessBitBuffer, byte *g);
+	StatusCode MIFARE_WriteDiff(Uid *uid, byte authCommand, MIFARE_Key *key, byte firstBlock, byte blockCount, byte *desired, byte *current = nullptr, byte *blocksWritten = nullptr);
 	bool MIFARE_OpenUidBackdoor(bool logErrors);
 	bool MIFARE_SetUid(byte *newUid, byte uidSize, bool logErrors);
 	bool MIFARE_UnbrickUidSector(bool logErrors);
@@ -365,7 +371,12 @@ public:
 protected:
 	byte _chipSelectPin;		// Arduino pin connected to MFRC522's SPI slave select input (Pin 24, NSS, active low)
 	byte _resetPowerDownPin;	// Arduino pin connected to MFRC522's reset and power down input (Pin 6, NRSTPD, active low)
+	uint32_t _timeoutUs;		// Timeout currently programmed in the MFRC522 timer, see PCD_SetTimeout()
+	uint32_t _deadline;			// millis() after which the command started by PCD_StartCommand() is considered lost
+	byte _waitIRq;				// ComIrqReg bits that end the command started by PCD_StartCommand()
+	byte _burstDepth;			// Nesting of PCD_BeginBurst(); while non zero the SPI settings stay applied
 	StatusCode MIFARE_TwoStepHelper(byte command, byte blockAddr, int32_t data);
+	StatusCode PCD_ExchangeSegments(const FifoSegment *sendSegments, byte sendCount, FifoSegment *backSegments, byte backCount, byte *backLen, bool crcOnMcu);
 };
 
 #endif
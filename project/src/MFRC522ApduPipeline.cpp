@@ -0,0 +1,113 @@
+/*
+ * MFRC522ApduPipeline.cpp - Execução em lote de APDUs em PICCs ISO/IEC 14443-4.
+ * NOTA: Por favor, verifique também os comentários em MFRC522ApduPipeline.h
+ * Liberado para o domínio público.
+ */
+
+#include "MFRC522ApduPipeline.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Construtores
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Construtor.
+ */
+MFRC522ApduPipeline::MFRC522ApduPipeline(MFRC522Extended &leitor, ///< Instância MFRC522Extended usada para a comunicação.
+										 bool stopOnStatusWord	  ///< true para interromper o lote na primeira SW diferente de 9000.
+										 )
+	: _leitor(leitor)
+{
+	_pararEmSw = stopOnStatusWord;
+	_tempoTotalUs = 0;
+} // Fim do construtor
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções do lote
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Envia as APDUs em ordem, com o timer e o modo de CRC configurados uma vez para o lote.
+ * Os campos de saída de cada ComandoApdu executado são preenchidos; os das APDUs não executadas são zerados.
+ *
+ * Erro de transporte: o lote é interrompido e o status é retornado.
+ * SW diferente de 9000 com stopOnStatusWord: o lote é interrompido e STATUS_ERROR é retornado.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522ApduPipeline::Run(MFRC522Extended::InformacoesTag *tag, ///< PICC selecionado com PICC_Select().
+											 ComandoApdu *apdus,				  ///< APDUs a enviar.
+											 byte count,						  ///< Número de APDUs.
+											 byte *executed						  ///< Se não for nullptr, recebe o número de APDUs enviadas.
+)
+{
+	MFRC522::StatusCode resultado = MFRC522::STATUS_OK;
+	byte i;
+
+	for (i = 0; i < count; i++)
+	{
+		apdus[i].tamanhoResposta = 0;
+		apdus[i].sw = 0;
+		apdus[i].status = MFRC522::STATUS_INTERNAL_ERROR; // Não executada
+		apdus[i].latenciaUs = 0;
+	}
+	_tempoTotalUs = 0;
+
+	_leitor.TCL_BeginBatch(tag);
+	for (i = 0; i < count; i++)
+	{
+		resultado = Exchange(tag, &apdus[i]);
+		_tempoTotalUs += apdus[i].latenciaUs;
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			i++;
+			break;
+		}
+	}
+	_leitor.TCL_EndBatch();
+
+	if (executed)
+	{
+		*executed = i;
+	}
+	return resultado;
+} // Fim Run()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de suporte
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Envia uma APDU e preenche os campos de saída.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522ApduPipeline::Exchange(MFRC522Extended::InformacoesTag *tag, ///< PICC selecionado com PICC_Select().
+												  ComandoApdu *apdu						///< APDU a enviar.
+)
+{
+	byte *buffer = apdu->resposta ? apdu->resposta : _rascunho;
+	uint16_t tamanho = apdu->resposta ? apdu->capacidade : sizeof(_rascunho);
+
+	const uint32_t inicio = micros();
+	MFRC522::StatusCode resultado = _leitor.TCL_TransceiveLong(tag, apdu->comando, apdu->tamanhoComando, buffer, &tamanho);
+	apdu->latenciaUs = micros() - inicio;
+	apdu->status = resultado;
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+
+	apdu->tamanhoResposta = apdu->resposta ? tamanho : 0;
+	if (tamanho < 2)
+	{
+		apdu->status = MFRC522::STATUS_ERROR; // Resposta sem SW1 SW2
+		return apdu->status;
+	}
+	apdu->sw = ((uint16_t)buffer[tamanho - 2] << 8) | buffer[tamanho - 1];
+	if (_pararEmSw && apdu->sw != SW_SUCESSO)
+	{
+		return MFRC522::STATUS_ERROR;
+	}
+	return MFRC522::STATUS_OK;
+} // Fim Exchange()
@@ -0,0 +1,68 @@
+/**
+ * Execução em lote de APDUs em PICCs ISO/IEC 14443-4 (T=CL).
+ *
+ * Run() envia uma lista de APDUs de comando ao PICC, uma após a outra, com TCL_TransceiveLong(): o timer
+ * é programado com o FWT do PICC e o modo de CRC é lido apenas uma vez para o lote inteiro (veja
+ * TCL_BeginBatch()). Cada ComandoApdu tem seu próprio buffer de resposta e recebe o status de transporte,
+ * a palavra de status (SW1 SW2) e o tempo da troca em microssegundos.
+ *
+ * Um erro de transporte sempre interrompe o lote (a numeração de blocos pode ter se perdido). Com
+ * stopOnStatusWord, uma SW diferente de 9000 também interrompe o lote.
+ *
+ * Ex.: script de personalização
+ *   MFRC522ApduPipeline::ComandoApdu apdus[] = {
+ *     { selectAid, sizeof(selectAid), resposta, sizeof(resposta) },
+ *     { putData, sizeof(putData), NULL, 0 }, // Apenas a SW interessa
+ *   };
+ *   MFRC522ApduPipeline pipeline(mfrc522, true);
+ *   pipeline.Run(&mfrc522.tag, apdus, 2, &executadas);
+ */
+#ifndef MFRC522ApduPipeline_h
+#define MFRC522ApduPipeline_h
+
+#include <Arduino.h>
+#include "MFRC522Extended.h"
+
+class MFRC522ApduPipeline
+{
+public:
+	// Palavra de status de sucesso, ISO/IEC 7816-4
+	static constexpr uint16_t SW_SUCESSO = 0x9000;
+	// Sem buffer de resposta, a resposta vai para um rascunho interno e precisa caber nele
+	static constexpr byte TAMANHO_RASCUNHO = 16;
+
+	typedef struct
+	{
+		// Entrada
+		const byte *comando;	 // APDU de comando
+		uint16_t tamanhoComando;
+		byte *resposta;			 // Buffer para a resposta completa, com SW1 SW2, ou NULL (veja TAMANHO_RASCUNHO)
+		uint16_t capacidade;	 // Tamanho do buffer de resposta
+		// Saída
+		uint16_t tamanhoResposta; // Bytes recebidos, com SW1 SW2
+		uint16_t sw;			  // SW1 SW2, ou 0 se a resposta não foi recebida
+		MFRC522::StatusCode status;
+		uint32_t latenciaUs;	  // Tempo da troca, da transmissão do primeiro bloco até o último bloco recebido
+	} ComandoApdu;
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Construtores
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522ApduPipeline(MFRC522Extended &leitor, bool stopOnStatusWord = true);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções do lote
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522::StatusCode Run(MFRC522Extended::InformacoesTag *tag, ComandoApdu *apdus, byte count, byte *executed = nullptr);
+	uint32_t GetTotalTime() const { return _tempoTotalUs; };
+
+protected:
+	MFRC522Extended &_leitor;
+	bool _pararEmSw;		 // Interromper o lote na primeira SW diferente de 9000
+	uint32_t _tempoTotalUs;	 // Soma das latências do último Run()
+	byte _rascunho[TAMANHO_RASCUNHO]; // Resposta de ComandoApdu sem buffer, para extrair a SW
+
+	MFRC522::StatusCode Exchange(MFRC522Extended::InformacoesTag *tag, ComandoApdu *apdu);
+};
+
+#endif
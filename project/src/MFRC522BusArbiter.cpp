@@ -0,0 +1,124 @@
+/*
+ * MFRC522BusArbiter.cpp - Divide um barramento SPI entre um leitor MFRC522 e um cartão SD.
+ * NOTA: Por favor, verifique também os comentários em MFRC522BusArbiter.h
+ * Liberado para o domínio público.
+ */
+
+#include "MFRC522BusArbiter.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Construtores
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Construtor.
+ */
+MFRC522BusArbiter::MFRC522BusArbiter(MFRC522 &leitor, ///< Leitor com prioridade no barramento.
+									 Print &destino	  ///< Destino da fila, ex.: um File aberto no cartão SD.
+									 )
+	: _leitor(leitor), _destino(destino)
+{
+	_ocupados = 0;
+} // Fim do construtor
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de gravação (Print)
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Coloca um byte na fila. Se a fila estiver cheia, ela é esvaziada antes.
+ *
+ * @return 1, ou 0 se o destino não aceitou os dados.
+ */
+size_t MFRC522BusArbiter::write(uint8_t valor)
+{
+	return write(&valor, 1);
+} // Fim write()
+
+/**
+ * Coloca bytes na fila. Se não couberem, a fila é esvaziada antes; dados maiores que a fila vazia seguem direto
+ * para o destino. Se o destino não aceitar a fila inteira, apenas o que couber no espaço livre é aceito.
+ *
+ * @return Número de bytes aceitos, menor que tamanho se o destino estiver sem espaço.
+ */
+size_t MFRC522BusArbiter::write(const uint8_t *buffer, size_t tamanho)
+{
+	if (tamanho > (size_t)(QUEUE_SIZE - _ocupados))
+	{
+		Flush();
+		if (_ocupados == 0 && tamanho > QUEUE_SIZE)
+		{ // Dados maiores que a fila
+			return _destino.write(buffer, tamanho);
+		}
+	}
+	size_t livres = QUEUE_SIZE - _ocupados;
+	size_t aceitos = (tamanho < livres) ? tamanho : livres;
+	memcpy(&_fila[_ocupados], buffer, aceitos);
+	_ocupados += aceitos;
+	return aceitos;
+} // Fim write()
+
+/**
+ * Esvazia a fila no destino e chama flush() do destino, que no SD grava o bloco no cartão.
+ * Deve ser chamada com o leitor ocioso, fora de BeginRfid()/EndRfid().
+ */
+void MFRC522BusArbiter::Flush()
+{
+	if (_ocupados == 0)
+	{
+		return;
+	}
+	size_t escritos = _destino.write(_fila, _ocupados);
+	if (escritos < _ocupados)
+	{ // Mantém o que o destino não aceitou para a próxima vez
+		memmove(_fila, &_fila[escritos], _ocupados - escritos);
+	}
+	_ocupados -= escritos;
+	_destino.flush();
+} // Fim Flush()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções do leitor
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Retorna verdadeiro se um PICC responder ao PICC_CMD_REQA, como MFRC522::PICC_IsNewCardPresent().
+ * A fila é esvaziada no destino enquanto o MFRC522 espera a resposta de RF.
+ *
+ * @return bool
+ */
+bool MFRC522BusArbiter::PICC_IsNewCardPresent()
+{
+	byte bufferATQA[2];
+	byte tamanhoBuffer = sizeof(bufferATQA);
+
+	_leitor.PCD_BeginBurst();
+	_leitor.PICC_StartRequestA();
+	_leitor.PCD_EndBurst();
+
+	// O barramento está livre enquanto o REQA está no ar
+	Flush();
+
+	MFRC522::StatusCode resultado;
+	_leitor.PCD_BeginBurst();
+	while ((resultado = _leitor.PICC_CheckRequestA(bufferATQA, &tamanhoBuffer)) == MFRC522::STATUS_PENDING)
+	{
+		yield();
+	}
+	_leitor.PCD_EndBurst();
+
+	return (resultado == MFRC522::STATUS_OK || resultado == MFRC522::STATUS_COLLISION);
+} // Fim PICC_IsNewCardPresent()
+
+/**
+ * Lê o UID do PICC em uma única rajada, como MFRC522::PICC_ReadCardSerial().
+ *
+ * @return bool
+ */
+bool MFRC522BusArbiter::PICC_ReadCardSerial()
+{
+	_leitor.PCD_BeginBurst();
+	bool lido = _leitor.PICC_ReadCardSerial();
+	_leitor.PCD_EndBurst();
+	return lido;
+} // Fim PICC_ReadCardSerial()
@@ -0,0 +1,68 @@
+/**
+ * Divide um barramento SPI entre um leitor MFRC522 e um cartão SD (ou outro destino de gravação lenta).
+ *
+ * Gravar no SD entre as chamadas ao leitor soma o tempo de gravação (vários milissegundos por bloco) à
+ * latência entre aproximar o cartão e acender o LED. O árbitro dá prioridade às transações RFID:
+ *   - o que é escrito nele (é um Print) vai para uma fila na RAM, sem tocar no barramento;
+ *   - PICC_IsNewCardPresent() inicia o REQA e, enquanto o MFRC522 espera a resposta de RF, esvazia a fila
+ *     no destino; só depois colhe o resultado do REQA;
+ *   - Flush() esvazia a fila quando o leitor está ocioso.
+ * Cada transação RFID é uma rajada (PCD_BeginBurst()): as configurações do SPI são trocadas uma vez por
+ * rajada, e não a cada acesso a registro.
+ *
+ * Depois de um cartão detectado, o sketch trata o cartão (LEDs etc.) e escreve o registro no árbitro; a
+ * gravação acontece durante a próxima espera de RF, fora do caminho do cartão.
+ * Se a fila encher, ela é esvaziada na hora. Se o destino não aceitar os dados (ex.: cartão SD cheio), write()
+ * aceita apenas o que couber na fila e retorna uma contagem menor, como qualquer Print; confira o retorno
+ * para não perder registros sem perceber.
+ *
+ * Ex.:
+ *   File arquivo = SD.open("alunos.txt", FILE_WRITE);
+ *   MFRC522BusArbiter barramento(rfid, arquivo);
+ *   if (barramento.PICC_IsNewCardPresent() && barramento.PICC_ReadCardSerial()) { ...; barramento.println(id); }
+ */
+#ifndef MFRC522BusArbiter_h
+#define MFRC522BusArbiter_h
+
+#include <Arduino.h>
+#include "MFRC522.h"
+
+// Tamanho da fila de gravação na RAM, em bytes (máx. 255)
+#ifndef MFRC522_BUS_QUEUE_SIZE
+#define MFRC522_BUS_QUEUE_SIZE 64
+#endif
+
+class MFRC522BusArbiter : public Print
+{
+public:
+	static constexpr byte QUEUE_SIZE = MFRC522_BUS_QUEUE_SIZE;
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Construtores
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522BusArbiter(MFRC522 &leitor, Print &destino);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções de gravação (Print)
+	/////////////////////////////////////////////////////////////////////////////////////
+	size_t write(uint8_t valor) override;
+	size_t write(const uint8_t *buffer, size_t tamanho) override;
+	void Flush();
+	byte GetQueued() const { return _ocupados; };
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções do leitor
+	/////////////////////////////////////////////////////////////////////////////////////
+	bool PICC_IsNewCardPresent();
+	bool PICC_ReadCardSerial();
+	void BeginRfid() { _leitor.PCD_BeginBurst(); };
+	void EndRfid() { _leitor.PCD_EndBurst(); };
+
+protected:
+	MFRC522 &_leitor;
+	Print &_destino;
+	byte _fila[QUEUE_SIZE];
+	byte _ocupados; // Bytes na fila
+};
+
+#endif
@@ -0,0 +1,239 @@
+/*
+ * MFRC522CardCache.cpp - Cache de registros por UID, validada pela versão do MFRC522RecordStore.
+ * NOTA: Por favor, verifique também os comentários em MFRC522CardCache.h
+ * Liberado para o domínio público.
+ */
+
+#include "MFRC522CardCache.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Construtores
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Construtor.
+ * O buffer de dados precisa ter numeroEntradas * store.GetCapacity() bytes.
+ */
+MFRC522CardCache::MFRC522CardCache(MFRC522RecordStore &store, ///< Armazenamento dos registros no cartão.
+								   Entrada *entradas,		  ///< Vetor com numeroEntradas entradas.
+								   byte *dados,				  ///< Buffer para os registros em cache.
+								   byte numeroEntradas,		  ///< Número de entradas na RAM, pelo menos 1.
+								   Spill *spill				  ///< Armazenamento secundário opcional, ou nullptr.
+								   )
+	: _store(store)
+{
+	_entradas = entradas;
+	_dados = dados;
+	_numeroEntradas = numeroEntradas;
+	_spill = spill;
+	Clear();
+} // Fim do construtor
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de acesso
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Lê o registro do cartão, usando a cache quando a versão do cartão não mudou.
+ *
+ * Com o UID em cache (na RAM ou no Spill), apenas o diretório é lido do cartão; o registro só é lido
+ * se a versão for diferente. Sem o UID em cache, o registro é lido por completo e guardado na cache.
+ *
+ * Lembre-se de chamar PICC_HaltA() e PCD_StopCrypto1() ao terminar a comunicação com o PICC.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522CardCache::Read(MFRC522::Uid *uid,		  ///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+										   byte authCommand,		  ///< PICC_CMD_MF_AUTH_KEY_A ou PICC_CMD_MF_AUTH_KEY_B
+										   MFRC522::MIFARE_Key *key,  ///< Chave para o diretório e para as cópias.
+										   byte *data,				  ///< Buffer para o registro, pelo menos store.GetCapacity() bytes.
+										   byte *length,			  ///< Recebe o tamanho do registro.
+										   bool *fromCache			  ///< Se não for nullptr, recebe true se o registro veio da cache.
+)
+{
+	MFRC522::StatusCode resultado;
+	uint16_t versao;
+	bool mudou = true;
+
+	Entrada *entrada = Find(uid);
+	if (entrada == nullptr && _spill)
+	{
+		entrada = Allocate(uid);
+		if (!_spill->Load(uid, &entrada->versao, DataOf(entrada), &entrada->tamanho, _store.GetCapacity()))
+		{
+			entrada->tamanhoUid = 0;
+			entrada = nullptr;
+		}
+	}
+
+	if (entrada)
+	{
+		resultado = _store.ReadIfChanged(uid, authCommand, key, entrada->versao, data, length, &versao, &mudou);
+	}
+	else
+	{
+		resultado = _store.Read(uid, authCommand, key, data, length, &versao);
+	}
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+
+	if (fromCache)
+	{
+		*fromCache = !mudou;
+	}
+	if (!mudou)
+	{
+		memcpy(data, DataOf(entrada), entrada->tamanho);
+		*length = entrada->tamanho;
+		Touch(entrada);
+		return MFRC522::STATUS_OK;
+	}
+
+	if (entrada == nullptr)
+	{
+		entrada = Allocate(uid);
+	}
+	Store(entrada, versao, data, *length);
+	return MFRC522::STATUS_OK;
+} // Fim Read()
+
+/**
+ * Escreve o registro no cartão com MFRC522RecordStore::Write() e atualiza a cache com a nova versão.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522CardCache::Write(MFRC522::Uid *uid,		   ///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+											byte authCommand,		   ///< PICC_CMD_MF_AUTH_KEY_A ou PICC_CMD_MF_AUTH_KEY_B
+											MFRC522::MIFARE_Key *key,  ///< Chave para o diretório e para as cópias.
+											const byte *data,		   ///< Conteúdo do registro.
+											byte length				   ///< Tamanho do registro, no máximo store.GetCapacity().
+)
+{
+	uint16_t versao;
+	MFRC522::StatusCode resultado = _store.Write(uid, authCommand, key, data, length, &versao);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		// A entrada em cache continua segura: se o diretório foi gravado, a versão mudou e a próxima leitura vai ao cartão.
+		return resultado;
+	}
+
+	Entrada *entrada = Find(uid);
+	if (entrada == nullptr)
+	{
+		entrada = Allocate(uid);
+	}
+	Store(entrada, versao, data, length);
+	return MFRC522::STATUS_OK;
+} // Fim Write()
+
+/**
+ * Remove o UID da cache na RAM. Uma cópia no Spill continua válida enquanto a versão do cartão não mudar.
+ */
+void MFRC522CardCache::Invalidate(const MFRC522::Uid *uid)
+{
+	Entrada *entrada = Find(uid);
+	if (entrada)
+	{
+		entrada->tamanhoUid = 0;
+	}
+} // Fim Invalidate()
+
+/**
+ * Remove todas as entradas da cache na RAM.
+ */
+void MFRC522CardCache::Clear()
+{
+	for (byte i = 0; i < _numeroEntradas; i++)
+	{
+		_entradas[i].tamanhoUid = 0;
+		_entradas[i].ultimoUso = 0;
+	}
+	_relogio = 0;
+} // Fim Clear()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de suporte
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Procura o UID na cache na RAM.
+ *
+ * @return A entrada, ou nullptr se o UID não estiver na RAM.
+ */
+MFRC522CardCache::Entrada *MFRC522CardCache::Find(const MFRC522::Uid *uid)
+{
+	for (byte i = 0; i < _numeroEntradas; i++)
+	{
+		if (_entradas[i].tamanhoUid == uid->size && memcmp(_entradas[i].uid, uid->uidByte, uid->size) == 0)
+		{
+			return &_entradas[i];
+		}
+	}
+	return nullptr;
+} // Fim Find()
+
+/**
+ * Reserva uma entrada para o UID: uma entrada livre ou, se não houver, a menos usada recentemente,
+ * que antes é guardada no Spill.
+ *
+ * @return A entrada, com o UID preenchido.
+ */
+MFRC522CardCache::Entrada *MFRC522CardCache::Allocate(const MFRC522::Uid *uid)
+{
+	Entrada *escolhida = &_entradas[0];
+	for (byte i = 0; i < _numeroEntradas; i++)
+	{
+		if (_entradas[i].tamanhoUid == 0)
+		{
+			escolhida = &_entradas[i];
+			break;
+		}
+		if (_entradas[i].ultimoUso < escolhida->ultimoUso)
+		{
+			escolhida = &_entradas[i];
+		}
+	}
+
+	if (escolhida->tamanhoUid && _spill)
+	{
+		MFRC522::Uid removido;
+		removido.size = escolhida->tamanhoUid;
+		memcpy(removido.uidByte, escolhida->uid, removido.size);
+		_spill->Save(&removido, escolhida->versao, DataOf(escolhida), escolhida->tamanho);
+	}
+
+	escolhida->tamanhoUid = uid->size;
+	memcpy(escolhida->uid, uid->uidByte, uid->size);
+	escolhida->tamanho = 0;
+	Touch(escolhida);
+	return escolhida;
+} // Fim Allocate()
+
+/**
+ * Guarda a versão e os dados do registro na entrada.
+ */
+void MFRC522CardCache::Store(Entrada *entrada, uint16_t version, const byte *data, byte length)
+{
+	entrada->versao = version;
+	entrada->tamanho = length;
+	memcpy(DataOf(entrada), data, length);
+	Touch(entrada);
+} // Fim Store()
+
+/**
+ * Marca a entrada como a usada mais recentemente.
+ */
+void MFRC522CardCache::Touch(Entrada *entrada)
+{
+	if (++_relogio == 0)
+	{ // O contador deu a volta: recomeça a contagem, mantendo apenas esta entrada como a mais recente
+		for (byte i = 0; i < _numeroEntradas; i++)
+		{
+			_entradas[i].ultimoUso = 0;
+		}
+		_relogio = 1;
+	}
+	entrada->ultimoUso = _relogio;
+} // Fim Touch()
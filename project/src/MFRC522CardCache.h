@@ -0,0 +1,72 @@
+/**
+ * Cache de registros por UID sobre MFRC522RecordStore.
+ *
+ * O diretório do MFRC522RecordStore guarda um contador de versão que é incrementado a cada escrita.
+ * Em uma leitura, apenas o diretório é lido (uma autenticação e uma leitura); se a versão for igual à
+ * versão em cache para o mesmo UID, o registro em cache é retornado sem ler as cópias. A comparação é
+ * apenas por igualdade, então a volta do contador de 16 bits não afeta a cache; depois de
+ * MFRC522RecordStore::Format(), que volta a versão a 0, chame Invalidate() para o UID.
+ *
+ * As entradas ficam na RAM, em um buffer fornecido pelo chamador, e são substituídas pela menos usada
+ * recentemente. Opcionalmente, uma implementação de MFRC522CardCache::Spill (por exemplo, um arquivo no
+ * cartão SD) recebe as entradas removidas da RAM e é consultada quando o UID não está na RAM.
+ */
+#ifndef MFRC522CardCache_h
+#define MFRC522CardCache_h
+
+#include <Arduino.h>
+#include "MFRC522.h"
+#include "MFRC522RecordStore.h"
+
+class MFRC522CardCache
+{
+public:
+	// Armazenamento secundário para entradas removidas da RAM.
+	class Spill
+	{
+	public:
+		// Procura o registro do UID. Retorna true se encontrado; data recebe até capacity bytes.
+		virtual bool Load(const MFRC522::Uid *uid, uint16_t *version, byte *data, byte *length, byte capacity) = 0;
+		// Guarda (ou substitui) o registro do UID.
+		virtual void Save(const MFRC522::Uid *uid, uint16_t version, const byte *data, byte length) = 0;
+	};
+
+	// Entrada da cache na RAM. Os dados ficam no buffer de dados, na posição do índice da entrada.
+	typedef struct
+	{
+		byte tamanhoUid;  // 0 se a entrada estiver livre
+		byte uid[10];
+		uint16_t versao;
+		byte tamanho;	  // Número de bytes válidos do registro
+		byte ultimoUso;	  // Para substituição da entrada menos usada recentemente
+	} Entrada;
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Construtores
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522CardCache(MFRC522RecordStore &store, Entrada *entradas, byte *dados, byte numeroEntradas, Spill *spill = nullptr);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções de acesso
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522::StatusCode Read(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, byte *data, byte *length, bool *fromCache = nullptr);
+	MFRC522::StatusCode Write(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, const byte *data, byte length);
+	void Invalidate(const MFRC522::Uid *uid);
+	void Clear();
+
+protected:
+	MFRC522RecordStore &_store;
+	Entrada *_entradas;
+	byte *_dados;		  // numeroEntradas * capacidade do store
+	byte _numeroEntradas;
+	Spill *_spill;
+	byte _relogio;		  // Contador de uso, para a substituição LRU
+
+	Entrada *Find(const MFRC522::Uid *uid);
+	Entrada *Allocate(const MFRC522::Uid *uid);
+	void Store(Entrada *entrada, uint16_t version, const byte *data, byte length);
+	byte *DataOf(const Entrada *entrada) const { return &_dados[(entrada - _entradas) * _store.GetCapacity()]; };
+	void Touch(Entrada *entrada);
+};
+
+#endif
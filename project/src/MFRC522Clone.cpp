@@ -0,0 +1,367 @@
+/*
+ * MFRC522Clone.cpp - Cópia de PICCs MIFARE Classic a partir de uma imagem em memória ou em fluxo.
+ * NOTA: Por favor, verifique também os comentários em MFRC522Clone.h
+ * Liberado para o domínio público.
+ */
+
+#include "MFRC522Clone.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Construtores
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Construtor.
+ */
+MFRC522Clone::MFRC522Clone(MFRC522 &leitor ///< Instância MFRC522 usada para a comunicação.
+						   )
+	: _leitor(leitor)
+{
+	_ultimoBloco = 0;
+} // Fim do construtor
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de cópia
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Lê o PICC inteiro em trechos de até BLOCOS_TRECHO blocos e os entrega ao sink, com uma única autenticação
+ * (Chave A) por setor. Apenas um trecho fica na memória, então o tamanho do PICC não importa (4K inclusive).
+ * A Chave A de cada trailer é preenchida com a chave usada. A Chave B só é copiada se os bits de acesso
+ * permitirem sua leitura; caso contrário o PICC a devolve como zeros.
+ *
+ * Lembre-se de chamar PICC_HaltA() e PCD_StopCrypto1() ao terminar a comunicação com o PICC.
+ *
+ * @return STATUS_OK em caso de sucesso, o erro do sink ou STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Clone::Stream(MFRC522::Uid *uid,			///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+										 MFRC522::PICC_Type piccType, ///< Tipo do PICC (MIFARE Mini, 1K, 2K ou 4K).
+										 MFRC522::MIFARE_Key *key,	///< Chave A de todos os setores.
+										 MFRC522CloneSink &sink		///< Recebe a imagem, um trecho por vez.
+)
+{
+	const byte setores = MifareClassicSectorCount(piccType);
+	if (setores == 0)
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+	MFRC522::StatusCode resultado = sink.Begin(piccType);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+
+	byte trecho[BLOCOS_TRECHO * 16];
+	byte buffer[18];
+	byte tamanho;
+	for (byte setor = 0; setor < setores; setor++)
+	{
+		const byte primeiro = MifareClassicGeometry::FirstBlock(setor);
+		const byte trailer = MifareClassicGeometry::TrailerBlock(setor);
+
+		_ultimoBloco = trailer;
+		resultado = _leitor.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, trailer, key, uid);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+		for (uint16_t inicio = primeiro; inicio <= trailer; inicio += BLOCOS_TRECHO)
+		{
+			byte blocos = 0;
+			for (uint16_t bloco = inicio; bloco <= trailer && blocos < BLOCOS_TRECHO; bloco++, blocos++)
+			{
+				_ultimoBloco = (byte)bloco;
+				tamanho = sizeof(buffer);
+				resultado = _leitor.MIFARE_Read((byte)bloco, buffer, &tamanho);
+				if (resultado != MFRC522::STATUS_OK)
+				{
+					return resultado;
+				}
+				memcpy(&trecho[blocos * 16], buffer, 16);
+				if (bloco == trailer)
+				{
+					memcpy(&trecho[blocos * 16], key->keyByte, MFRC522::MF_KEY_SIZE); // A Chave A é sempre lida como zeros
+				}
+			}
+			resultado = sink.Blocks((byte)inicio, blocos, trecho);
+			if (resultado != MFRC522::STATUS_OK)
+			{
+				return resultado;
+			}
+		}
+	}
+	return sink.End();
+} // Fim Stream()
+
+/**
+ * Lê o PICC inteiro para a imagem, veja Stream().
+ *
+ * Lembre-se de chamar PICC_HaltA() e PCD_StopCrypto1() ao terminar a comunicação com o PICC.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Clone::ReadImage(MFRC522::Uid *uid,			   ///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+											MFRC522::PICC_Type piccType, ///< Tipo do PICC (MIFARE Mini, 1K, 2K ou 4K).
+											MFRC522::MIFARE_Key *key,	   ///< Chave A de todos os setores.
+											byte *image				   ///< Recebe GetImageSize(piccType) bytes.
+)
+{
+	if (image == nullptr)
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+	MFRC522CloneRam ram(image, GetImageSize(piccType));
+	return Stream(uid, piccType, key, ram);
+} // Fim ReadImage()
+
+/**
+ * Escreve a imagem inteira em um PICC Gen1a (UID modificável), incluindo o bloco 0 e todos os trailers.
+ * A porta dos fundos é aberta uma única vez e nenhuma autenticação é feita; o PICC não precisa estar selecionado.
+ * Com verify, cada bloco de dados é lido de volta (a porta dos fundos também permite leituras) e comparado.
+ *
+ * O UID muda com o bloco 0: ao terminar, chame PICC_HaltA() e selecione o PICC novamente.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Clone::WriteMagic(byte *image,					///< Imagem com GetImageSize(piccType) bytes.
+											 MFRC522::PICC_Type piccType, ///< Tipo do PICC (MIFARE Mini, 1K, 2K ou 4K).
+											 bool verify				///< true para ler e comparar cada bloco de dados escrito.
+)
+{
+	MFRC522::StatusCode resultado = CheckImage(image, piccType, true);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+
+	// Abre a porta dos fundos uma única vez para todo o cartão
+	_leitor.PCD_StopCrypto1();
+	if (!_leitor.MIFARE_OpenUidBackdoor(false))
+	{
+		return MFRC522::STATUS_ERROR;
+	}
+
+	const uint16_t blocos = GetBlockCount(piccType);
+	for (uint16_t bloco = 0; bloco < blocos; bloco++)
+	{
+		_ultimoBloco = (byte)bloco;
+		resultado = _leitor.MIFARE_Write((byte)bloco, &image[bloco * 16], 16);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+	}
+
+	if (verify)
+	{
+		byte buffer[18];
+		byte tamanho;
+		for (uint16_t bloco = 0; bloco < blocos; bloco++)
+		{
+			if (MifareClassicGeometry::IsTrailer((byte)bloco))
+			{
+				continue;
+			}
+			_ultimoBloco = (byte)bloco;
+			tamanho = sizeof(buffer);
+			resultado = _leitor.MIFARE_Read((byte)bloco, buffer, &tamanho);
+			if (resultado != MFRC522::STATUS_OK)
+			{
+				return resultado;
+			}
+			if (memcmp(buffer, &image[bloco * 16], 16) != 0)
+			{
+				return MFRC522::STATUS_ERROR;
+			}
+		}
+	}
+	return MFRC522::STATUS_OK;
+} // Fim WriteMagic()
+
+/**
+ * Escreve a imagem em um PICC comum com uma única autenticação (Chave A) por setor, veja MIFARE_WriteDiff().
+ * O bloco 0 (dados do fabricante) não pode ser escrito e é mantido. Os trailers são escritos por último
+ * em cada setor, e apenas quando diferem nos bits de acesso, na Chave A (comparada com key) ou na Chave B legível;
+ * um cartão já copiado não tem nenhum trailer reescrito.
+ *
+ * Lembre-se de chamar PICC_HaltA() e PCD_StopCrypto1() ao terminar a comunicação com o PICC.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Clone::WriteSectors(MFRC522::Uid *uid,			///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+											   byte *image,					///< Imagem com GetImageSize(piccType) bytes.
+											   MFRC522::PICC_Type piccType, ///< Tipo do PICC (MIFARE Mini, 1K, 2K ou 4K).
+											   MFRC522::MIFARE_Key *key,	///< Chave A atual de todos os setores do PICC de destino.
+											   byte *blocksWritten			///< Se não for nullptr, recebe o número de blocos escritos.
+)
+{
+	MFRC522::StatusCode resultado = CheckImage(image, piccType, false);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	return _leitor.MIFARE_WriteDiff(uid, MFRC522::PICC_CMD_MF_AUTH_KEY_A, key, 1, (byte)(GetBlockCount(piccType) - 1), &image[16], nullptr, blocksWritten);
+} // Fim WriteSectors()
+
+/**
+ * Confere a imagem no MCU, sem comunicação com o PICC: os bits de acesso de todos os trailers e,
+ * com checkBlock0, o BCC de um UID de 4 bytes no bloco 0.
+ *
+ * @return STATUS_OK se a imagem pode ser escrita, STATUS_INVALID caso contrário.
+ */
+MFRC522::StatusCode MFRC522Clone::CheckImage(const byte *image,			  ///< Imagem com GetImageSize(piccType) bytes.
+											 MFRC522::PICC_Type piccType, ///< Tipo do PICC (MIFARE Mini, 1K, 2K ou 4K).
+											 bool checkBlock0			  ///< true para conferir o BCC do bloco 0.
+)
+{
+	const byte setores = MifareClassicSectorCount(piccType);
+	if (setores == 0 || image == nullptr)
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+	if (checkBlock0 && (image[0] ^ image[1] ^ image[2] ^ image[3]) != image[4])
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+
+	byte g[4];
+	for (byte setor = 0; setor < setores; setor++)
+	{
+		if (!MFRC522::MIFARE_GetAccessBits(&image[MifareClassicGeometry::TrailerBlock(setor) * 16 + 6], g))
+		{
+			return MFRC522::STATUS_INVALID;
+		}
+	}
+	return MFRC522::STATUS_OK;
+} // Fim CheckImage()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// MFRC522CloneRam
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Confere se a imagem inteira do tipo cabe no buffer.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_NO_ROOM caso contrário.
+ */
+MFRC522::StatusCode MFRC522CloneRam::Begin(MFRC522::PICC_Type piccType)
+{
+	return (MFRC522Clone::GetImageSize(piccType) <= _capacidade) ? MFRC522::STATUS_OK : MFRC522::STATUS_NO_ROOM;
+} // Fim Begin()
+
+/**
+ * Copia o trecho para a sua posição na imagem.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_NO_ROOM caso contrário.
+ */
+MFRC522::StatusCode MFRC522CloneRam::Blocks(byte firstBlock, byte blockCount, byte *data)
+{
+	if ((uint16_t)(firstBlock + blockCount) * 16 > _capacidade)
+	{
+		return MFRC522::STATUS_NO_ROOM;
+	}
+	memcpy(&_imagem[firstBlock * 16], data, blockCount * 16);
+	return MFRC522::STATUS_OK;
+} // Fim Blocks()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// MFRC522ClonePrint
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Escreve o trecho na saída. Os trechos chegam em ordem, então a saída é a imagem bruta.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_ERROR se a saída não aceitou todos os bytes.
+ */
+MFRC522::StatusCode MFRC522ClonePrint::Blocks(byte, byte blockCount, byte *data)
+{
+	const size_t tamanho = blockCount * 16;
+	return (_saida.write(data, tamanho) == tamanho) ? MFRC522::STATUS_OK : MFRC522::STATUS_ERROR;
+} // Fim Blocks()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// MFRC522CloneCard
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Prepara o PICC de destino: no Gen1a abre a porta dos fundos uma única vez para toda a cópia.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522CloneCard::Begin(MFRC522::PICC_Type piccType)
+{
+	if (MifareClassicSectorCount(piccType) == 0)
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+	_setor = 0xFF;
+	_leitor.PCD_StopCrypto1();
+	if (_magico && !_leitor.MIFARE_OpenUidBackdoor(false))
+	{
+		return MFRC522::STATUS_ERROR;
+	}
+	return MFRC522::STATUS_OK;
+} // Fim Begin()
+
+/**
+ * Escreve o trecho no PICC de destino: todos os blocos sem autenticação no Gen1a, ou com uma autenticação
+ * por setor (no primeiro trecho do setor) em PICCs comuns, sem o bloco 0.
+ * O BCC do bloco 0 (Gen1a) e os bits de acesso do trailer são conferidos antes de escrevê-los.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522CloneCard::Blocks(byte firstBlock, byte blockCount, byte *data)
+{
+	MFRC522::StatusCode resultado;
+	const byte setor = MifareClassicGeometry::SectorOf(firstBlock);
+	if (!_magico && setor != _setor)
+	{
+		resultado = _leitor.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, MifareClassicGeometry::TrailerBlock(setor), _chave, _uid);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+		_setor = setor;
+	}
+
+	byte g[4];
+	for (byte i = 0; i < blockCount; i++)
+	{
+		const byte bloco = firstBlock + i;
+		byte *dados = &data[i * 16];
+		if (bloco == 0)
+		{
+			if (!_magico)
+			{ // Bloco do fabricante, somente leitura
+				continue;
+			}
+			if ((dados[0] ^ dados[1] ^ dados[2] ^ dados[3]) != dados[4])
+			{
+				return MFRC522::STATUS_INVALID;
+			}
+		}
+		if (MifareClassicGeometry::IsTrailer(bloco) && !MFRC522::MIFARE_GetAccessBits(&dados[6], g))
+		{
+			return MFRC522::STATUS_INVALID;
+		}
+		resultado = _leitor.MIFARE_Write(bloco, dados, 16);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+	}
+	return MFRC522::STATUS_OK;
+} // Fim Blocks()
+
+/**
+ * Encerra a cópia: para a criptografia no PCD de destino. O UID pode ter mudado (Gen1a): chame PICC_HaltA()
+ * e selecione o PICC novamente.
+ *
+ * @return STATUS_OK
+ */
+MFRC522::StatusCode MFRC522CloneCard::End()
+{
+	_leitor.PCD_StopCrypto1();
+	_setor = 0xFF;
+	return MFRC522::STATUS_OK;
+} // Fim End()
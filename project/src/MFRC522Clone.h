@@ -0,0 +1,137 @@
+/**
+ * Cópia de PICCs MIFARE Classic (Mini, 1K, 2K e 4K) a partir de uma imagem em memória ou em fluxo.
+ *
+ * A imagem tem 16 bytes por bloco, a partir do bloco 0, com os trailers dos setores; GetImageSize() dá o
+ * tamanho para cada tipo (1024 bytes no 1K). ReadImage() lê a origem com uma autenticação por setor e
+ * completa a Chave A dos trailers com a chave usada, já que o PICC sempre a devolve como zeros.
+ *
+ * Há dois destinos:
+ *   WriteMagic()   - cartões "mágicos" Gen1a (UID modificável): a porta dos fundos (MIFARE_OpenUidBackdoor())
+ *                    é aberta uma única vez e a imagem inteira, incluindo o bloco 0 e todos os trailers, é
+ *                    escrita sem nenhuma autenticação.
+ *   WriteSectors() - cartões comuns: uma autenticação por setor (MIFARE_WriteDiff()), apenas os blocos diferentes
+ *                    são escritos e o bloco 0 é mantido.
+ * Antes de qualquer escrita, a imagem é conferida no MCU: o BCC do bloco 0 (WriteMagic()) e os bits de acesso
+ * de todos os trailers, pois um trailer inválido torna o setor inacessível.
+ *
+ * Stream() lê a origem em trechos de até BLOCOS_TRECHO blocos (64 bytes na pilha) e os entrega a um
+ * MFRC522CloneSink, sem guardar a imagem inteira: assim um 4K é copiado em um AVR com 2 KB de RAM.
+ * Há três destinos prontos:
+ *   MFRC522CloneRam   - uma imagem em memória (é o que ReadImage() usa);
+ *   MFRC522ClonePrint - os bytes da imagem, em ordem, para qualquer Print (um File no cartão SD, a serial);
+ *                       é o formato ".mfd"/".bin" das outras ferramentas MIFARE;
+ *   MFRC522CloneCard  - outro PICC, em um segundo MFRC522 no mesmo barramento SPI (cópia de cartão para cartão),
+ *                       Gen1a pela porta dos fundos ou comum com uma autenticação por setor.
+ * Outros destinos (EEPROM, ...) implementam MFRC522CloneSink.
+ *
+ * Ex.:
+ *   byte imagem[MFRC522Clone::GetImageSize(MFRC522::PICC_TYPE_MIFARE_1K)];
+ *   MFRC522Clone clone(mfrc522);
+ *   clone.ReadImage(&mfrc522.uid, MFRC522::PICC_TYPE_MIFARE_1K, &chave, imagem);
+ *   // ... troque o cartão ...
+ *   clone.WriteMagic(imagem, MFRC522::PICC_TYPE_MIFARE_1K, true);
+ *
+ * Ex.: cópia de cartão para cartão com dois leitores
+ *   MFRC522CloneCard destino(leitor2, &leitor2.uid, &chave, true);
+ *   MFRC522Clone(leitor1).Stream(&leitor1.uid, MFRC522::PICC_TYPE_MIFARE_4K, &chave, destino);
+ */
+#ifndef MFRC522Clone_h
+#define MFRC522Clone_h
+
+#include <Arduino.h>
+#include "MFRC522.h"
+#include "MFRC522Layout.h"
+
+// Recebe a imagem lida por MFRC522Clone::Stream(), um trecho por vez
+class MFRC522CloneSink
+{
+public:
+	virtual ~MFRC522CloneSink() {};
+	virtual MFRC522::StatusCode Begin(MFRC522::PICC_Type piccType) = 0;
+	// Blocos consecutivos de um mesmo setor, 16 bytes cada. Os trechos vêm em ordem crescente e o trecho com o
+	// trailer (Chave A já preenchida) é sempre o último do setor. Retorne um erro para interromper a cópia.
+	virtual MFRC522::StatusCode Blocks(byte firstBlock, byte blockCount, byte *data) = 0;
+	virtual MFRC522::StatusCode End() = 0;
+};
+
+class MFRC522Clone
+{
+public:
+	// Blocos lidos por vez em Stream()
+	static constexpr byte BLOCOS_TRECHO = 4;
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Construtores
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522Clone(MFRC522 &leitor);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções de cópia
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522::StatusCode Stream(MFRC522::Uid *uid, MFRC522::PICC_Type piccType, MFRC522::MIFARE_Key *key, MFRC522CloneSink &sink);
+	MFRC522::StatusCode ReadImage(MFRC522::Uid *uid, MFRC522::PICC_Type piccType, MFRC522::MIFARE_Key *key, byte *image);
+	MFRC522::StatusCode WriteMagic(byte *image, MFRC522::PICC_Type piccType, bool verify);
+	MFRC522::StatusCode WriteSectors(MFRC522::Uid *uid, byte *image, MFRC522::PICC_Type piccType, MFRC522::MIFARE_Key *key, byte *blocksWritten = nullptr);
+	static MFRC522::StatusCode CheckImage(const byte *image, MFRC522::PICC_Type piccType, bool checkBlock0);
+
+	// Número de blocos de um tipo MIFARE Classic, 0 para outros tipos.
+	static constexpr uint16_t GetBlockCount(MFRC522::PICC_Type piccType)
+	{
+		return MifareClassicSectorCount(piccType) ? (uint16_t)MifareClassicGeometry::TrailerBlock(MifareClassicSectorCount(piccType) - 1) + 1 : 0;
+	};
+	static constexpr uint16_t GetImageSize(MFRC522::PICC_Type piccType) { return GetBlockCount(piccType) * 16; };
+
+	// Último bloco lido por Stream() e ReadImage() ou escrito por WriteMagic(), útil para localizar uma falha.
+	byte GetLastBlock() const { return _ultimoBloco; };
+
+protected:
+	MFRC522 &_leitor;
+	byte _ultimoBloco;
+};
+
+class MFRC522CloneRam : public MFRC522CloneSink
+{
+public:
+	MFRC522CloneRam(byte *imagem, uint16_t capacidade) : _imagem(imagem), _capacidade(capacidade) {};
+
+	MFRC522::StatusCode Begin(MFRC522::PICC_Type piccType) override;
+	MFRC522::StatusCode Blocks(byte firstBlock, byte blockCount, byte *data) override;
+	MFRC522::StatusCode End() override { return MFRC522::STATUS_OK; };
+
+protected:
+	byte *_imagem;
+	uint16_t _capacidade; // Tamanho de _imagem em bytes
+};
+
+class MFRC522ClonePrint : public MFRC522CloneSink
+{
+public:
+	MFRC522ClonePrint(Print &saida) : _saida(saida) {};
+
+	MFRC522::StatusCode Begin(MFRC522::PICC_Type) override { return MFRC522::STATUS_OK; };
+	MFRC522::StatusCode Blocks(byte firstBlock, byte blockCount, byte *data) override;
+	MFRC522::StatusCode End() override { return MFRC522::STATUS_OK; };
+
+protected:
+	Print &_saida;
+};
+
+class MFRC522CloneCard : public MFRC522CloneSink
+{
+public:
+	MFRC522CloneCard(MFRC522 &leitor, MFRC522::Uid *uid, MFRC522::MIFARE_Key *key, bool magic)
+		: _leitor(leitor), _uid(uid), _chave(key), _magico(magic), _setor(0xFF) {};
+
+	MFRC522::StatusCode Begin(MFRC522::PICC_Type piccType) override;
+	MFRC522::StatusCode Blocks(byte firstBlock, byte blockCount, byte *data) override;
+	MFRC522::StatusCode End() override;
+
+protected:
+	MFRC522 &_leitor;
+	MFRC522::Uid *_uid;			// PICC de destino, selecionado em _leitor
+	MFRC522::MIFARE_Key *_chave; // Chave A atual dos setores do destino (não usada no Gen1a)
+	bool _magico;				// true para escrever pela porta dos fundos Gen1a
+	byte _setor;				// Setor autenticado no destino, 0xFF se nenhum
+};
+
+#endif
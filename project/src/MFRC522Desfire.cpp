@@ -0,0 +1,306 @@
+/*
+ * MFRC522Desfire.cpp - Comandos MIFARE DESFire EV1/EV2 sobre MFRC522Extended.
+ * NOTA: Por favor, verifique também os comentários em MFRC522Desfire.h
+ * Liberado para o domínio público.
+ */
+
+#include "MFRC522Desfire.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Construtores
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Construtor.
+ * Os comandos usam o PICC em leitor.tag, selecionado com PICC_Select() ou PICC_ReadCardSerial().
+ */
+MFRC522Desfire::MFRC522Desfire(MFRC522Extended &leitor, ///< Instância MFRC522Extended usada para a comunicação.
+							   bool isoWrapping			///< true para encapsular os comandos em APDUs ISO/IEC 7816-4.
+							   )
+	: _leitor(leitor)
+{
+	_iso = isoWrapping;
+	_ultimoStatus = DESFIRE_NO_RESPONSE;
+} // Fim do construtor
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Comandos
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Lista os AIDs das aplicações do PICC. O receptor recebe os AIDs de 3 bytes (LSB primeiro), vários por chamada.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Desfire::GetApplicationIDs(ReceptorDesfire receptor, ///< Recebe os AIDs.
+													  void *contexto			///< Repassado ao receptor.
+)
+{
+	return Transceive(DESFIRE_CMD_GET_APPLICATION_IDS, NULL, 0, 0, NULL, NULL, receptor, contexto);
+} // Fim GetApplicationIDs()
+
+/**
+ * Seleciona uma aplicação, ou o nível do PICC com o AID 0x000000.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Desfire::SelectApplication(uint32_t aid ///< AID de 24 bits.
+)
+{
+	byte cabecalho[3];
+	Write24(cabecalho, aid);
+	return Transceive(DESFIRE_CMD_SELECT_APPLICATION, cabecalho, sizeof(cabecalho), 0, NULL, NULL, NULL, NULL);
+} // Fim SelectApplication()
+
+/**
+ * Lista os números dos arquivos da aplicação selecionada. O receptor recebe um byte por arquivo.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Desfire::GetFileIDs(ReceptorDesfire receptor, ///< Recebe os números dos arquivos.
+											   void *contexto			 ///< Repassado ao receptor.
+)
+{
+	return Transceive(DESFIRE_CMD_GET_FILE_IDS, NULL, 0, 0, NULL, NULL, receptor, contexto);
+} // Fim GetFileIDs()
+
+/**
+ * Lê um arquivo de dados (Standard ou Backup) em modo de comunicação plano.
+ * Os dados chegam ao receptor um quadro por vez, na ordem do arquivo.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Desfire::ReadData(byte fileNo,				///< Número do arquivo.
+											 uint32_t offset,			///< Primeiro byte a ler.
+											 uint32_t length,			///< Bytes a ler, ou 0 para ler até o fim do arquivo.
+											 ReceptorDesfire receptor,	///< Recebe os dados.
+											 void *contexto				///< Repassado ao receptor.
+)
+{
+	if (offset > 0xFFFFFF || length > 0xFFFFFF)
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+	byte cabecalho[7];
+	cabecalho[0] = fileNo;
+	Write24(&cabecalho[1], offset);
+	Write24(&cabecalho[4], length);
+	return Transceive(DESFIRE_CMD_READ_DATA, cabecalho, sizeof(cabecalho), 0, NULL, NULL, receptor, contexto);
+} // Fim ReadData()
+
+/**
+ * Escreve em um arquivo de dados (Standard ou Backup) em modo de comunicação plano.
+ * A fonte é chamada com pedaços de até TAMANHO_PEDACO bytes, na ordem do arquivo.
+ * Em arquivos Backup a escrita só vale depois de um CommitTransaction.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Desfire::WriteData(byte fileNo,		 ///< Número do arquivo.
+											  uint32_t offset,	 ///< Primeiro byte a escrever.
+											  uint32_t length,	 ///< Bytes a escrever.
+											  FonteDesfire fonte, ///< Fornece os dados.
+											  void *contexto	 ///< Repassado à fonte.
+)
+{
+	if (offset > 0xFFFFFF || length == 0 || length > 0xFFFFFF || fonte == NULL)
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+	byte cabecalho[7];
+	cabecalho[0] = fileNo;
+	Write24(&cabecalho[1], offset);
+	Write24(&cabecalho[4], length);
+	return Transceive(DESFIRE_CMD_WRITE_DATA, cabecalho, sizeof(cabecalho), length, fonte, contexto, NULL, NULL);
+} // Fim WriteData()
+
+/**
+ * Escreve em um arquivo de dados a partir de um buffer na RAM.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Desfire::WriteData(byte fileNo,		///< Número do arquivo.
+											  uint32_t offset,	///< Primeiro byte a escrever.
+											  const byte *data, ///< Dados a escrever.
+											  uint32_t length	///< Bytes a escrever.
+)
+{
+	const byte *cursor = data;
+	return WriteData(fileNo, offset, length, CopiaMemoria, &cursor);
+} // Fim WriteData()
+
+/**
+ * Envia um comando e troca os quadros ADDITIONAL_FRAME até o PICC terminar.
+ *
+ * O primeiro quadro leva o cabeçalho e o primeiro pedaço dos dados; enquanto houver dados a enviar, ou o
+ * PICC responder 0xAF, um quadro 0xAF leva o próximo pedaço. Os dados de cada resposta são entregues ao
+ * receptor. Os quadros de uma mesma troca usam o timer configurado uma vez (veja TCL_BeginBatch()).
+ *
+ * Status do PICC diferente de OPERATION_OK e NO_CHANGES: STATUS_ERROR; o status fica em GetLastStatus().
+ * Fonte ou receptor retornou false: STATUS_ERROR, com GetLastStatus() igual a DESFIRE_NO_RESPONSE se
+ * nenhum quadro foi trocado.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Desfire::Transceive(byte command,					 ///< Comando nativo.
+											   const byte *header,				 ///< Parâmetros do comando, enviados apenas no primeiro quadro.
+											   byte headerLength,				 ///< Tamanho dos parâmetros, no máximo 7.
+											   uint32_t dataLength,				 ///< Bytes de dados a pedir à fonte, ou 0.
+											   FonteDesfire fonte,				 ///< Fornece os dados, ou NULL se dataLength for 0.
+											   void *contextoFonte,				 ///< Repassado à fonte.
+											   ReceptorDesfire receptor,		 ///< Recebe os dados das respostas, ou NULL para descartá-los.
+											   void *contextoReceptor			 ///< Repassado ao receptor.
+)
+{
+	MFRC522::StatusCode resultado;
+	byte quadro[TAMANHO_QUADRO];
+	byte resposta[TAMANHO_QUADRO];
+	const byte *dados;
+	byte tamanhoDados;
+	byte comando = command;
+	uint32_t enviados = 0;
+
+	if (headerLength > 7 || (dataLength && fonte == NULL))
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+
+	_ultimoStatus = DESFIRE_NO_RESPONSE;
+	_leitor.TCL_BeginBatch(&_leitor.tag);
+	while (true)
+	{
+		byte tamanho = 0;
+		byte *destino = quadro + InicioDados();
+		if (enviados == 0 && comando == command && headerLength)
+		{
+			memcpy(destino, header, headerLength);
+			tamanho = headerLength;
+		}
+		byte pedaco = (dataLength - enviados > TAMANHO_PEDACO) ? TAMANHO_PEDACO : dataLength - enviados;
+		if (pedaco && !fonte(destino + tamanho, pedaco, contextoFonte))
+		{
+			resultado = MFRC522::STATUS_ERROR;
+			break;
+		}
+		tamanho += pedaco;
+		enviados += pedaco;
+
+		resultado = ExchangeFrame(comando, quadro, tamanho, resposta, &dados, &tamanhoDados);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			break;
+		}
+		if (tamanhoDados && receptor && !receptor(dados, tamanhoDados, contextoReceptor))
+		{
+			resultado = MFRC522::STATUS_ERROR;
+			break;
+		}
+
+		if (_ultimoStatus == DESFIRE_ADDITIONAL_FRAME)
+		{
+			comando = DESFIRE_CMD_ADDITIONAL_FRAME;
+			continue;
+		}
+		if ((_ultimoStatus != DESFIRE_OPERATION_OK && _ultimoStatus != DESFIRE_NO_CHANGES) || enviados < dataLength)
+		{
+			resultado = MFRC522::STATUS_ERROR;
+		}
+		break;
+	}
+	_leitor.TCL_EndBatch();
+	return resultado;
+} // Fim Transceive()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de suporte
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Envia um quadro, encapsulado em APDU se necessário, e separa o status dos dados da resposta.
+ * Os dados do comando já devem estar em quadro + InicioDados().
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Desfire::ExchangeFrame(byte comando,			///< Comando nativo ou 0xAF.
+												  byte *quadro,			///< Buffer de TAMANHO_QUADRO bytes com os dados do comando.
+												  byte tamanho,			///< Tamanho dos dados do comando.
+												  byte *resposta,		///< Buffer de TAMANHO_QUADRO bytes para a resposta.
+												  const byte **dados,	///< Recebe a posição dos dados em resposta.
+												  byte *tamanhoDados	///< Recebe o tamanho dos dados.
+)
+{
+	uint16_t tamanhoQuadro;
+	if (_iso)
+	{
+		quadro[0] = 0x90;
+		quadro[1] = comando;
+		quadro[2] = 0x00;
+		quadro[3] = 0x00;
+		if (tamanho)
+		{
+			quadro[4] = tamanho;
+			tamanhoQuadro = 5 + tamanho;
+		}
+		else
+		{
+			tamanhoQuadro = 4; // Sem Lc, Le logo depois de P2
+		}
+		quadro[tamanhoQuadro++] = 0x00; // Le
+	}
+	else
+	{
+		quadro[0] = comando;
+		tamanhoQuadro = 1 + tamanho;
+	}
+
+	uint16_t tamanhoResposta = TAMANHO_QUADRO;
+	MFRC522::StatusCode resultado = _leitor.TCL_TransceiveLong(&_leitor.tag, quadro, tamanhoQuadro, resposta, &tamanhoResposta);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+
+	if (_iso)
+	{
+		// dados 91 STATUS; outra SW é um erro da camada ISO (ex.: 6E00, CLA não suportado)
+		if (tamanhoResposta < 2 || resposta[tamanhoResposta - 2] != 0x91)
+		{
+			return MFRC522::STATUS_ERROR;
+		}
+		_ultimoStatus = resposta[tamanhoResposta - 1];
+		*dados = resposta;
+		*tamanhoDados = tamanhoResposta - 2;
+	}
+	else
+	{
+		// STATUS dados
+		if (tamanhoResposta < 1)
+		{
+			return MFRC522::STATUS_ERROR;
+		}
+		_ultimoStatus = resposta[0];
+		*dados = resposta + 1;
+		*tamanhoDados = tamanhoResposta - 1;
+	}
+	return MFRC522::STATUS_OK;
+} // Fim ExchangeFrame()
+
+/**
+ * Grava um valor de 24 bits, LSB primeiro.
+ */
+void MFRC522Desfire::Write24(byte *destino, uint32_t valor)
+{
+	destino[0] = valor & 0xFF;
+	destino[1] = (valor >> 8) & 0xFF;
+	destino[2] = (valor >> 16) & 0xFF;
+} // Fim Write24()
+
+/**
+ * FonteDesfire que copia de um buffer na RAM; contexto aponta para um cursor (const byte *) que avança.
+ */
+bool MFRC522Desfire::CopiaMemoria(byte *buffer, byte tamanho, void *contexto)
+{
+	const byte **cursor = (const byte **)contexto;
+	memcpy(buffer, *cursor, tamanho);
+	*cursor += tamanho;
+	return true;
+} // Fim CopiaMemoria()
@@ -0,0 +1,105 @@
+/**
+ * Comandos MIFARE DESFire EV1/EV2 sobre MFRC522Extended (ISO/IEC 14443-4).
+ *
+ * Os comandos podem ser enviados no formato nativo (CMD dados -> STATUS dados) ou encapsulados em APDUs
+ * ISO/IEC 7816-4 (90 CMD 00 00 Lc dados 00 -> dados 91 STATUS), veja SetIsoWrapping(). Respostas e dados
+ * maiores que um quadro DESFire são trocados em vários quadros com ADDITIONAL_FRAME (0xAF); Transceive()
+ * faz a continuação automaticamente.
+ *
+ * ReadData(), GetFileIDs() e GetApplicationIDs() entregam os dados ao ReceptorDesfire do chamador, um
+ * quadro por vez; WriteData() pede os dados a um FonteDesfire, um pedaço por vez. Assim um arquivo de 4 KB
+ * é lido ou escrito com apenas um quadro (TAMANHO_QUADRO bytes) na pilha.
+ *
+ * Apenas o modo de comunicação em texto plano é suportado: autenticação e mensagens seguras (MAC ou
+ * cifradas) não fazem parte desta camada.
+ *
+ * Ex.: ler um arquivo inteiro para a serial
+ *   bool imprime(const byte *dados, byte tamanho, void *) { Serial.write(dados, tamanho); return true; }
+ *   MFRC522Desfire desfire(mfrc522);
+ *   desfire.SelectApplication(0x000001);
+ *   desfire.ReadData(0x01, 0, 0, imprime, NULL);
+ */
+#ifndef MFRC522Desfire_h
+#define MFRC522Desfire_h
+
+#include <Arduino.h>
+#include "MFRC522Extended.h"
+
+// Recebe um pedaço da resposta. Retorne false para interromper a troca.
+typedef bool (*ReceptorDesfire)(const byte *dados, byte tamanho, void *contexto);
+// Preenche o buffer com os próximos tamanho bytes a enviar. Retorne false para interromper a troca.
+typedef bool (*FonteDesfire)(byte *buffer, byte tamanho, void *contexto);
+
+class MFRC522Desfire
+{
+public:
+	// Comandos nativos
+	enum ComandoDesfire : byte
+	{
+		DESFIRE_CMD_GET_VERSION = 0x60,
+		DESFIRE_CMD_GET_APPLICATION_IDS = 0x6A,
+		DESFIRE_CMD_SELECT_APPLICATION = 0x5A,
+		DESFIRE_CMD_GET_FILE_IDS = 0x6F,
+		DESFIRE_CMD_READ_DATA = 0xBD,
+		DESFIRE_CMD_WRITE_DATA = 0x3D,
+		DESFIRE_CMD_ADDITIONAL_FRAME = 0xAF
+	};
+
+	// Códigos de status do PICC (veja GetLastStatus())
+	enum StatusDesfire : byte
+	{
+		DESFIRE_OPERATION_OK = 0x00,
+		DESFIRE_NO_CHANGES = 0x0C,
+		DESFIRE_ILLEGAL_COMMAND = 0x1C,
+		DESFIRE_INTEGRITY_ERROR = 0x1E,
+		DESFIRE_LENGTH_ERROR = 0x7E,
+		DESFIRE_PERMISSION_DENIED = 0x9D,
+		DESFIRE_PARAMETER_ERROR = 0x9E,
+		DESFIRE_APPLICATION_NOT_FOUND = 0xA0,
+		DESFIRE_AUTHENTICATION_ERROR = 0xAE,
+		DESFIRE_ADDITIONAL_FRAME = 0xAF,
+		DESFIRE_BOUNDARY_ERROR = 0xBE,
+		DESFIRE_FILE_NOT_FOUND = 0xF0,
+		DESFIRE_NO_RESPONSE = 0xFF // Nenhum status recebido (erro de transporte ou troca interrompida)
+	};
+
+	// Maior quadro DESFire trocado, com o cabeçalho ISO e o status
+	static constexpr byte TAMANHO_QUADRO = 64;
+	// Bytes de dados enviados por quadro (WriteData), de forma que o quadro caiba no FIFO do MFRC522
+	static constexpr byte TAMANHO_PEDACO = 48;
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Construtores
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522Desfire(MFRC522Extended &leitor, bool isoWrapping = false);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Comandos
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522::StatusCode GetApplicationIDs(ReceptorDesfire receptor, void *contexto);
+	MFRC522::StatusCode SelectApplication(uint32_t aid);
+	MFRC522::StatusCode GetFileIDs(ReceptorDesfire receptor, void *contexto);
+	MFRC522::StatusCode ReadData(byte fileNo, uint32_t offset, uint32_t length, ReceptorDesfire receptor, void *contexto);
+	MFRC522::StatusCode WriteData(byte fileNo, uint32_t offset, uint32_t length, FonteDesfire fonte, void *contexto);
+	MFRC522::StatusCode WriteData(byte fileNo, uint32_t offset, const byte *data, uint32_t length);
+	MFRC522::StatusCode Transceive(byte command, const byte *header, byte headerLength, uint32_t dataLength, FonteDesfire fonte, void *contextoFonte, ReceptorDesfire receptor, void *contextoReceptor);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções de suporte
+	/////////////////////////////////////////////////////////////////////////////////////
+	void SetIsoWrapping(bool isoWrapping) { _iso = isoWrapping; };
+	byte GetLastStatus() const { return _ultimoStatus; };
+
+protected:
+	MFRC522Extended &_leitor;
+	bool _iso;			 // true para encapsular os comandos em APDUs ISO/IEC 7816-4
+	byte _ultimoStatus;	 // Último StatusDesfire recebido
+
+	// Posição dos dados do comando no quadro: depois de CMD, ou de 90 CMD P1 P2 Lc
+	byte InicioDados() const { return _iso ? 5 : 1; };
+	MFRC522::StatusCode ExchangeFrame(byte comando, byte *quadro, byte tamanho, byte *resposta, const byte **dados, byte *tamanhoDados);
+	static void Write24(byte *destino, uint32_t valor);
+	static bool CopiaMemoria(byte *buffer, byte tamanho, void *contexto);
+};
+
+#endif
@@ -0,0 +1,375 @@
+/*
+ * MFRC522Dump.cpp - Despejo da memória de PICCs MIFARE Classic e Ultralight em texto ou binário.
+ * NOTA: Por favor, verifique também os comentários em MFRC522Dump.h
+ * Liberado para o domínio público.
+ */
+
+#include "MFRC522Dump.h"
+#include "MFRC522Layout.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+// MFRC522DumpReader
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Construtor.
+ */
+MFRC522DumpReader::MFRC522DumpReader(MFRC522 &leitor ///< Instância MFRC522 usada para a comunicação.
+									 )
+	: _leitor(leitor)
+{
+} // Fim do construtor
+
+/**
+ * Despeja o PICC selecionado inteiro: Begin(), os setores ou páginas e End().
+ * PICCs que não são MIFARE Classic nem Ultralight têm apenas o cabeçalho.
+ * O PICC é interrompido (HALT) no final.
+ */
+void MFRC522DumpReader::Read(MFRC522::Uid *uid,			  ///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+							 uint16_t atqa,				  ///< ATQA do PICC, ou 0 se desconhecido.
+							 MFRC522::MIFARE_Key *key,	  ///< Chave A usada para todos os setores MIFARE Classic.
+							 MFRC522DumpSink &sink,		  ///< Recebe o conteúdo.
+							 bool descending			  ///< true para despejar do endereço mais alto ao mais baixo.
+)
+{
+	MFRC522::PICC_Type piccType = MFRC522::PICC_GetType(uid->sak);
+	if (MifareClassicSectorCount(piccType))
+	{
+		sink.Begin(uid, atqa, piccType, 16);
+		ReadMifareClassic(uid, piccType, key, sink, descending);
+	}
+	else if (piccType == MFRC522::PICC_TYPE_MIFARE_UL)
+	{
+		sink.Begin(uid, atqa, piccType, 4);
+		ReadMifareUltralight(sink);
+		_leitor.PICC_HaltA();
+	}
+	else
+	{
+		sink.Begin(uid, atqa, piccType, 0);
+		_leitor.PICC_HaltA();
+	}
+	sink.End();
+} // Fim Read()
+
+/**
+ * Despeja todos os setores de um PICC MIFARE Classic.
+ * O PICC é interrompido (HALT) no final, antes de encerrar a sessão criptografada.
+ */
+void MFRC522DumpReader::ReadMifareClassic(MFRC522::Uid *uid,			///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+										  MFRC522::PICC_Type piccType,	///< Um dos enums PICC_Type.
+										  MFRC522::MIFARE_Key *key,		///< Chave A usada para todos os setores.
+										  MFRC522DumpSink &sink,		///< Recebe o conteúdo.
+										  bool descending				///< true para despejar do setor mais alto ao mais baixo.
+)
+{
+	byte setores = MifareClassicSectorCount(piccType); // 0 se não for MIFARE Classic
+	for (byte i = 0; i < setores; i++)
+	{
+		ReadMifareClassicSector(uid, key, descending ? setores - 1 - i : i, sink, descending);
+	}
+	_leitor.PICC_HaltA(); // Interrompe o PICC antes de encerrar a sessão criptografada.
+	_leitor.PCD_StopCrypto1();
+} // Fim ReadMifareClassic()
+
+/**
+ * Despeja um setor MIFARE Classic. Sempre usa PICC_CMD_MF_AUTH_KEY_A, porque apenas a Chave A pode
+ * sempre ler os bits de acesso do setor.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522DumpReader::ReadMifareClassicSector(MFRC522::Uid *uid,		 ///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+															   MFRC522::MIFARE_Key *key, ///< Chave A para o setor.
+															   byte sector,				 ///< O setor, 0..39.
+															   MFRC522DumpSink &sink,	 ///< Recebe o conteúdo.
+															   bool descending			 ///< true para despejar do trailer ao primeiro bloco.
+)
+{
+	if (sector >= 40)
+	{ // Nenhum PICC MIFARE Classic tem mais de 40 setores.
+		return MFRC522::STATUS_INVALID;
+	}
+	const byte numeroDeBlocos = MifareClassicGeometry::BlocksInSector(sector);
+	const byte primeiroBloco = MifareClassicGeometry::FirstBlock(sector);
+
+	MFRC522::StatusCode status = _leitor.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, primeiroBloco, key, uid);
+	sink.Sector(sector, primeiroBloco, numeroDeBlocos, status);
+	if (status != MFRC522::STATUS_OK)
+	{
+		return status;
+	}
+
+	byte buffer[18];
+	byte contadorDeBytes;
+	MFRC522::StatusCode resultado = MFRC522::STATUS_OK;
+	for (byte i = 0; i < numeroDeBlocos; i++)
+	{
+		byte enderecoDoBloco = primeiroBloco + (descending ? numeroDeBlocos - 1 - i : i);
+		contadorDeBytes = sizeof(buffer);
+		status = _leitor.MIFARE_Read(enderecoDoBloco, buffer, &contadorDeBytes);
+		sink.Block(enderecoDoBloco, (status == MFRC522::STATUS_OK) ? buffer : nullptr, status);
+		if (status != MFRC522::STATUS_OK)
+		{
+			resultado = status;
+		}
+	}
+	return resultado;
+} // Fim ReadMifareClassicSector()
+
+/**
+ * Despeja as 16 páginas de um PICC MIFARE Ultralight. O Ultralight C e os NTAG têm mais páginas.
+ */
+void MFRC522DumpReader::ReadMifareUltralight(MFRC522DumpSink &sink ///< Recebe o conteúdo.
+)
+{
+	byte buffer[18];
+	byte contadorDeBytes;
+	for (byte pagina = 0; pagina < 16; pagina += 4)
+	{ // A leitura retorna dados para 4 páginas de cada vez.
+		contadorDeBytes = sizeof(buffer);
+		MFRC522::StatusCode status = _leitor.MIFARE_Read(pagina, buffer, &contadorDeBytes);
+		if (status != MFRC522::STATUS_OK)
+		{
+			sink.Block(pagina, nullptr, status);
+			break;
+		}
+		for (byte deslocamento = 0; deslocamento < 4; deslocamento++)
+		{
+			sink.Block(pagina + deslocamento, &buffer[4 * deslocamento], status);
+		}
+	}
+} // Fim ReadMifareUltralight()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// MFRC522DumpText
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Exibe a linha de títulos das colunas.
+ */
+void MFRC522DumpText::Begin(const MFRC522::Uid *, uint16_t, MFRC522::PICC_Type, byte tamanhoBloco)
+{
+	_tamanhoBloco = tamanhoBloco;
+	if (tamanhoBloco == 16)
+	{
+		_saida.println(F("Setor Bloco   0  1  2  3   4  5  6  7   8  9 10 11  12 13 14 15  Bits de Acesso"));
+	}
+	else if (tamanhoBloco == 4)
+	{
+		_saida.println(F("Página  0  1  2  3"));
+	}
+} // Fim Begin()
+
+/**
+ * Prepara a exibição de um setor; se a autenticação falhou, exibe o erro na linha do trailer.
+ */
+void MFRC522DumpText::Sector(byte setor, byte primeiroBloco, byte numeroBlocos, MFRC522::StatusCode status)
+{
+	_tamanhoBloco = 16;
+	_setor = setor;
+	_trailer = true;
+	_erroInvertido = false;
+	memset(_g, 0, sizeof(_g));
+	if (status != MFRC522::STATUS_OK)
+	{
+		PrintPrefix(primeiroBloco + numeroBlocos - 1);
+		_saida.print(F("PCD_Authenticate() falhou: "));
+		_saida.println(MFRC522::GetStatusCodeName(status));
+	}
+} // Fim Sector()
+
+/**
+ * Exibe um bloco em hexadecimal. Nos blocos MIFARE Classic, também os bits de acesso do grupo e, nos
+ * Blocos de Valor, o valor e o endereço.
+ */
+void MFRC522DumpText::Block(byte endereco, const byte *dados, MFRC522::StatusCode status)
+{
+	if (_tamanhoBloco == 4)
+	{
+		if (status != MFRC522::STATUS_OK)
+		{
+			_saida.print(F("MIFARE_Read() falhou: "));
+			_saida.println(MFRC522::GetStatusCodeName(status));
+			return;
+		}
+		if (endereco < 10)
+			_saida.print(F("  ")); // Preenche com espaços
+		else
+			_saida.print(F(" ")); // Preenche com espaços
+		_saida.print(endereco);
+		_saida.print(F("  "));
+		for (byte indice = 0; indice < 4; indice++)
+		{
+			PrintHex(dados[indice]);
+		}
+		_saida.println();
+		return;
+	}
+
+	PrintPrefix(endereco);
+	if (status != MFRC522::STATUS_OK)
+	{
+		_saida.print(F("MIFARE_Read() falhou: "));
+		_saida.println(MFRC522::GetStatusCodeName(status));
+		return;
+	}
+	for (byte indice = 0; indice < 16; indice++)
+	{
+		PrintHex(dados[indice]);
+		if ((indice % 4) == 3)
+		{
+			_saida.print(F(" "));
+		}
+	}
+	// Os bits de acesso vêm do trailer, o primeiro bloco exibido do setor em ordem decrescente
+	if (MifareClassicGeometry::IsTrailer(endereco))
+	{
+		_erroInvertido = !MFRC522::MIFARE_GetAccessBits(&dados[6], _g);
+	}
+
+	// Em qual grupo de acesso está este bloco? Os blocos são exibidos do mais alto para o mais baixo,
+	// então o primeiro exibido de um grupo é o trailer ou aquele cujo bloco seguinte está em outro grupo.
+	byte grupo = MifareClassicGeometry::AccessGroup(endereco);
+	bool primeiroNoGrupo = (grupo == 3) || (grupo != MifareClassicGeometry::AccessGroup(endereco + 1));
+	if (primeiroNoGrupo)
+	{
+		_saida.print(F(" [ "));
+		_saida.print((_g[grupo] >> 2) & 1, DEC);
+		_saida.print(F(" "));
+		_saida.print((_g[grupo] >> 1) & 1, DEC);
+		_saida.print(F(" "));
+		_saida.print((_g[grupo] >> 0) & 1, DEC);
+		_saida.print(F(" ] "));
+		if (_erroInvertido)
+		{
+			_saida.print(F(" Bits de acesso invertidos não coincidem! "));
+		}
+	}
+
+	if (grupo != 3 && (_g[grupo] == 1 || _g[grupo] == 6))
+	{ // Não é um trailer de setor, um bloco de valor
+		int32_t valor = (int32_t(dados[3]) << 24) | (int32_t(dados[2]) << 16) | (int32_t(dados[1]) << 8) | int32_t(dados[0]);
+		_saida.print(F(" Valor=0x"));
+		_saida.print(valor, HEX);
+		_saida.print(F(" End=0x"));
+		_saida.print(dados[12], HEX);
+	}
+	_saida.println();
+} // Fim Block()
+
+/**
+ * Exibe as colunas do setor (apenas na primeira linha do setor) e do bloco.
+ */
+void MFRC522DumpText::PrintPrefix(byte endereco)
+{
+	if (_trailer)
+	{
+		if (_setor < 10)
+			_saida.print(F("   ")); // Preenche com espaços
+		else
+			_saida.print(F("  ")); // Preenche com espaços
+		_saida.print(_setor);
+		_saida.print(F("   "));
+		_trailer = false;
+	}
+	else
+	{
+		_saida.print(F("       "));
+	}
+	if (endereco < 10)
+		_saida.print(F("   ")); // Preenche com espaços
+	else if (endereco < 100)
+		_saida.print(F("  ")); // Preenche com espaços
+	else
+		_saida.print(F(" ")); // Preenche com espaços
+	_saida.print(endereco);
+	_saida.print(F("  "));
+} // Fim PrintPrefix()
+
+/**
+ * Exibe um byte como " XX".
+ */
+void MFRC522DumpText::PrintHex(byte valor)
+{
+	_saida.print(valor < 0x10 ? F(" 0") : F(" "));
+	_saida.print(valor, HEX);
+} // Fim PrintHex()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// MFRC522DumpBinary
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Escreve o cabeçalho e inicia o CRC32.
+ */
+void MFRC522DumpBinary::Begin(const MFRC522::Uid *uid, uint16_t atqa, MFRC522::PICC_Type tipo, byte tamanhoBloco)
+{
+	byte cabecalho[20] = {'M', 'F', 'D', VERSAO_BINARIO, (byte)tipo, uid->sak, (byte)(atqa & 0xFF), (byte)(atqa >> 8), uid->size};
+	memcpy(&cabecalho[9], uid->uidByte, (uid->size <= 10) ? uid->size : 10);
+	cabecalho[19] = tamanhoBloco;
+	_tamanhoBloco = tamanhoBloco;
+	_crc = 0xFFFFFFFF;
+	Emit(cabecalho, sizeof(cabecalho));
+} // Fim Begin()
+
+/**
+ * Escreve o registro de um setor.
+ */
+void MFRC522DumpBinary::Sector(byte setor, byte primeiroBloco, byte numeroBlocos, MFRC522::StatusCode status)
+{
+	const byte registro[5] = {'S', setor, primeiroBloco, numeroBlocos, (byte)status};
+	Emit(registro, sizeof(registro));
+} // Fim Sector()
+
+/**
+ * Escreve o registro de um bloco, com os dados se a leitura teve sucesso.
+ */
+void MFRC522DumpBinary::Block(byte endereco, const byte *dados, MFRC522::StatusCode status)
+{
+	const byte registro[3] = {'B', endereco, (byte)status};
+	Emit(registro, sizeof(registro));
+	if (status == MFRC522::STATUS_OK && dados)
+	{
+		Emit(dados, _tamanhoBloco);
+	}
+} // Fim Block()
+
+/**
+ * Escreve o registro final com o CRC32.
+ */
+void MFRC522DumpBinary::End()
+{
+	const byte marca = 'E';
+	Emit(&marca, 1);
+	const uint32_t crc = ~_crc;
+	const byte registro[4] = {(byte)(crc & 0xFF), (byte)((crc >> 8) & 0xFF), (byte)((crc >> 16) & 0xFF), (byte)(crc >> 24)};
+	_saida.write(registro, sizeof(registro));
+} // Fim End()
+
+/**
+ * Acrescenta bytes a um CRC32 (IEEE 802.3, polinômio refletido 0xEDB88320) em cálculo.
+ * Comece com 0xFFFFFFFF e inverta o resultado final. Calculado bit a bit, sem tabela na flash.
+ *
+ * @return O CRC32 atualizado.
+ */
+uint32_t MFRC522DumpBinary::UpdateCrc32(uint32_t crc, const byte *dados, uint16_t tamanho)
+{
+	while (tamanho--)
+	{
+		crc ^= *dados++;
+		for (byte bit = 0; bit < 8; bit++)
+		{
+			crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+		}
+	}
+	return crc;
+} // Fim UpdateCrc32()
+
+/**
+ * Escreve bytes na saída e os acrescenta ao CRC32.
+ */
+void MFRC522DumpBinary::Emit(const byte *dados, byte tamanho)
+{
+	_crc = UpdateCrc32(_crc, dados, tamanho);
+	_saida.write(dados, tamanho);
+} // Fim Emit()
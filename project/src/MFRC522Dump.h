@@ -0,0 +1,109 @@
+/**
+ * Despejo (dump) da memória de PICCs MIFARE Classic e Ultralight para qualquer Print.
+ *
+ * MFRC522DumpReader lê o PICC e entrega o resultado, setor por setor e bloco por bloco, a um
+ * MFRC522DumpSink. Há dois formatos:
+ *   MFRC522DumpText   - o texto em hexadecimal de PICC_DumpToSerial() (uma linha por bloco, com os bits de acesso);
+ *                       os bits de acesso vêm do trailer, então use a ordem decrescente.
+ *   MFRC522DumpBinary - um formato binário compacto, ~6x menor que o texto, para gravar em um File do cartão SD
+ *                       ou enviar a um computador; extras/mfrc522_dump.py converte para hexadecimal ou JSON e
+ *                       compara dois despejos.
+ *
+ * Formato binário (valores de 16 e 32 bits com o LSB primeiro):
+ *   Cabeçalho: 'M' 'F' 'D' VERSAO_BINARIO, PICC_Type, SAK, ATQA (2), tamanho do UID, UID (10, completado
+ *              com zeros), tamanho do bloco (16 no MIFARE Classic, 4 no Ultralight)
+ *   Setor:     'S', setor, primeiro bloco, número de blocos, StatusCode da autenticação
+ *   Bloco:     'B', endereço, StatusCode da leitura, e os dados (tamanho do bloco) apenas se STATUS_OK
+ *   Fim:       'E', CRC32 (IEEE 802.3) de todos os bytes anteriores, incluindo o 'E'
+ *
+ * Ex.: despejo binário em um arquivo
+ *   File arquivo = SD.open("cartao.mfd", FILE_WRITE);
+ *   MFRC522DumpBinary binario(arquivo);
+ *   MFRC522DumpReader(mfrc522).Read(&mfrc522.uid, 0, &chave, binario, false);
+ *   arquivo.close();
+ */
+#ifndef MFRC522Dump_h
+#define MFRC522Dump_h
+
+#include <Arduino.h>
+#include "MFRC522.h"
+
+// Recebe o conteúdo lido por MFRC522DumpReader
+class MFRC522DumpSink
+{
+public:
+	virtual ~MFRC522DumpSink() {};
+	// Início do despejo de um PICC; atqa é 0 se desconhecido
+	virtual void Begin(const MFRC522::Uid *uid, uint16_t atqa, MFRC522::PICC_Type tipo, byte tamanhoBloco) = 0;
+	// Início de um setor MIFARE Classic, com o resultado da autenticação; os blocos vêm em seguida se STATUS_OK
+	virtual void Sector(byte setor, byte primeiroBloco, byte numeroBlocos, MFRC522::StatusCode status) = 0;
+	// Um bloco (ou página); dados é nullptr se status não for STATUS_OK
+	virtual void Block(byte endereco, const byte *dados, MFRC522::StatusCode status) = 0;
+	virtual void End() = 0;
+};
+
+class MFRC522DumpReader
+{
+public:
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Construtores
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522DumpReader(MFRC522 &leitor);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções de leitura
+	/////////////////////////////////////////////////////////////////////////////////////
+	void Read(MFRC522::Uid *uid, uint16_t atqa, MFRC522::MIFARE_Key *key, MFRC522DumpSink &sink, bool descending);
+	void ReadMifareClassic(MFRC522::Uid *uid, MFRC522::PICC_Type piccType, MFRC522::MIFARE_Key *key, MFRC522DumpSink &sink, bool descending);
+	MFRC522::StatusCode ReadMifareClassicSector(MFRC522::Uid *uid, MFRC522::MIFARE_Key *key, byte sector, MFRC522DumpSink &sink, bool descending);
+	void ReadMifareUltralight(MFRC522DumpSink &sink);
+
+protected:
+	MFRC522 &_leitor;
+};
+
+class MFRC522DumpText : public MFRC522DumpSink
+{
+public:
+	MFRC522DumpText(Print &saida) : _saida(saida), _trailer(false), _erroInvertido(false) {};
+
+	void Begin(const MFRC522::Uid *uid, uint16_t atqa, MFRC522::PICC_Type tipo, byte tamanhoBloco) override;
+	void Sector(byte setor, byte primeiroBloco, byte numeroBlocos, MFRC522::StatusCode status) override;
+	void Block(byte endereco, const byte *dados, MFRC522::StatusCode status) override;
+	void End() override {};
+
+protected:
+	Print &_saida;
+	byte _tamanhoBloco;
+	byte _setor;
+	bool _trailer;		  // true até o primeiro bloco do setor ser exibido (o trailer, em ordem decrescente)
+	bool _erroInvertido;  // Os bits de acesso invertidos do trailer não coincidem
+	byte _g[4];			  // Bits de acesso do setor, veja MIFARE_GetAccessBits()
+
+	void PrintPrefix(byte endereco);
+	void PrintHex(byte valor);
+};
+
+class MFRC522DumpBinary : public MFRC522DumpSink
+{
+public:
+	static constexpr byte VERSAO_BINARIO = 1;
+
+	MFRC522DumpBinary(Print &saida) : _saida(saida), _crc(0) {};
+
+	void Begin(const MFRC522::Uid *uid, uint16_t atqa, MFRC522::PICC_Type tipo, byte tamanhoBloco) override;
+	void Sector(byte setor, byte primeiroBloco, byte numeroBlocos, MFRC522::StatusCode status) override;
+	void Block(byte endereco, const byte *dados, MFRC522::StatusCode status) override;
+	void End() override;
+
+	static uint32_t UpdateCrc32(uint32_t crc, const byte *dados, uint16_t tamanho);
+
+protected:
+	Print &_saida;
+	uint32_t _crc;		// CRC32 em cálculo (sem a inversão final)
+	byte _tamanhoBloco;
+
+	void Emit(const byte *dados, byte tamanho);
+};
+
+#endif
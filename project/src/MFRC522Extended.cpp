@@ -6,6 +6,7 @@
  */
 
 #include "MFRC522Extended.h"
+#include "MFRC522Identify.h"
 
 /////////////////////////////////////////////////////////////////////////////////////
 // Funções para comunicação com PICCs
@@ -46,6 +47,7 @@ MFRC522::StatusCode MFRC522Extended::PICC_Select(Uid *uid, byte validBits)
 	byte ultimosBitsTx;
 	byte *bufferResposta;
 	byte comprimentoResposta;
+	byte bytesParaCopiar;
 
 	// Verificações de validade
 	if (validBits > 80)
@@ -98,7 +100,7 @@ MFRC522::StatusCode MFRC522Extended::PICC_Select(Uid *uid, byte validBits)
 		{
 			buffer[indice++] = PICC_CMD_CT;
 		}
-		byte bytesParaCopiar = bitsConhecidosNivelAtual / 8 + (bitsConhecidosNivelAtual % 8 ? 1 : 0);
+		bytesParaCopiar = bitsConhecidosNivelAtual / 8 + (bitsConhecidosNivelAtual % 8 ? 1 : 0);
 		if (bytesParaCopiar)
 		{
 			byte maxBytes = usarEtiquetaCascata ? 3 : 4;
@@ -202,6 +204,13 @@ MFRC522::StatusCode MFRC522Extended::PICC_Select(Uid *uid, byte validBits)
 		{
 			return STATUS_CRC_WRONG;
 		}
+		// Copia os bytes de UID encontrados de buffer[] para uid->uidByte[]
+		indice = (buffer[2] == PICC_CMD_CT) ? 3 : 2;
+		bytesParaCopiar = (buffer[2] == PICC_CMD_CT) ? 3 : 4;
+		for (contador = 0; contador < bytesParaCopiar; contador++)
+		{
+			uid->uidByte[indiceUID + contador] = buffer[indice++];
+		}
 		if (bufferResposta[0] & 0x04)
 		{
 			nivelCascata++;
@@ -212,113 +221,39 @@ MFRC522::StatusCode MFRC522Extended::PICC_Select(Uid *uid, byte validBits)
 			uid->sak = bufferResposta[0];
 		}
 	}
-}
 
-// Define o tamanho correto de uid->size
-uid->size = 3 * nivelCascata + 1;
+	// Define o tamanho correto de uid->size
+	uid->size = 3 * nivelCascata + 1;
 
-// SE o bit 6 do SAK for 1, então é ISO/IEC 14443-4 (T=CL)
-// Um comando Request ATS deve ser enviado
-// Também verificamos se o bit 3 do SAK é zero, pois isso indica um UID completo (1 indicaria que está incompleto)
-if ((uid->sak & 0x24) == 0x20)
-{
-	Ats ats;
-	resultado = PICC_RequestATS(&ats);
-	if (resultado == STATUS_OK)
+	// SE o bit 6 do SAK for 1, então é ISO/IEC 14443-4 (T=CL)
+	// Um comando Request ATS deve ser enviado
+	// Também verificamos se o bit 3 do SAK é zero, pois isso indica um UID completo (1 indicaria que está incompleto)
+	if ((uid->sak & 0x24) == 0x20)
 	{
-		// Verifica o ATS
-		if (ats.size > 0)
+		if (uid != &tag.uid)
 		{
-			// TA1 foi transmitido?
-			// PPS deve ser suportado...
-			if (ats.ta1.transmitted)
-			{
-				// TA1
-				//  8 | 7 | 6 | 5 | 4 | 3 | 2 | 1 | Descrição
-				// ---+---+---+---+---+---+---+---+------------------------------------------
-				//  0 | - | - | - | 0 | - | - | - | Diferente D para cada direção suportada
-				//  1 | - | - | - | 0 | - | - | - | Somente o mesmo D para ambas as direções suportadas
-				//  - | x | x | x | 0 | - | - | - | DS (Enviar D)
-				//  - | - | - | - | 0 | x | x | x | DR (Receber D)
-				//
-				// Tabela de D para taxa de bits
-				//  3 | 2 | 1 | Valor
-				// ---+---+---+-----------------------------
-				//  1 | - | - | 848 kBaud é suportado
-				//  - | 1 | - | 424 kBaud é suportado
-				//  - | - | 1 | 212 kBaud é suportado
-				//  0 | 0 | 0 | Apenas 106 kBaud é suportado
-				//
-				// Nota: 106 kBaud é sempre suportado
-				//
-				// Eu tenho quase constantes tempos limite ao alterar as velocidades :(
-				// padrão nunca usado, apenas declarado
-				// TagBitRates ds = BITRATE_106KBITS;
-				// TagBitRates dr = BITRATE_106KBITS;
-				TagBitRates ds;
-				TagBitRates dr;
-
-				//// TODO Não está funcionando em 848 ou 424
-				// if (ats.ta1.ds & 0x04)
-				//{
-				//   ds = BITRATE_848KBITS;
-				// }
-				// else if (ats.ta1.ds & 0x02)
-				//{
-				//   ds = BITRATE_424KBITS;
-				// }
-				// else if (ats.ta1.ds & 0x01)
-				//{
-				//   ds = BITRATE_212KBITS;
-				// }
-				// else
-				//{
-				//   ds = BITRATE_106KBITS;
-				// }
-
-				if (ats.ta1.ds & 0x01)
-				{
-					ds = BITRATE_212KBITS;
-				}
-				else
-				{
-					ds = BITRATE_106KBITS;
-				}
-
-				//// Não está funcionando em 848 ou 424
-				// if (ats.ta1.dr & 0x04)
-				//{
-				//   dr = BITRATE_848KBITS;
-				// }
-				// else if (ats.ta1.dr & 0x02)
-				//{
-				//   dr = BITRATE_424KBITS;
-				// }
-				// else if (ats.ta1.dr & 0x01)
-				//{
-				//   dr = BITRATE_212KBITS;
-				// }
-				// else
-				//{
-				//   dr = BITRATE_106KBITS;
-				// }
-
-				if (ats.ta1.dr & 0x01)
-				{
-					dr = BITRATE_212KBITS;
-				}
-				else
-				{
-					dr = BITRATE_106KBITS;
-				}
+			tag.uid = *uid;
+		}
+		tag.numeroBloco = false;
+		tag.taxaDs = BITRATE_106KBITS;
+		tag.taxaDr = BITRATE_106KBITS;
 
-				PICC_PPS(ds, dr);
-			}
+		resultado = PICC_RequestATS(&tag.ats);
+		// O PICC pode precisar de um tempo de guarda (SFGT) depois do ATS antes de receber o próximo quadro
+		if (resultado == STATUS_OK && tag.ats.tb1.sfgi > 0 && tag.ats.tb1.sfgi < 15)
+		{
+			uint32_t sfgt = TCL_GuardTime(tag.ats.tb1.sfgi);
+			delay(sfgt / 1000);
+			delayMicroseconds(sfgt % 1000);
+		}
+		// TA1 foi transmitido? PPS deve ser suportado...
+		if (resultado == STATUS_OK && tag.ats.tamanho > 0 && tag.ats.ta1.transmitido)
+		{
+			return PICC_NegotiateBitRate(uid);
 		}
 	}
-}
 
-return STATUS_OK;
+	return STATUS_OK;
 } // Fim de PICC_Select()
 
 /**
@@ -367,7 +302,7 @@ MFRC522::StatusCode MFRC522Extended::PICC_RequestATS(Ats *ats)
 	}
 
 	// Definir os dados da estrutura ats
-	ats->size = bufferATS[0];
+	ats->tamanho = bufferATS[0];
 
 	// Byte T0:
 	//
@@ -384,12 +319,12 @@ MFRC522::StatusCode MFRC522Extended::PICC_RequestATS(Ats *ats)
 	// FSC (bytes) |  16 |  24 |  32 |  40 |  48 |  64 |  96 | 128 | 256 | RFU > 256
 	//
 	// O valor padrão de FSCI é 2 (32 bytes)
-	if (ats->size > 0x01)
+	if (ats->tamanho > 0x01)
 	{
 		// TC1, TB1 e TA1 NÃO foram transmitidos
-		ats->ta1.transmitido = (bool)(bufferATS[1] & 0x40);
+		ats->ta1.transmitido = (bool)(bufferATS[1] & 0x10);
 		ats->tb1.transmitido = (bool)(bufferATS[1] & 0x20);
-		ats->tc1.transmitido = (bool)(bufferATS[1] & 0x10);
+		ats->tc1.transmitido = (bool)(bufferATS[1] & 0x40);
 
 		// Decodificar FSCI
 		switch (bufferATS[1] & 0x0F)
@@ -432,8 +367,8 @@ MFRC522::StatusCode MFRC522Extended::PICC_RequestATS(Ats *ats)
 		if (ats->ta1.transmitido)
 		{
 			ats->ta1.mesmoD = (bool)(bufferATS[2] & 0x80);
-			ats->ta1.ds = (TagBitRates)((bufferATS[2] & 0x70) >> 4);
-			ats->ta1.dr = (TagBitRates)(bufferATS[2] & 0x07);
+			ats->ta1.ds = (TaxasBitTag)((bufferATS[2] & 0x70) >> 4);
+			ats->ta1.dr = (TaxasBitTag)(bufferATS[2] & 0x07);
 		}
 		else
 		{
@@ -456,7 +391,7 @@ MFRC522::StatusCode MFRC522Extended::PICC_RequestATS(Ats *ats)
 		else
 		{
 			// Padrões para TB1
-			ats->tb1.fwi = 0;  // TODO: Não sei o padrão para isso!
+			ats->tb1.fwi = 4;  // O valor padrão de FWI é 4 (FWT ~4,8ms), ISO/IEC 14443-4 5.2.5
 			ats->tb1.sfgi = 0; // O valor padrão de SFGI é 0 (o que significa que o cartão não precisa de nenhum SFGT específico)
 		}
 
@@ -470,14 +405,14 @@ MFRC522::StatusCode MFRC522Extended::PICC_RequestATS(Ats *ats)
 			if (ats->tb1.transmitido)
 				tc1Index++;
 
-			ats->tc1.supportsCID = (bool)(bufferATS[tc1Index] & 0x02);
-			ats->tc1.supportsNAD = (bool)(bufferATS[tc1Index] & 0x01);
+			ats->tc1.suportaCID = (bool)(bufferATS[tc1Index] & 0x02);
+			ats->tc1.suportaNAD = (bool)(bufferATS[tc1Index] & 0x01);
 		}
 		else
 		{
 			// Padrões para TC1
-			ats->tc1.supportsCID = true;
-			ats->tc1.supportsNAD = false;
+			ats->tc1.suportaCID = true;
+			ats->tc1.suportaNAD = false;
 		}
 	}
 	else
@@ -497,16 +432,16 @@ MFRC522::StatusCode MFRC522Extended::PICC_RequestATS(Ats *ats)
 
 		// Padrões para TB1
 		ats->tb1.transmitido = false;
-		ats->tb1.fwi = 0;  // TODO: Não sei o padrão para isso!
+		ats->tb1.fwi = 4;  // O valor padrão de FWI é 4 (FWT ~4,8ms), ISO/IEC 14443-4 5.2.5
 		ats->tb1.sfgi = 0; // O valor padrão de SFGI é 0 (o que significa que o cartão não precisa de nenhum SFGT específico)
 
 		// Padrões para TC1
 		ats->tc1.transmitido = false;
-		ats->tc1.supportsCID = true;
-		ats->tc1.supportsNAD = false;
+		ats->tc1.suportaCID = true;
+		ats->tc1.suportaNAD = false;
 	}
 
-	memcpy(ats->data, bufferATS, bufferSize - 2);
+	memcpy(ats->dados, bufferATS, bufferSize - 2);
 
 	return resultado;
 } // Fim de PICC_RequestATS()
@@ -539,12 +474,8 @@ MFRC522::StatusCode MFRC522Extended::PICC_PPS()
 	resultado = PCD_TransceiveData(bufferPPS, 4, bufferPPS, &tamanhoBufferPPS, NULL, 0, true);
 	if (resultado == STATUS_OK)
 	{
-		// Habilitar CRC para T=CL
-		byte registroTx = PCD_ReadRegister(TxModeReg) | 0x80;
-		byte registroRx = PCD_ReadRegister(RxModeReg) | 0x80;
-
-		PCD_WriteRegister(TxModeReg, registroTx);
-		PCD_WriteRegister(RxModeReg, registroRx);
+		// Habilitar CRC para T=CL, mantendo 106 kBd
+		PCD_SetBitRate(BITRATE_106KBITS, BITRATE_106KBITS, true);
 	}
 
 	return resultado;
@@ -555,8 +486,8 @@ MFRC522::StatusCode MFRC522Extended::PICC_PPS()
  *
  * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
  */
-MFRC522::StatusCode MFRC522Extended::PICC_PPS(TagBitRates taxaEnvio,   ///< DS
-											  TagBitRates taxaRecepcao ///< DR
+MFRC522::StatusCode MFRC522Extended::PICC_PPS(TaxasBitTag taxaEnvio,	///< DS: PICC -> PCD
+											  TaxasBitTag taxaRecepcao ///< DR: PCD -> PICC
 )
 {
 	StatusCode resultado;
@@ -569,10 +500,8 @@ MFRC522::StatusCode MFRC522Extended::PICC_PPS(TagBitRates taxaEnvio,   ///< DS
 	bufferPPS[0] = 0xD0; // O CID é fixo como 0 em RATS
 	bufferPPS[1] = 0x11; // PPS0 indica se o PPS1 está presente
 
-	// Bit 8 - Definido como '0', já que o MFRC522 permite diferentes taxas de bits para envio e recebimento
-	// Bit 4 - Definido como '0', pois é Reservado para uso futuro.
-	// bufferPPS[2] = (((taxaEnvio & 0x03) << 4) | (taxaRecepcao & 0x03)) & 0xE7;
-	bufferPPS[2] = (((taxaEnvio & 0x03) << 2) | (taxaRecepcao & 0x03)) & 0xE7;
+	// PPS1: b4-b3 DSI (PICC -> PCD), b2-b1 DRI (PCD -> PICC), os demais bits são RFU (0)
+	bufferPPS[2] = ((taxaEnvio & 0x03) << 2) | (taxaRecepcao & 0x03);
 
 	// Calcular o CRC_A
 	resultado = PCD_CalculateCRC(bufferPPS, 3, &bufferPPS[3]);
@@ -589,48 +518,8 @@ MFRC522::StatusCode MFRC522Extended::PICC_PPS(TagBitRates taxaEnvio,   ///< DS
 		// Deveríamos receber nosso byte PPS e 2 bytes de CRC
 		if ((tamanhoBufferPPS == 3) && (bufferPPS[0] == 0xD0))
 		{
-			byte registroTx = PCD_ReadRegister(TxModeReg) & 0x8F;
-			byte registroRx = PCD_ReadRegister(RxModeReg) & 0x8F;
-
-			// Configurar taxa de bits e habilitar CRC para T=CL
-			registroTx = (registroTx & 0x8F) | ((taxaRecepcao & 0x03) << 4) | 0x80;
-			registroRx = (registroRx & 0x8F) | ((taxaEnvio & 0x03) << 4) | 0x80;
-			registroRx &= 0xF0; // Garantir que isso já esteja configurado
-
-			// De ConfigIsoType
-			// registroRx |= 0x06;
-
-			PCD_WriteRegister(TxModeReg, registroTx);
-			PCD_WriteRegister(RxModeReg, registroRx);
-
-			// A 212 kBps
-			switch (taxaEnvio)
-			{
-			case BITRATE_212KBITS:
-			{
-				// PCD_WriteRegister(ModWidthReg, 0x13);
-				PCD_WriteRegister(ModWidthReg, 0x15);
-			}
-			break;
-			case BITRATE_424KBITS:
-			{
-				PCD_WriteRegister(ModWidthReg, 0x0A);
-			}
-			break;
-			case BITRATE_848KBITS:
-			{
-				PCD_WriteRegister(ModWidthReg, 0x05);
-			}
-			break;
-			default:
-			{
-				PCD_WriteRegister(ModWidthReg, 0x26); // Valor padrão
-			}
-			break;
-			}
-
-			// PCD_WriteRegister(RxThresholdReg, 0x84); // ISO-14443.4 Tipo A (padrão)
-			// PCD_WriteRegister(ControlReg, 0x10);
+			// Nova taxa de bits e CRC em hardware para T=CL
+			PCD_SetBitRate(taxaEnvio, taxaRecepcao, true);
 
 			delayMicroseconds(10);
 		}
@@ -643,275 +532,577 @@ MFRC522::StatusCode MFRC522Extended::PICC_PPS(TagBitRates taxaEnvio,   ///< DS
 	return resultado;
 } // Fim de PICC_PPS()
 
-/////////////////////////////////////////////////////////////////////////////////////
-// Funções para comunicação com cartões ISO/IEC 14433-4
-/////////////////////////////////////////////////////////////////////////////////////
-
-MFRC522::StatusCode MFRC522Extended::TCL_Transceive(PcbBlock *enviar, PcbBlock *retorno)
+/**
+ * Escolhe a maior taxa de bits suportada pelo PICC (TA1 do ATS) até o limite guardado para o tipo de PICC,
+ * envia o PPS e testa o enlace com um bloco R(NAK), que o PICC responde com R(ACK) sem alterar seu estado.
+ *
+ * Se o PPS ou o teste falharem, o limite do tipo de PICC é reduzido em um passo e o PICC é ativado novamente
+ * (campo desligado, WUPA, SELECT, RATS), até 106 kBd. O limite reduzido vale para as próximas seleções.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Extended::PICC_NegotiateBitRate(Uid *uid ///< Uid do PICC selecionado, usado para ativá-lo novamente.
+)
 {
 	MFRC522::StatusCode resultado;
-	byte bufferEntrada[FIFO_SIZE];
-	byte tamanhoBufferEntrada = FIFO_SIZE;
-	byte bufferSaida[enviar->inf.size + 5]; // PCB + CID + NAD + INF + EPILOGUE (CRC)
-	byte offsetBufferSaida = 1;
-	byte offsetBufferEntrada = 1;
-
-	// Definir o byte PCB
-	bufferSaida[0] = enviar->prologue.pcb;
-
-	// Definir o byte CID, se disponível
-	if (enviar->prologue.pcb & 0x08)
-	{
-		bufferSaida[offsetBufferSaida] = enviar->prologue.cid;
-		offsetBufferSaida++;
-	}
-
-	// Definir o byte NAD, se disponível
-	if (enviar->prologue.pcb & 0x04)
+	const TaxasBitTag limite = PCD_GetBitRateLimit(PICC_GetType(&tag));
+
+	// TA1
+	//  8 | 7 | 6 | 5 | 4 | 3 | 2 | 1 | Descrição
+	// ---+---+---+---+---+---+---+---+------------------------------------------
+	//  0 | - | - | - | 0 | - | - | - | Diferente D para cada direção suportada
+	//  1 | - | - | - | 0 | - | - | - | Somente o mesmo D para ambas as direções suportadas
+	//  - | x | x | x | 0 | - | - | - | DS (Enviar D)
+	//  - | - | - | - | 0 | x | x | x | DR (Receber D)
+	//
+	// Tabela de D para taxa de bits
+	//  3 | 2 | 1 | Valor
+	// ---+---+---+-----------------------------
+	//  1 | - | - | 848 kBaud é suportado
+	//  - | 1 | - | 424 kBaud é suportado
+	//  - | - | 1 | 212 kBaud é suportado
+	//  0 | 0 | 0 | Apenas 106 kBaud é suportado
+	//
+	// Nota: 106 kBaud é sempre suportado
+	TaxasBitTag ds = MaiorTaxa(tag.ats.ta1.ds, limite);
+	TaxasBitTag dr = MaiorTaxa(tag.ats.ta1.dr, limite);
+	if (tag.ats.ta1.mesmoD)
 	{
-		bufferSaida[offsetBufferSaida] = enviar->prologue.nad;
-		offsetBufferSaida++;
+		ds = dr = (ds < dr) ? ds : dr;
 	}
 
-	// Copiar o campo INF, se disponível
-	if (enviar->inf.size > 0)
+	if (ds == BITRATE_106KBITS && dr == BITRATE_106KBITS)
 	{
-		memcpy(&bufferSaida[offsetBufferSaida], enviar->inf.data, enviar->inf.size);
-		offsetBufferSaida += enviar->inf.size;
+		// Nada a negociar: apenas o CRC em hardware para T=CL
+		PCD_SetBitRate(BITRATE_106KBITS, BITRATE_106KBITS, true);
+		return STATUS_OK;
 	}
 
-	// O CRC está habilitado para transmissão?
-	byte registroTxMode = PCD_ReadRegister(TxModeReg);
-	if ((registroTxMode & 0x80) != 0x80)
+	resultado = PICC_PPS(ds, dr);
+	if (resultado == STATUS_OK)
 	{
-		// Calcular o CRC_A
-		resultado = PCD_CalculateCRC(bufferSaida, offsetBufferSaida, &bufferSaida[offsetBufferSaida]);
-		if (resultado != STATUS_OK)
+		// R(NAK) com o número de bloco atual do PCD (0); CID 0 se o PICC o suporta
+		BlocoPcb enviar;
+		BlocoPcb resposta;
+		enviar.prologo.pcb = tag.ats.tc1.suportaCID ? 0xBA : 0xB2;
+		enviar.prologo.cid = 0x00;
+		enviar.prologo.nad = 0x00;
+		enviar.inf.tamanho = 0;
+		enviar.inf.dados = NULL;
+		resposta.inf.dados = NULL; // R(ACK) não tem INF
+		resposta.inf.tamanho = 0;
+		const uint32_t timeoutAnterior = PCD_GetTimeout();
+		PCD_SetTimeout(TCL_FrameWaitingTime(tag.ats.tb1.fwi));
+		resultado = TCL_Transceive(&enviar, &resposta);
+		PCD_SetTimeout(timeoutAnterior);
+		if (resultado == STATUS_OK && (resposta.prologo.pcb & 0xF6) != 0xA2)
 		{
-			return resultado;
+			resultado = STATUS_ERROR; // Não é um R(ACK)
 		}
-
-		offsetBufferSaida += 2;
 	}
+	if (resultado == STATUS_OK)
+	{
+		tag.taxaDs = ds;
+		tag.taxaDr = dr;
+		return STATUS_OK;
+	}
+
+	// Um passo abaixo da maior taxa tentada, e o PICC precisa ser ativado novamente a 106 kBd.
+	PCD_LowerBitRateLimit(PICC_GetType(&tag), (ds > dr) ? ds : dr);
+	return PICC_Reactivate(uid);
+} // Fim de PICC_NegotiateBitRate()
+
+/**
+ * Desliga o campo para levar o PICC ao estado POWER-OFF e o ativa novamente com WUPA e PICC_Select().
+ * Usado quando a comunicação a uma taxa de bits alta falhou e o PICC não pode mais ser desselecionado.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Extended::PICC_Reactivate(Uid *uid)
+{
+	byte bufferATQA[2];
+	byte tamanho = sizeof(bufferATQA);
+
+	PCD_SetBitRate(BITRATE_106KBITS, BITRATE_106KBITS, false);
+	PCD_AntennaOff();
+	delay(5); // O PICC precisa perder a energia para sair do estado ACTIVE
+	PCD_AntennaOn();
+	delay(5); // Tempo de inicialização do PICC no campo
 
-	// Transmitir o bloco
-	resultado = PCD_TransceiveData(bufferSaida, offsetBufferSaida, bufferEntrada, &tamanhoBufferEntrada);
+	MFRC522::StatusCode resultado = PICC_WakeupA(bufferATQA, &tamanho);
 	if (resultado != STATUS_OK)
 	{
 		return resultado;
 	}
+	return PICC_Select(uid, uid->size * 8);
+} // Fim de PICC_Reactivate()
 
-	// Queremos transformar o array recebido de volta em um PcbBlock
-	retorno->prologue.pcb = bufferEntrada[0];
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções para configurar a taxa de bits
+/////////////////////////////////////////////////////////////////////////////////////
 
-	// O byte CID está presente?
-	if (enviar->prologue.pcb & 0x08)
+// Largura da modulação do transmissor (ModWidthReg) para cada taxa PCD -> PICC
+static constexpr byte LARGURA_MODULACAO[4] = {0x26, 0x15, 0x0A, 0x05};
+// Limiar do receptor (RxThresholdReg: MinLevel, CollLevel) para cada taxa PICC -> PCD. A subportadora
+// é mais curta nas taxas altas e o nível mínimo mais baixo evita que bits sejam perdidos como ruído.
+static constexpr byte LIMIAR_RECEPTOR[4] = {0x84, 0x84, 0x55, 0x55};
+
+/**
+ * Configura a taxa de bits e o CRC em hardware no MFRC522: TxModeReg, RxModeReg, ModWidthReg e RxThresholdReg.
+ * Os registros só são escritos se a configuração mudou.
+ */
+void MFRC522Extended::PCD_SetBitRate(TaxasBitTag ds,   ///< Taxa PICC -> PCD (recepção do MFRC522).
+									 TaxasBitTag dr,   ///< Taxa PCD -> PICC (transmissão do MFRC522).
+									 bool crc		   ///< true para o MFRC522 gerar e verificar o CRC_A (T=CL).
+)
+{
+	const byte configuracao = (crc ? 0x80 : 0x00) | ((ds & 0x03) << 2) | (dr & 0x03);
+	if (configuracao == _configuracaoTaxa)
 	{
-		retorno->prologue.cid = bufferEntrada[offsetBufferEntrada];
-		offsetBufferEntrada++;
+		return;
 	}
+	PCD_WriteRegister(TxModeReg, (crc ? 0x80 : 0x00) | ((dr & 0x03) << 4));
+	PCD_WriteRegister(RxModeReg, (crc ? 0x80 : 0x00) | ((ds & 0x03) << 4));
+	PCD_WriteRegister(ModWidthReg, LARGURA_MODULACAO[dr & 0x03]);
+	PCD_WriteRegister(RxThresholdReg, LIMIAR_RECEPTOR[ds & 0x03]);
+	_configuracaoTaxa = configuracao;
+} // Fim de PCD_SetBitRate()
+
+/**
+ * Retorna a maior taxa de bits que será negociada com um tipo de PICC.
+ * Começa em 848 kBd e é reduzida a cada falha de comunicação a uma taxa acima de 106 kBd.
+ */
+MFRC522Extended::TaxasBitTag MFRC522Extended::PCD_GetBitRateLimit(PICC_Type tipo)
+{
+	return _limiteTaxa[IndiceLimite(tipo)];
+} // Fim de PCD_GetBitRateLimit()
 
-	// O byte NAD está presente?
-	if (enviar->prologue.pcb & 0x04)
+/**
+ * Volta todos os tipos de PICC ao limite de 848 kBd.
+ */
+void MFRC522Extended::PCD_ResetBitRateLimits()
+{
+	for (byte i = 0; i < sizeof(_limiteTaxa); i++)
 	{
-		retorno->prologue.nad = bufferEntrada[offsetBufferEntrada];
-		offsetBufferEntrada++;
+		_limiteTaxa[i] = BITRATE_848KBITS;
 	}
+	_configuracaoTaxa = 0xFF; // Desconhecida: a próxima configuração escreve os registros
+} // Fim de PCD_ResetBitRateLimits()
 
-	// Verificar se o CRC é tratado pelo MFRC522
-	byte registroRxMode = PCD_ReadRegister(TxModeReg);
-	if ((registroRxMode & 0x80) != 0x80)
+/**
+ * Reduz o limite de um tipo de PICC para um passo abaixo da taxa que falhou.
+ */
+void MFRC522Extended::PCD_LowerBitRateLimit(PICC_Type tipo, TaxasBitTag taxaComFalha)
+{
+	byte indice = IndiceLimite(tipo);
+	if (taxaComFalha > BITRATE_106KBITS && _limiteTaxa[indice] >= taxaComFalha)
 	{
-		Serial.print("CRC não é tratado pelo MFRC522: ");
-		Serial.println(registroRxMode, HEX);
+		_limiteTaxa[indice] = (TaxasBitTag)(taxaComFalha - 1);
+	}
+} // Fim de PCD_LowerBitRateLimit()
 
-		// Verificar o CRC
-		// Precisamos pelo menos do valor CRC_A.
-		if ((int)(tamanhoBufferEntrada - offsetBufferEntrada) < 2)
+/**
+ * Retorna a maior taxa presente na máscara DS/DR do TA1 que não passa do limite.
+ */
+MFRC522Extended::TaxasBitTag MFRC522Extended::MaiorTaxa(byte mascara, TaxasBitTag limite)
+{
+	if ((mascara & 0x04) && limite >= BITRATE_848KBITS)
+	{
+		return BITRATE_848KBITS;
+	}
+	if ((mascara & 0x02) && limite >= BITRATE_424KBITS)
+	{
+		return BITRATE_424KBITS;
+	}
+	if ((mascara & 0x01) && limite >= BITRATE_212KBITS)
+	{
+		return BITRATE_212KBITS;
+	}
+	return BITRATE_106KBITS;
+} // Fim de MaiorTaxa()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções para comunicação com cartões ISO/IEC 14433-4
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Transmite um bloco (I, R ou S) e recebe a resposta.
+ *
+ * O prólogo e o campo INF são escritos no FIFO como segmentos separados e o INF da resposta é lido
+ * diretamente para retorno->inf.dados (veja PCD_TransceiveSegments()); não há cópia do quadro inteiro.
+ * O CRC_A é calculado no MCU se o CRC em hardware não estiver habilitado (antes do PPS).
+ *
+ * Pedidos de extensão do tempo de espera, S(WTX), são respondidos aqui: o timeout atual (o FWT) é
+ * multiplicado por WTXM apenas até a próxima resposta do PICC, e então restaurado.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_MIFARE_NACK se a resposta for R(NAK), STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Extended::TCL_Transceive(BlocoPcb *enviar, ///< Bloco a enviar.
+													BlocoPcb *retorno ///< Recebe a resposta. Entrada: inf.dados e inf.tamanho (capacidade) do buffer para o INF.
+)
+{
+	MFRC522::StatusCode resultado;
+	byte prologoEnvio[3];
+	byte prologoResposta[3];
+	byte tamanhoPrologo = 0;
+	byte primeiroInf; // O primeiro byte do INF é sempre capturado: é o WTXM de um S(WTX)
+	byte wtxm;
+	const uint32_t fwt = PCD_GetTimeout();
+
+	// PCB, CID e NAD, se disponíveis
+	prologoEnvio[tamanhoPrologo++] = enviar->prologo.pcb;
+	if (enviar->prologo.pcb & 0x08)
+	{
+		prologoEnvio[tamanhoPrologo++] = enviar->prologo.cid;
+	}
+	if (enviar->prologo.pcb & 0x04)
+	{
+		prologoEnvio[tamanhoPrologo++] = enviar->prologo.nad;
+	}
+
+	// A resposta usa os mesmos campos de prólogo que o bloco enviado
+	const bool comBuffer = retorno->inf.dados && retorno->inf.tamanho;
+	FifoSegment envio[2] = {{prologoEnvio, tamanhoPrologo}, {enviar->inf.dados, enviar->inf.tamanho}};
+	FifoSegment resposta[3];
+	byte recebidos;
+	while (true)
+	{
+		resposta[0] = {prologoResposta, tamanhoPrologo};
+		resposta[1] = {&primeiroInf, 1};
+		resposta[2] = {comBuffer ? retorno->inf.dados + 1 : (byte *)NULL, comBuffer ? (byte)(retorno->inf.tamanho - 1) : (byte)(retorno->inf.dados ? 0 : 0xFF)};
+		resultado = PCD_TransceiveSegments(envio, 2, resposta, 3, &recebidos, !TCL_HardwareCRC());
+		PCD_SetTimeout(fwt);
+		if (resultado != STATUS_OK)
 		{
-			return STATUS_CRC_WRONG;
+			return resultado;
 		}
-
-		// Verificar o CRC_A - fazer nosso próprio cálculo e armazenar o controle em controlBuffer.
-		byte controlBuffer[2];
-		MFRC522::StatusCode status = PCD_CalculateCRC(bufferEntrada, tamanhoBufferEntrada - 2, controlBuffer);
-		if (status != STATUS_OK)
+		if (recebidos == 0)
 		{
-			return status;
+			return STATUS_ERROR;
 		}
 
-		if ((bufferEntrada[tamanhoBufferEntrada - 2] != controlBuffer[0]) || (bufferEntrada[tamanhoBufferEntrada - 1] != controlBuffer[1]))
+		// S(WTX): 1111 x010, x = CID
+		if ((prologoResposta[0] & 0xF7) != 0xF2)
 		{
-			return STATUS_CRC_WRONG;
+			break;
+		}
+		wtxm = primeiroInf & 0x3F;
+		if (resposta[1].size == 0 || wtxm == 0 || wtxm > 59)
+		{
+			return STATUS_ERROR;
 		}
+		// Resposta S(WTX) com o mesmo WTXM; o PICC terá FWT * WTXM para a próxima resposta
+		prologoEnvio[0] = prologoResposta[0];
+		envio[1] = {&wtxm, 1};
+		PCD_SetTimeout(fwt * wtxm);
+	}
 
-		// Remover os bytes CRC
-		tamanhoBufferEntrada -= 2;
+	byte indice = 0;
+	retorno->prologo.pcb = prologoResposta[indice++];
+	if ((enviar->prologo.pcb & 0x08) && indice < resposta[0].size)
+	{
+		retorno->prologo.cid = prologoResposta[indice++];
+	}
+	if ((enviar->prologo.pcb & 0x04) && indice < resposta[0].size)
+	{
+		retorno->prologo.nad = prologoResposta[indice++];
 	}
 
-	// Recebeu mais dados?
-	if (tamanhoBufferEntrada > offsetBufferEntrada)
+	// Coloca o primeiro byte do INF no lugar
+	retorno->inf.tamanho = resposta[1].size + resposta[2].size;
+	if (resposta[1].size)
 	{
-		if ((tamanhoBufferEntrada - offsetBufferEntrada) > retorno->inf.size)
+		if (comBuffer)
 		{
-			return STATUS_NO_ROOM;
+			retorno->inf.dados[0] = primeiroInf;
+		}
+		else if (retorno->inf.dados)
+		{
+			return STATUS_NO_ROOM; // Buffer de tamanho 0
 		}
-
-		memcpy(retorno->inf.data, &bufferEntrada[offsetBufferEntrada], tamanhoBufferEntrada - offsetBufferEntrada);
-		retorno->inf.size = tamanhoBufferEntrada - offsetBufferEntrada;
-	}
-	else
-	{
-		retorno->inf.size = 0;
 	}
 
-	// Se a resposta for um bloco R, verificar o NACK
-	if (((bufferEntrada[0] & 0xC0) == 0x80) && (bufferEntrada[0] & 0x20))
+	// Se a resposta for um bloco R, verificar o NAK (b5)
+	if (((retorno->prologo.pcb & 0xC0) == 0x80) && (retorno->prologo.pcb & 0x10))
 	{
 		return STATUS_MIFARE_NACK;
 	}
 
 	return resultado;
-}
+} // Fim de TCL_Transceive()
 /**
- * Enviar um I-Block (Aplicação)
+ * Envia um APDU em blocos I e recebe a resposta, com encadeamento nas duas direções.
+ * Versão com tamanhos de um byte de TCL_TransceiveLong().
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
  */
-
-MFRC522::StatusCode MFRC522Extended::TCL_Transceive(TagInfo *tag, byte *sendData, byte sendLen, byte *backData, byte *backLen)
+MFRC522::StatusCode MFRC522Extended::TCL_Transceive(InformacoesTag *tag,	   ///< PICC selecionado com PICC_Select().
+													byte *dadosEnvio,	   ///< Dados a enviar.
+													byte tamanhoEnvio,	   ///< Número de bytes a enviar.
+													byte *dadosResposta,   ///< Buffer para a resposta, ou NULL.
+													byte *tamanhoResposta ///< Entrada: tamanho de dadosResposta. Saída: bytes recebidos.
+)
 {
-	MFRC522::StatusCode resultado;
-
-	PcbBlock out;
-	PcbBlock in;
-	byte outBuffer[FIFO_SIZE];
-	byte outBufferSize = FIFO_SIZE;
-	byte totalBackLen = *backLen;
-
-	// Este comando envia um bloco I
-	out.prologue.pcb = 0x02;
-
-	if (tag->ats.tc1.supportsCID)
+	uint16_t tamanho = (dadosResposta && tamanhoResposta) ? *tamanhoResposta : 0;
+	MFRC522::StatusCode resultado = TCL_TransceiveLong(tag, dadosEnvio, tamanhoEnvio, dadosResposta, &tamanho);
+	if (resultado == STATUS_OK && dadosResposta && tamanhoResposta)
 	{
-		out.prologue.pcb |= 0x08;
-		out.prologue.cid = 0x00; // O CID está atualmente codificado como 0x00
+		*tamanhoResposta = tamanho;
 	}
+	return resultado;
+} // Fim de TCL_Transceive()
 
-	// Este comando não suporta NAD
-	out.prologue.pcb &= 0xFB;
-	out.prologue.nad = 0x00;
-
-	// Define o número do bloco
-	if (tag->blockNumber)
+/**
+ * Envia um APDU de qualquer tamanho em blocos I e recebe a resposta (ISO/IEC 14443-4, 7.5).
+ *
+ * Os dados são divididos em blocos com campo INF de até min(FSC, FSD, FIFO) menos o prólogo e o CRC_A.
+ * Cada bloco encadeado precisa ser confirmado pelo PICC com R(ACK); a resposta encadeada é pedida bloco
+ * a bloco com R(ACK). O número de bloco em tag->numeroBloco é trocado a cada bloco I ou R(ACK) recebido.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_NO_ROOM se a resposta não couber em dadosResposta, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Extended::TCL_TransceiveLong(InformacoesTag *tag,		  ///< PICC selecionado com PICC_Select().
+														const byte *dadosEnvio,	  ///< Dados a enviar.
+														uint16_t tamanhoEnvio,	  ///< Número de bytes a enviar.
+														byte *dadosResposta,	  ///< Buffer para a resposta, ou NULL para descartá-la.
+														uint16_t *tamanhoResposta ///< Entrada: tamanho de dadosResposta. Saída: bytes recebidos.
+)
+{
+	if (_emLote)
 	{
-		out.prologue.pcb |= 0x01;
+		return TCL_TransceiveBlocks(tag, dadosEnvio, tamanhoEnvio, dadosResposta, tamanhoResposta);
 	}
+	const uint32_t timeoutAnterior = PCD_GetTimeout();
+	PCD_SetTimeout(TCL_FrameWaitingTime(tag->ats.tb1.fwi));
+	MFRC522::StatusCode resultado = TCL_TransceiveBlocks(tag, dadosEnvio, tamanhoEnvio, dadosResposta, tamanhoResposta);
+	PCD_SetTimeout(timeoutAnterior);
+	return resultado;
+} // Fim de TCL_TransceiveLong()
 
-	// Temos dados para enviar?
-	if (sendData && (sendLen > 0))
+/**
+ * Prepara uma sequência de trocas com o mesmo PICC: o timer é programado uma vez com o FWT do PICC e o
+ * modo de CRC (TxModeReg) é lido uma vez e mantido em cache. Até TCL_EndBatch(), TCL_TransceiveLong() não
+ * reprograma o timer a cada chamada.
+ * Não mude a taxa de bits nem o timeout entre TCL_BeginBatch() e TCL_EndBatch().
+ */
+void MFRC522Extended::TCL_BeginBatch(InformacoesTag *tag ///< PICC selecionado com PICC_Select().
+)
+{
+	if (_emLote)
 	{
-		out.inf.size = sendLen;
-		out.inf.data = sendData;
+		return;
 	}
-	else
+	if (_configuracaoTaxa == 0xFF)
 	{
-		out.inf.size = 0;
-		out.inf.data = NULL;
+		PCD_SetBitRate(tag->taxaDs, tag->taxaDr, PCD_ReadRegister(TxModeReg) & 0x80);
 	}
+	_timeoutForaLote = PCD_GetTimeout();
+	PCD_SetTimeout(TCL_FrameWaitingTime(tag->ats.tb1.fwi));
+	_emLote = true;
+} // Fim de TCL_BeginBatch()
 
-	// Inicializa os dados de recepção
-	// Atenção: O valor escapa do escopo local
-	in.inf.data = outBuffer;
-	in.inf.size = outBufferSize;
-
-	resultado = TCL_Transceive(&out, &in);
-	if (resultado != STATUS_OK)
+/**
+ * Encerra a sequência iniciada com TCL_BeginBatch() e restaura o timeout anterior.
+ */
+void MFRC522Extended::TCL_EndBatch()
+{
+	if (!_emLote)
 	{
-		return resultado;
+		return;
 	}
+	_emLote = false;
+	PCD_SetTimeout(_timeoutForaLote);
+} // Fim de TCL_EndBatch()
 
-	// Troca o número do bloco em caso de sucesso
-	tag->blockNumber = !tag->blockNumber;
+/**
+ * Corpo de TCL_TransceiveLong(), com o timeout já programado para o FWT do PICC.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Extended::TCL_TransceiveBlocks(InformacoesTag *tag, const byte *dadosEnvio, uint16_t tamanhoEnvio, byte *dadosResposta, uint16_t *tamanhoResposta)
+{
+	MFRC522::StatusCode resultado;
+	BlocoPcb resposta;
+	const byte maximoInf = TCL_MaxInfSize(tag);
+	const uint16_t capacidade = (dadosResposta && tamanhoResposta) ? *tamanhoResposta : 0;
+	uint16_t enviados = 0;
+	uint16_t recebidos = 0;
+
+	// Envio: todos os blocos menos o último levam o bit de encadeamento e são confirmados com R(ACK).
+	do
+	{
+		byte tamanhoBloco = (tamanhoEnvio - enviados > maximoInf) ? maximoInf : tamanhoEnvio - enviados;
+		bool encadeado = (enviados + tamanhoBloco < tamanhoEnvio);
+		// O INF da resposta vai direto para dadosResposta; as respostas R(ACK) dos blocos encadeados não têm INF.
+		resultado = TCL_ExchangeBlock(tag, encadeado ? 0x12 : 0x02, dadosEnvio + enviados, tamanhoBloco, DestinoResposta(dadosResposta, 0), EspacoResposta(dadosResposta, capacidade, 0), &resposta);
+		if (resultado != STATUS_OK)
+		{
+			return resultado;
+		}
+		if (encadeado && ((resposta.prologo.pcb & 0xF6) != 0xA2 || (bool)(resposta.prologo.pcb & 0x01) != tag->numeroBloco))
+		{
+			return STATUS_ERROR; // Esperávamos R(ACK) para o bloco enviado
+		}
+		tag->numeroBloco = !tag->numeroBloco;
+		enviados += tamanhoBloco;
+	} while (enviados < tamanhoEnvio);
 
-	if (backData && (backLen > 0))
+	// Recepção: enquanto o bloco I recebido estiver encadeado, R(ACK) pede o próximo.
+	while (true)
 	{
-		if (*backLen < in.inf.size)
-			return STATUS_NO_ROOM;
+		if ((resposta.prologo.pcb & 0xE2) != 0x02)
+		{
+			return STATUS_ERROR; // Não é um bloco I
+		}
+		recebidos += resposta.inf.tamanho;
 
-		*backLen = in.inf.size;
-		memcpy(backData, in.inf.data, in.inf.size);
+		if ((resposta.prologo.pcb & 0x10) == 0x00)
+		{
+			break;
+		}
+		resultado = TCL_ExchangeBlock(tag, 0xA2, NULL, 0, DestinoResposta(dadosResposta, recebidos), EspacoResposta(dadosResposta, capacidade, recebidos), &resposta);
+		if (resultado != STATUS_OK)
+		{
+			return resultado;
+		}
+		tag->numeroBloco = !tag->numeroBloco;
 	}
 
-	// Verifica se há encadeamento
-	if ((in.prologue.pcb & 0x10) == 0x00)
-		return resultado;
+	if (tamanhoResposta)
+	{
+		*tamanhoResposta = recebidos;
+	}
+	return STATUS_OK;
+} // Fim de TCL_TransceiveBlocks()
 
-	// O resultado está encadeado
-	// Envia um ACK para receber mais dados
-	// Atenção: Deve ser verificado, nunca precisei enviar um ACK
-	while (in.prologue.pcb & 0x10)
+/**
+ * Envia um bloco I ou R com o CID e o número de bloco atuais e recebe a resposta.
+ * Erros de CRC ou timeout reduzem o limite de taxa de bits do tipo de PICC (veja PICC_NegotiateBitRate()).
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Extended::TCL_ExchangeBlock(InformacoesTag *tag, ///< PICC selecionado com PICC_Select().
+													   byte pcb,			///< PCB sem o CID e o número de bloco.
+													   const byte *inf,		///< Campo INF, ou NULL.
+													   byte tamanhoInf,		///< Tamanho do campo INF.
+													   byte *buffer,		///< Buffer para o INF da resposta, ou NULL para descartá-lo.
+													   byte tamanhoBuffer,	///< Tamanho do buffer.
+													   BlocoPcb *resposta	///< Recebe a resposta.
+)
+{
+	BlocoPcb enviar;
+	enviar.prologo.pcb = pcb;
+	enviar.prologo.cid = 0x00; // O CID está atualmente codificado como 0x00
+	enviar.prologo.nad = 0x00; // NAD não é suportado
+	if (tag->ats.tc1.suportaCID)
 	{
-		byte ackData[FIFO_SIZE];
-		byte ackDataSize = FIFO_SIZE;
+		enviar.prologo.pcb |= 0x08;
+	}
+	if (tag->numeroBloco)
+	{
+		enviar.prologo.pcb |= 0x01;
+	}
+	enviar.inf.tamanho = tamanhoInf;
+	enviar.inf.dados = (byte *)inf;
 
-		resultado = TCL_TransceiveRBlock(tag, true, ackData, &ackDataSize);
-		if (resultado != STATUS_OK)
-			return resultado;
+	resposta->inf.dados = buffer;
+	resposta->inf.tamanho = tamanhoBuffer;
 
-		if (backData && (backLen > 0))
-		{
-			if ((*backLen + ackDataSize) > totalBackLen)
-				return STATUS_NO_ROOM;
+	MFRC522::StatusCode resultado = TCL_Transceive(&enviar, resposta);
+	if (resultado == STATUS_CRC_WRONG || resultado == STATUS_TIMEOUT)
+	{
+		// Erro de CRC ou timeout a uma taxa alta: a próxima seleção deste tipo de PICC usa um passo abaixo.
+		PCD_LowerBitRateLimit(PICC_GetType(tag), (tag->taxaDs > tag->taxaDr) ? tag->taxaDs : tag->taxaDr);
+	}
+	return resultado;
+} // Fim de TCL_ExchangeBlock()
 
-			memcpy(&(backData[*backLen]), ackData, ackDataSize);
-			*backLen += ackDataSize;
-		}
+/**
+ * Tamanho máximo do campo INF de um bloco: o menor entre FSC (do ATS), FSD (64, anunciado no RATS) e o
+ * FIFO, menos PCB, CID e CRC_A.
+ */
+byte MFRC522Extended::TCL_MaxInfSize(const InformacoesTag *tag)
+{
+	byte quadro = (tag->ats.fsc >= 16 && tag->ats.fsc < FIFO_SIZE) ? tag->ats.fsc : FIFO_SIZE;
+	return quadro - 3 - (tag->ats.tc1.suportaCID ? 1 : 0);
+} // Fim de TCL_MaxInfSize()
+
+/**
+ * true se o MFRC522 gera e verifica o CRC_A (habilitado por PCD_SetBitRate() depois do PPS).
+ * Usa a configuração guardada e só lê TxModeReg se ela for desconhecida.
+ */
+bool MFRC522Extended::TCL_HardwareCRC()
+{
+	if (_configuracaoTaxa == 0xFF)
+	{
+		return PCD_ReadRegister(TxModeReg) & 0x80;
 	}
+	return _configuracaoTaxa & 0x80;
+} // Fim de TCL_HardwareCRC()
 
-	return resultado;
-} // Fim de TCL_Transceive()
+/**
+ * Frame Waiting Time para um FWI, em microssegundos: (256 * 16 / fc) * 2^FWI mais ΔFWT (49152 / fc).
+ * FWI 15 é RFU e é tratado como o padrão, 4.
+ */
+uint32_t MFRC522Extended::TCL_FrameWaitingTime(byte fwi)
+{
+	if (fwi > 14)
+	{
+		fwi = 4;
+	}
+	return (4096UL << fwi) / 1356 * 100 + 3625;
+} // Fim de TCL_FrameWaitingTime()
+
+/**
+ * Start-up Frame Guard Time para um SFGI, em microssegundos: (256 * 16 / fc) * 2^SFGI mais ΔSFGT (384 / fc * 2^SFGI).
+ */
+uint32_t MFRC522Extended::TCL_GuardTime(byte sfgi)
+{
+	return ((4096UL + 384) << sfgi) / 1356 * 100;
+} // Fim de TCL_GuardTime()
 
 /**
  * Envia um bloco R para o PICC.
  */
-MFRC522::StatusCode MFRC522Extended::TCL_TransceiveRBlock(TagInfo *tag, bool ack, byte *backData, byte *backLen)
+MFRC522::StatusCode MFRC522Extended::TCL_TransceiveRBlock(InformacoesTag *tag, bool ack, byte *backData, byte *backLen)
 {
 	MFRC522::StatusCode resultado;
 
-	PcbBlock out;
-	PcbBlock in;
+	BlocoPcb out;
+	BlocoPcb in;
 	byte outBuffer[FIFO_SIZE];
 	byte outBufferSize = FIFO_SIZE;
 
 	// Este comando envia um bloco R
 	if (ack)
-		out.prologue.pcb = 0xA2; // ACK
+		out.prologo.pcb = 0xA2; // ACK
 	else
-		out.prologue.pcb = 0xB2; // NAK
+		out.prologo.pcb = 0xB2; // NAK
 
-	if (tag->ats.tc1.supportsCID)
+	if (tag->ats.tc1.suportaCID)
 	{
-		out.prologue.pcb |= 0x08;
-		out.prologue.cid = 0x00; // O CID está atualmente codificado como 0x00
+		out.prologo.pcb |= 0x08;
+		out.prologo.cid = 0x00; // O CID está atualmente codificado como 0x00
 	}
 
 	// Este comando não suporta NAD
-	out.prologue.pcb &= 0xFB;
-	out.prologue.nad = 0x00;
+	out.prologo.pcb &= 0xFB;
+	out.prologo.nad = 0x00;
 
 	// Define o número do bloco
-	if (tag->blockNumber)
+	if (tag->numeroBloco)
 	{
-		out.prologue.pcb |= 0x01;
+		out.prologo.pcb |= 0x01;
 	}
 
 	// Sem dados INF para o bloco R
-	out.inf.size = 0;
-	out.inf.data = NULL;
+	out.inf.tamanho = 0;
+	out.inf.dados = NULL;
 
 	// Inicializa os dados de recepção
 	// Atenção: O valor escapa do escopo local
-	in.inf.data = outBuffer;
-	in.inf.size = outBufferSize;
+	in.inf.dados = outBuffer;
+	in.inf.tamanho = outBufferSize;
 
 	resultado = TCL_Transceive(&out, &in);
 	if (resultado != STATUS_OK)
@@ -920,48 +1111,61 @@ MFRC522::StatusCode MFRC522Extended::TCL_TransceiveRBlock(TagInfo *tag, bool ack
 	}
 
 	// Troca o número do bloco em caso de sucesso
-	tag->blockNumber = !tag->blockNumber;
+	tag->numeroBloco = !tag->numeroBloco;
 
 	if (backData && backLen)
 	{
-		if (*backLen < in.inf.size)
+		if (*backLen < in.inf.tamanho)
 			return STATUS_NO_ROOM;
 
-		*backLen = in.inf.size;
-		memcpy(backData, in.inf.data, in.inf.size);
+		*backLen = in.inf.tamanho;
+		memcpy(backData, in.inf.dados, in.inf.tamanho);
 	}
 
 	return resultado;
 } // Fim de TCL_TransceiveRBlock()
 
 /**
- * Envia um bloco S para desselecionar o cartão.
+ * Envia um bloco S(DESELECT) e espera a confirmação do PICC, que vai para o estado HALT.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
  */
 
-MFRC522::StatusCode MFRC522Extended::TCL_Deselect(TagInfo *tag)
+MFRC522::StatusCode MFRC522Extended::TCL_Deselect(InformacoesTag *tag)
 {
-	MFRC522::StatusCode resultado;
-	byte outBuffer[4];
-	byte outBufferSize = 1;
-	byte inBuffer[FIFO_SIZE];
-	byte inBufferSize = FIFO_SIZE;
+	BlocoPcb enviar;
+	BlocoPcb resposta;
 
-	outBuffer[0] = 0xC2;
-	if (tag->ats.tc1.supportsCID)
+	enviar.prologo.pcb = 0xC2;
+	enviar.prologo.cid = 0x00; // O CID está codificado como fixo
+	enviar.prologo.nad = 0x00;
+	if (tag->ats.tc1.suportaCID)
 	{
-		outBuffer[0] |= 0x08;
-		outBuffer[1] = 0x00; // O CID está codificado como fixo
-		outBufferSize = 2;
+		enviar.prologo.pcb |= 0x08;
 	}
-
-	resultado = PCD_TransceiveData(outBuffer, outBufferSize, inBuffer, &inBufferSize);
+	enviar.inf.tamanho = 0;
+	enviar.inf.dados = NULL;
+	resposta.inf.tamanho = 0;
+	resposta.inf.dados = NULL;
+
+	// O PICC responde S(DESELECT) dentro de FWT_DESELECT = 65536 / fc (~4,8ms), qualquer que seja o FWI
+	const uint32_t timeoutAnterior = PCD_GetTimeout();
+	PCD_SetTimeout(TIMEOUT_DESELECT_US);
+	MFRC522::StatusCode resultado = TCL_Transceive(&enviar, &resposta);
+	PCD_SetTimeout(timeoutAnterior);
 	if (resultado != STATUS_OK)
 	{
 		return resultado;
 	}
+	if ((resposta.prologo.pcb & 0xF7) != 0xC2)
+	{
+		return STATUS_ERROR;
+	}
 
-	// TODO: Talvez fazer algumas verificações? Nos meus testes, retorna: CA 00 (Mesmos dados que enviei para o meu cartão)
-
+	// O PICC está em HALT; a próxima ativação começa a 106 kBd
+	PCD_SetBitRate(BITRATE_106KBITS, BITRATE_106KBITS, false);
+	tag->taxaDs = BITRATE_106KBITS;
+	tag->taxaDr = BITRATE_106KBITS;
 	return resultado;
 } // Fim de TCL_Deselect()
 
@@ -974,40 +1178,23 @@ MFRC522::StatusCode MFRC522Extended::TCL_Deselect(TagInfo *tag)
  *
  * @return PICC_Type
  */
-MFRC522::PICC_Type MFRC522Extended::PICC_GetType(TagInfo *tag ///< A TagInfo retornada pelo PICC_Select().
+MFRC522::PICC_Type MFRC522Extended::PICC_GetType(InformacoesTag *tag ///< A InformacoesTag retornada pelo PICC_Select().
 )
 {
 	// http://www.nxp.com/documents/application_note/AN10833.pdf
-	// 3.2 Codificação do Select Acknowledge (SAK)
-	// Ignora 8 bits (iso14443 começa com LSBit = bit 1)
-	// Corrige o tipo errado para o fabricante Infineon (http://nfc-tools.org/index.php?title=ISO14443A)
-	byte sak = tag->uid.sak & 0x7F;
-	switch (sak)
+	// ATQA, SAK e, se o RATS foi enviado, os bytes históricos do ATS (veja MFRC522Identify.h)
+	const byte *historicos = NULL;
+	byte tamanhoHistoricos = 0;
+	if (tag->ats.tamanho > 1 && tag->ats.tamanho <= sizeof(tag->ats.dados))
 	{
-	case 0x04:
-		return PICC_TYPE_NOT_COMPLETE; // UID não completo
-	case 0x09:
-		return PICC_TYPE_MIFARE_MINI;
-	case 0x08:
-		return PICC_TYPE_MIFARE_1K;
-	case 0x18:
-		return PICC_TYPE_MIFARE_4K;
-	case 0x00:
-		return PICC_TYPE_MIFARE_UL;
-	case 0x10:
-	case 0x11:
-		return PICC_TYPE_MIFARE_PLUS;
-	case 0x01:
-		return PICC_TYPE_TNP3XXX;
-	case 0x20:
-		if (tag->atqa == 0x0344)
-			return PICC_TYPE_MIFARE_DESFIRE;
-		return PICC_TYPE_ISO_14443_4;
-	case 0x40:
-		return PICC_TYPE_ISO_18092;
-	default:
-		return PICC_TYPE_UNKNOWN;
+		byte inicio = MFRC522Identify::HistoricalBytesOffset(tag->ats.dados[1]);
+		if (inicio < tag->ats.tamanho)
+		{
+			historicos = &tag->ats.dados[inicio];
+			tamanhoHistoricos = tag->ats.tamanho - inicio;
+		}
 	}
+	return MFRC522Identify::GetDescriptor(MFRC522Identify::Identify(tag->atqa, tag->uid.sak, historicos, tamanhoHistoricos)).tipo;
 } // Fim de PICC_GetType()
 
 /**
@@ -1015,7 +1202,7 @@ MFRC522::PICC_Type MFRC522Extended::PICC_GetType(TagInfo *tag ///< A TagInfo ret
  * Em caso de sucesso, o PICC é parado após a exibição dos dados.
  * Para MIFARE Classic, é tentada a chave padrão de fábrica 0xFFFFFFFFFFFF.
  */
-void MFRC522Extended::PICC_DumpToSerial(TagInfo *tag)
+void MFRC522Extended::PICC_DumpToSerial(InformacoesTag *tag)
 {
 	MIFARE_Key chave;
 
@@ -1028,6 +1215,7 @@ void MFRC522Extended::PICC_DumpToSerial(TagInfo *tag)
 	{
 	case PICC_TYPE_MIFARE_MINI:
 	case PICC_TYPE_MIFARE_1K:
+	case PICC_TYPE_MIFARE_2K:
 	case PICC_TYPE_MIFARE_4K:
 		// Todas as chaves são definidas como FFFFFFFFFFFFh na entrega da fábrica.
 		for (byte i = 0; i < 6; i++)
@@ -1065,7 +1253,7 @@ void MFRC522Extended::PICC_DumpToSerial(TagInfo *tag)
 /**
  * Exibe informações do cartão (UID, SAK, Tipo) sobre o PICC selecionado no Serial.
  */
-void MFRC522Extended::PICC_DumpDetailsToSerial(TagInfo *tag ///< Ponteiro para a estrutura TagInfo retornada de um PICC_Select() bem-sucedido.
+void MFRC522Extended::PICC_DumpDetailsToSerial(InformacoesTag *tag ///< Ponteiro para a estrutura InformacoesTag retornada de um PICC_Select() bem-sucedido.
 )
 {
 	// ATQA
@@ -1106,19 +1294,19 @@ void MFRC522Extended::PICC_DumpDetailsToSerial(TagInfo *tag ///< Ponteiro para a
 /**
  * Exibe o conteúdo da memória de um PICC ISO-14443-4.
  */
-void MFRC522Extended::PICC_DumpISO14443_4(TagInfo *tag)
+void MFRC522Extended::PICC_DumpISO14443_4(InformacoesTag *tag)
 {
 	// ATS
-	if (tag->ats.size > 0x00)
+	if (tag->ats.tamanho > 0x00)
 	{ // O primeiro byte é o comprimento do ATS, incluindo o byte de comprimento
 		Serial.print(F("Cartão ATS:"));
-		for (byte offset = 0; offset < tag->ats.size; offset++)
+		for (byte offset = 0; offset < tag->ats.tamanho; offset++)
 		{
-			if (tag->ats.data[offset] < 0x10)
+			if (tag->ats.dados[offset] < 0x10)
 				Serial.print(F(" 0"));
 			else
 				Serial.print(F(" "));
-			Serial.print(tag->ats.data[offset], HEX);
+			Serial.print(tag->ats.dados[offset], HEX);
 		}
 		Serial.println();
 	}
@@ -1146,39 +1334,38 @@ bool MFRC522Extended::PICC_IsNewCardPresent()
 	byte bufferATQA[2];
 	byte bufferSize = sizeof(bufferATQA);
 
-	// Redefine as taxas de baud
-	PCD_WriteRegister(TxModeReg, 0x00);
-	PCD_WriteRegister(RxModeReg, 0x00);
-	// Redefine ModWidthReg
-	PCD_WriteRegister(ModWidthReg, 0x26);
+	// REQA é sempre enviado a 106 kBd, sem CRC. Os registros só são escritos se um PPS os alterou.
+	PCD_SetBitRate(BITRATE_106KBITS, BITRATE_106KBITS, false);
 
 	MFRC522::StatusCode result = PICC_RequestA(bufferATQA, &bufferSize);
 
 	if (result == STATUS_OK || result == STATUS_COLLISION)
 	{
 		tag.atqa = ((uint16_t)bufferATQA[1] << 8) | bufferATQA[0];
-		tag.ats.size = 0;
+		tag.ats.tamanho = 0;
 		tag.ats.fsc = 32; // valor FSC padrão
 
 		// Padrões para TA1
-		tag.ats.ta1.transmitted = false;
-		tag.ats.ta1.sameD = false;
+		tag.ats.ta1.transmitido = false;
+		tag.ats.ta1.mesmoD = false;
 		tag.ats.ta1.ds = MFRC522Extended::BITRATE_106KBITS;
 		tag.ats.ta1.dr = MFRC522Extended::BITRATE_106KBITS;
 
 		// Padrões para TB1
-		tag.ats.tb1.transmitted = false;
-		tag.ats.tb1.fwi = 0;  // TODO: Não conheço o valor padrão para isso!
+		tag.ats.tb1.transmitido = false;
+		tag.ats.tb1.fwi = 4;  // O valor padrão de FWI é 4 (FWT ~4,8ms), ISO/IEC 14443-4 5.2.5
 		tag.ats.tb1.sfgi = 0; // O valor padrão de SFGI é 0 (o que significa que o cartão não precisa de nenhum SFGT específico)
 
 		// Padrões para TC1
-		tag.ats.tc1.transmitted = false;
-		tag.ats.tc1.supportsCID = true;
-		tag.ats.tc1.supportsNAD = false;
+		tag.ats.tc1.transmitido = false;
+		tag.ats.tc1.suportaCID = true;
+		tag.ats.tc1.suportaNAD = false;
 
-		memset(tag.ats.data, 0, FIFO_SIZE - 2);
+		memset(tag.ats.dados, 0, FIFO_SIZE - 2);
 
-		tag.blockNumber = false;
+		tag.numeroBloco = false;
+		tag.taxaDs = MFRC522Extended::BITRATE_106KBITS;
+		tag.taxaDr = MFRC522Extended::BITRATE_106KBITS;
 		return true;
 	}
 	return false;
@@ -22,6 +22,9 @@ public:
 		BITRATE_848KBITS = 0x03
 	};
 
+	// FWT_DESELECT: tempo máximo de resposta a S(DESELECT), 65536 / fc, com margem
+	static constexpr uint32_t TIMEOUT_DESELECT_US = 5000;
+
 	// Estrutura para armazenar ATS ISO/IEC 14443-4
 	typedef struct
 	{
@@ -63,6 +66,10 @@ public:
 
 		// Para o bloco PCB
 		bool numeroBloco;
+
+		// Taxas de bits negociadas com PPS
+		TaxasBitTag taxaDs; // PICC -> PCD
+		TaxasBitTag taxaDr; // PCD -> PICC
 	} InformacoesTag;
 
 	// Uma estrutura usada para passar o bloco PCB
@@ -87,9 +94,16 @@ public:
 	/////////////////////////////////////////////////////////////////////////////////////
 	// Contrutores
 	/////////////////////////////////////////////////////////////////////////////////////
-	MFRC522Extended() : MFRC522(){};
-	MFRC522Extended(uint8_t rst) : MFRC522(rst){};
-	MFRC522Extended(uint8_t ss, uint8_t rst) : MFRC522(ss, rst){};
+	MFRC522Extended() : MFRC522(), _emLote(false) { PCD_ResetBitRateLimits(); };
+	MFRC522Extended(uint8_t rst) : MFRC522(rst), _emLote(false) { PCD_ResetBitRateLimits(); };
+	MFRC522Extended(uint8_t ss, uint8_t rst) : MFRC522(ss, rst), _emLote(false) { PCD_ResetBitRateLimits(); };
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções para configurar a taxa de bits
+	/////////////////////////////////////////////////////////////////////////////////////
+	void PCD_SetBitRate(TaxasBitTag ds, TaxasBitTag dr, bool crc);
+	TaxasBitTag PCD_GetBitRateLimit(PICC_Type tipo);
+	void PCD_ResetBitRateLimits();
 
 	/////////////////////////////////////////////////////////////////////////////////////
 	// Funções para comunicar com PICCs
@@ -98,14 +112,19 @@ public:
 	StatusCode PICC_RequestATS(Ats *ats);
 	StatusCode PICC_PPS();													 // Comando PPS sem parâmetro de taxa de bits
 	StatusCode PICC_PPS(TaxasBitTag taxaEnvio, TaxasBitTag taxaRecebimento); // Diferentes valores D
+	StatusCode PICC_NegotiateBitRate(Uid *uid);
+	StatusCode PICC_Reactivate(Uid *uid);
 
 	/////////////////////////////////////////////////////////////////////////////////////
 	// Funções para comunicar com cartões ISO/IEC 14433-4
 	/////////////////////////////////////////////////////////////////////////////////////
 	StatusCode TCL_Transceive(BlocoPcb *enviar, BlocoPcb *resposta);
 	StatusCode TCL_Transceive(InformacoesTag *tag, byte *dadosEnvio, byte tamanhoEnvio, byte *dadosResposta = NULL, byte *tamanhoResposta = NULL);
+	StatusCode TCL_TransceiveLong(InformacoesTag *tag, const byte *dadosEnvio, uint16_t tamanhoEnvio, byte *dadosResposta, uint16_t *tamanhoResposta);
 	StatusCode TCL_TransceiveRBlock(InformacoesTag *tag, bool ack, byte *dadosResposta = NULL, byte *tamanhoResposta = NULL);
 	StatusCode TCL_Deselect(InformacoesTag *tag);
+	void TCL_BeginBatch(InformacoesTag *tag);
+	void TCL_EndBatch();
 
 	/////////////////////////////////////////////////////////////////////////////////////
 	// Funções de suporte
@@ -125,6 +144,31 @@ public:
 	/////////////////////////////////////////////////////////////////////////////////////
 	bool PICC_IsNewCardPresent() override; // sobrescrever
 	bool PICC_ReadCardSerial() override;   // sobrescrever
+
+protected:
+	// Maior taxa de bits a negociar com cada tipo de PICC (índice: PICC_Type)
+	TaxasBitTag _limiteTaxa[PICC_TYPE_MIFARE_2K + 1];
+	// Configuração atual de TxModeReg/RxModeReg: CRC (bit 7), DS (bits 3-2), DR (bits 1-0); 0xFF se desconhecida
+	byte _configuracaoTaxa;
+	// true entre TCL_BeginBatch() e TCL_EndBatch(): o timer já está no FWT e o modo de CRC está em cache
+	bool _emLote;
+	uint32_t _timeoutForaLote; // Timeout a restaurar em TCL_EndBatch()
+
+	void PCD_LowerBitRateLimit(PICC_Type tipo, TaxasBitTag taxaComFalha);
+	StatusCode TCL_ExchangeBlock(InformacoesTag *tag, byte pcb, const byte *inf, byte tamanhoInf, byte *buffer, byte tamanhoBuffer, BlocoPcb *resposta);
+	bool TCL_HardwareCRC();
+	StatusCode TCL_TransceiveBlocks(InformacoesTag *tag, const byte *dadosEnvio, uint16_t tamanhoEnvio, byte *dadosResposta, uint16_t *tamanhoResposta);
+	static uint32_t TCL_FrameWaitingTime(byte fwi);
+	static uint32_t TCL_GuardTime(byte sfgi);
+	// Posição e espaço livre em dadosResposta para o INF do próximo bloco; sem buffer, o INF é descartado
+	static byte *DestinoResposta(byte *dados, uint16_t recebidos) { return dados ? dados + recebidos : NULL; };
+	static byte EspacoResposta(byte *dados, uint16_t capacidade, uint16_t recebidos)
+	{
+		return !dados ? 0xFF : (capacidade - recebidos > 0xFF) ? 0xFF : capacidade - recebidos;
+	};
+	static byte TCL_MaxInfSize(const InformacoesTag *tag);
+	static TaxasBitTag MaiorTaxa(byte mascara, TaxasBitTag limite);
+	static byte IndiceLimite(PICC_Type tipo) { return (tipo <= PICC_TYPE_MIFARE_2K) ? tipo : PICC_TYPE_UNKNOWN; };
 };
 
 #endif
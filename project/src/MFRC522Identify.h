@@ -0,0 +1,135 @@
+/**
+ * Identificação do produto PICC pelo ATQA, SAK e bytes históricos do ATS (NXP AN10833).
+ *
+ * Identify() percorre o procedimento da AN10833 em uma única passagem e GetDescriptor() devolve o tipo
+ * (PICC_Type), a organização da memória e os comandos suportados pelo produto. As duas funções são
+ * constexpr: a "tabela" é uma cadeia de comparações que fica na flash, sem ocupar RAM no AVR, e com
+ * argumentos constantes o resultado é calculado em tempo de compilação.
+ *
+ * Os bits de tamanho do UID (bits 7 e 6 do primeiro byte) são ignorados no ATQA; um ATQA 0 significa
+ * desconhecido, como em MFRC522::PICC_GetType(byte sak), que só recebe o SAK. Os bytes históricos
+ * separam o MIFARE Plus em SL3 de outros PICCs ISO/IEC 14443-4; sem eles (ou sem RATS), o Plus SL3
+ * é identificado como PRODUCT_ISO_14443_4. Ultralight e NTAG são apenas PRODUCT_ULTRALIGHT aqui; use
+ * MFRC522Ultralight para separar os produtos da família.
+ *
+ * Ex.:
+ *   MFRC522Identify::Descritor d = MFRC522Identify::GetDescriptor(MFRC522Identify::Identify(atqa, sak, NULL, 0));
+ *   if (d.capacidades & MFRC522Identify::CAPACIDADE_CRYPTO1) { ... }
+ *   static_assert(MFRC522Identify::GetDescriptor(MFRC522Identify::PRODUCT_MIFARE_2K).setores == 32, "");
+ */
+#ifndef MFRC522Identify_h
+#define MFRC522Identify_h
+
+#include <Arduino.h>
+#include "MFRC522.h"
+
+class MFRC522Identify
+{
+public:
+	// Produtos identificados. Lembre-se de atualizar Identify() e GetDescriptor() se adicionar mais.
+	enum Product : byte
+	{
+		PRODUCT_UNKNOWN = 0,
+		PRODUCT_UID_NOT_COMPLETE,		// SAK com o bit de cascata: o UID ainda não está completo
+		PRODUCT_MIFARE_MINI,			// SAK 0x09
+		PRODUCT_MIFARE_1K,				// SAK 0x08 (0x88 no Infineon)
+		PRODUCT_MIFARE_2K,				// SAK 0x19
+		PRODUCT_MIFARE_4K,				// SAK 0x18
+		PRODUCT_MIFARE_PLUS_2K_SL2,		// SAK 0x10
+		PRODUCT_MIFARE_PLUS_4K_SL2,		// SAK 0x11
+		PRODUCT_MIFARE_PLUS_2K_SL3,		// SAK 0x20, bytes históricos C1 05 2F 2F, ATQA 0x0004
+		PRODUCT_MIFARE_PLUS_4K_SL3,		// SAK 0x20, bytes históricos C1 05 2F 2F, ATQA 0x0002
+		PRODUCT_SMARTMX_CLASSIC_1K,		// SAK 0x28: SmartMX com emulação MIFARE Classic 1K
+		PRODUCT_SMARTMX_CLASSIC_4K,		// SAK 0x38: SmartMX com emulação MIFARE Classic 4K
+		PRODUCT_MIFARE_DESFIRE,			// SAK 0x20, ATQA 0x0344
+		PRODUCT_ULTRALIGHT,				// SAK 0x00: Ultralight, Ultralight C, Ultralight EV1 e NTAG
+		PRODUCT_TNP3XXX,				// SAK 0x01
+		PRODUCT_ISO_14443_4,			// SAK 0x20, outros
+		PRODUCT_NFC_DEP					// SAK 0x40: ISO/IEC 18092 (NFC-DEP)
+	};
+
+	// Comandos suportados pelo produto (campo capacidades do Descritor)
+	enum Capacidade : uint16_t
+	{
+		CAPACIDADE_CRYPTO1 = 0x0001,	// PCD_Authenticate() e os comandos MIFARE Classic (MIFARE_Read(), MIFARE_Write(), valores)
+		CAPACIDADE_PAGINAS = 0x0002,	// Páginas de 4 bytes: MIFARE_Read() de 16 bytes e MIFARE_Ultralight_Write()
+		CAPACIDADE_ISO_14443_4 = 0x0004, // RATS e blocos T=CL (MFRC522Extended)
+		CAPACIDADE_DESFIRE = 0x0008,	// Comandos nativos DESFire (MFRC522Desfire)
+		CAPACIDADE_AES = 0x0010,		// Autenticação AES do MIFARE Plus
+		CAPACIDADE_NFC_DEP = 0x0020		// Protocolo ISO/IEC 18092 (não suportado pelo MFRC522)
+	};
+
+	// Descrição de um produto. Campos desconhecidos ou variáveis (DESFire, família Ultralight) são 0.
+	typedef struct
+	{
+		MFRC522::PICC_Type tipo; // Tipo equivalente para PICC_GetType()
+		byte setores;			 // Setores MIFARE Classic/Plus
+		uint16_t memoria;		 // Memória em bytes
+		uint16_t capacidades;	 // Combinação de valores Capacidade
+	} Descritor;
+
+	static constexpr Descritor GetDescriptor(Product product)
+	{
+		//                                                                                   setores memória capacidades
+		return (product == PRODUCT_UID_NOT_COMPLETE)		? Descritor{MFRC522::PICC_TYPE_NOT_COMPLETE, 0, 0, 0}
+			   : (product == PRODUCT_MIFARE_MINI)			? Descritor{MFRC522::PICC_TYPE_MIFARE_MINI, 5, 320, CAPACIDADE_CRYPTO1}
+			   : (product == PRODUCT_MIFARE_1K)				? Descritor{MFRC522::PICC_TYPE_MIFARE_1K, 16, 1024, CAPACIDADE_CRYPTO1}
+			   : (product == PRODUCT_MIFARE_2K)				? Descritor{MFRC522::PICC_TYPE_MIFARE_2K, 32, 2048, CAPACIDADE_CRYPTO1}
+			   : (product == PRODUCT_MIFARE_4K)				? Descritor{MFRC522::PICC_TYPE_MIFARE_4K, 40, 4096, CAPACIDADE_CRYPTO1}
+			   : (product == PRODUCT_MIFARE_PLUS_2K_SL2)	? Descritor{MFRC522::PICC_TYPE_MIFARE_PLUS, 32, 2048, CAPACIDADE_AES}
+			   : (product == PRODUCT_MIFARE_PLUS_4K_SL2)	? Descritor{MFRC522::PICC_TYPE_MIFARE_PLUS, 40, 4096, CAPACIDADE_AES}
+			   : (product == PRODUCT_MIFARE_PLUS_2K_SL3)	? Descritor{MFRC522::PICC_TYPE_MIFARE_PLUS, 32, 2048, CAPACIDADE_AES | CAPACIDADE_ISO_14443_4}
+			   : (product == PRODUCT_MIFARE_PLUS_4K_SL3)	? Descritor{MFRC522::PICC_TYPE_MIFARE_PLUS, 40, 4096, CAPACIDADE_AES | CAPACIDADE_ISO_14443_4}
+			   : (product == PRODUCT_SMARTMX_CLASSIC_1K)	? Descritor{MFRC522::PICC_TYPE_MIFARE_1K, 16, 1024, CAPACIDADE_CRYPTO1 | CAPACIDADE_ISO_14443_4}
+			   : (product == PRODUCT_SMARTMX_CLASSIC_4K)	? Descritor{MFRC522::PICC_TYPE_MIFARE_4K, 40, 4096, CAPACIDADE_CRYPTO1 | CAPACIDADE_ISO_14443_4}
+			   : (product == PRODUCT_MIFARE_DESFIRE)		? Descritor{MFRC522::PICC_TYPE_MIFARE_DESFIRE, 0, 0, CAPACIDADE_ISO_14443_4 | CAPACIDADE_DESFIRE}
+			   : (product == PRODUCT_ULTRALIGHT)			? Descritor{MFRC522::PICC_TYPE_MIFARE_UL, 0, 0, CAPACIDADE_PAGINAS}
+			   : (product == PRODUCT_TNP3XXX)				? Descritor{MFRC522::PICC_TYPE_TNP3XXX, 0, 0, 0}
+			   : (product == PRODUCT_ISO_14443_4)			? Descritor{MFRC522::PICC_TYPE_ISO_14443_4, 0, 0, CAPACIDADE_ISO_14443_4}
+			   : (product == PRODUCT_NFC_DEP)				? Descritor{MFRC522::PICC_TYPE_ISO_18092, 0, 0, CAPACIDADE_NFC_DEP}
+															: Descritor{MFRC522::PICC_TYPE_UNKNOWN, 0, 0, 0};
+	};
+
+	// Identifica o produto. hist são os bytes históricos do ATS (veja HistoricalBytesOffset()), ou NULL.
+	static constexpr Product Identify(uint16_t atqa, byte sak, const byte *hist, byte histLen)
+	{
+		// Ignora o bit 8 do SAK, que o Infineon usa de forma diferente (http://nfc-tools.org/index.php?title=ISO14443A)
+		return IdentifyMasked(atqa & 0xFF3F, sak & 0x7F, IsPlusHistorical(hist, histLen));
+	};
+
+	// Posição dos bytes históricos nos dados brutos do ATS (TL, T0, [TA1], [TB1], [TC1], históricos..., veja Ats::dados)
+	static constexpr byte HistoricalBytesOffset(byte t0)
+	{
+		return 2 + ((t0 >> 4) & 0x01) + ((t0 >> 5) & 0x01) + ((t0 >> 6) & 0x01);
+	};
+
+protected:
+	// AN10833 3.2: atqa sem os bits de tamanho do UID, sak sem o bit 8
+	static constexpr Product IdentifyMasked(uint16_t atqa, byte sak, bool plus)
+	{
+		return (sak == 0x04)   ? PRODUCT_UID_NOT_COMPLETE
+			   : (sak == 0x09) ? PRODUCT_MIFARE_MINI
+			   : (sak == 0x08) ? PRODUCT_MIFARE_1K
+			   : (sak == 0x19) ? PRODUCT_MIFARE_2K
+			   : (sak == 0x18) ? PRODUCT_MIFARE_4K
+			   : (sak == 0x10) ? PRODUCT_MIFARE_PLUS_2K_SL2
+			   : (sak == 0x11) ? PRODUCT_MIFARE_PLUS_4K_SL2
+			   : (sak == 0x28) ? PRODUCT_SMARTMX_CLASSIC_1K
+			   : (sak == 0x38) ? PRODUCT_SMARTMX_CLASSIC_4K
+			   : (sak == 0x00) ? PRODUCT_ULTRALIGHT
+			   : (sak == 0x01) ? PRODUCT_TNP3XXX
+			   : (sak == 0x40) ? PRODUCT_NFC_DEP
+			   : (sak != 0x20) ? PRODUCT_UNKNOWN
+			   : plus		   ? ((atqa == 0x0002) ? PRODUCT_MIFARE_PLUS_4K_SL3 : PRODUCT_MIFARE_PLUS_2K_SL3)
+			   : (atqa == 0x0304) ? PRODUCT_MIFARE_DESFIRE
+								  : PRODUCT_ISO_14443_4;
+	};
+
+	// Bytes históricos do MIFARE Plus (AN10833 4.2): C1 05 2F 2F, seguidos da versão
+	static constexpr bool IsPlusHistorical(const byte *hist, byte histLen)
+	{
+		return hist != NULL && histLen >= 4 && hist[0] == 0xC1 && hist[1] == 0x05 && hist[2] == 0x2F && hist[3] == 0x2F;
+	};
+};
+
+#endif
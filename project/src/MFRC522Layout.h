@@ -0,0 +1,124 @@
+/**
+ * Modelo da organização da memória dos PICCs MIFARE Classic (Mini, 1K, 2K e 4K).
+ *
+ * Setores 0..31 têm 4 blocos cada; setores 32..39 (apenas 4K) têm 16 blocos cada, a partir do bloco 128.
+ * O último bloco de cada setor é o trailer, com a Chave A, os bits de acesso e a Chave B.
+ *
+ * Todas as funções são constexpr: com argumentos constantes o resultado é calculado em tempo de compilação,
+ * e em tempo de execução elas se reduzem a poucas operações de bits, sem desvios por tipo de cartão.
+ * As condições de acesso das tabelas 7 e 8 do datasheet MF1S50 estão compactadas em constantes de 64 bits,
+ * permitindo verificar uma permissão no MCU antes de enviar um comando que terminaria em NAK
+ * (e que exigiria selecionar e autenticar o PICC novamente).
+ *
+ * Ex.:
+ *   typedef MifareClassicLayout<MFRC522::PICC_TYPE_MIFARE_1K> Layout1K;
+ *   static_assert(Layout1K::TrailerBlock(15) == 63, "");
+ */
+#ifndef MFRC522Layout_h
+#define MFRC522Layout_h
+
+#include <Arduino.h>
+#include "MFRC522.h"
+
+// Geometria comum a todos os PICCs MIFARE Classic
+struct MifareClassicGeometry
+{
+	// Operações em blocos de dados. ACCESS_DECREMENT também cobre Transfer e Restore.
+	enum DataOperation : byte
+	{
+		ACCESS_READ = 0,
+		ACCESS_WRITE = 1,
+		ACCESS_INCREMENT = 2,
+		ACCESS_DECREMENT = 3
+	};
+
+	// Operações no trailer do setor. As Chaves A e B sempre têm a mesma condição de escrita.
+	enum TrailerOperation : byte
+	{
+		TRAILER_READ_ACCESS_BITS = 0,
+		TRAILER_WRITE_ACCESS_BITS = 1,
+		TRAILER_WRITE_KEYS = 2,
+		TRAILER_READ_KEY_B = 3 // Se a Chave B pode ser lida, ela não serve para autenticação
+	};
+
+	// Condições de acesso [C1 C2 C3] -> permissões. Um byte por condição (byte 0 = condição 0),
+	// bit (operação * 2) para a Chave A e bit (operação * 2 + 1) para a Chave B.
+	static constexpr uint64_t DATA_ACCESS_TABLE = 0x00EB020B0A03C3FFull;
+	static constexpr uint64_t TRAILER_ACCESS_TABLE = 0x03030B232B415551ull;
+
+	// Grupo de bits de acesso de cada bloco de um setor de 16 blocos, 2 bits por bloco:
+	// blocos 0-4 -> g0, 5-9 -> g1, 10-14 -> g2, 15 (trailer) -> g3.
+	static constexpr uint32_t GROUP_TABLE_16 = 0xEAA55400ul;
+
+	static constexpr byte BlocksInSector(byte sector) { return (sector < 32) ? 4 : 16; };
+	static constexpr byte FirstBlock(byte sector) { return (sector < 32) ? sector * 4 : 128 + (sector - 32) * 16; };
+	static constexpr byte TrailerBlock(byte sector) { return FirstBlock(sector) + BlocksInSector(sector) - 1; };
+	static constexpr byte SectorOf(byte blockAddr) { return (blockAddr < 128) ? (blockAddr >> 2) : 32 + ((blockAddr - 128) >> 4); };
+	static constexpr byte SectorStart(byte blockAddr) { return (blockAddr < 128) ? (blockAddr & ~0x03) : (blockAddr & ~0x0F); };
+	static constexpr bool IsTrailer(byte blockAddr) { return (blockAddr < 128) ? ((blockAddr & 0x03) == 0x03) : ((blockAddr & 0x0F) == 0x0F); };
+	static constexpr byte AccessGroup(byte blockAddr) { return (blockAddr < 128) ? (blockAddr & 0x03) : (GROUP_TABLE_16 >> ((blockAddr & 0x0F) * 2)) & 0x03; };
+
+	// Permissão de uma operação para a condição de acesso [C1 C2 C3] (0..7) do grupo do bloco.
+	static constexpr bool DataAllows(byte accessBits, DataOperation operation, bool keyB)
+	{
+		return (DATA_ACCESS_TABLE >> ((accessBits & 0x07) * 8 + operation * 2 + (keyB ? 1 : 0))) & 1;
+	};
+	static constexpr bool TrailerAllows(byte accessBits, TrailerOperation operation, bool keyB)
+	{
+		return (TRAILER_ACCESS_TABLE >> ((accessBits & 0x07) * 8 + operation * 2 + (keyB ? 1 : 0))) & 1;
+	};
+
+	// Permissão de uma operação em um bloco de dados, considerando todos os bits de acesso do setor (g[0..3]).
+	static constexpr bool BlockAllows(const byte *g, byte blockAddr, DataOperation operation, bool keyB)
+	{
+		return (!keyB || !TrailerAllows(g[3], TRAILER_READ_KEY_B, false)) && DataAllows(g[AccessGroup(blockAddr)], operation, keyB);
+	};
+};
+
+// Parâmetros de cada tipo de PICC. Apenas as especializações abaixo existem.
+template <MFRC522::PICC_Type PICC_TYPE>
+struct MifareClassicLayout;
+
+template <>
+struct MifareClassicLayout<MFRC522::PICC_TYPE_MIFARE_MINI> : MifareClassicGeometry
+{
+	// 5 setores * 4 blocos/setor * 16 bytes/bloco = 320 bytes.
+	static constexpr byte SECTOR_COUNT = 5;
+	static constexpr uint16_t BLOCK_COUNT = 20;
+};
+
+template <>
+struct MifareClassicLayout<MFRC522::PICC_TYPE_MIFARE_1K> : MifareClassicGeometry
+{
+	// 16 setores * 4 blocos/setor * 16 bytes/bloco = 1024 bytes.
+	static constexpr byte SECTOR_COUNT = 16;
+	static constexpr uint16_t BLOCK_COUNT = 64;
+};
+
+template <>
+struct MifareClassicLayout<MFRC522::PICC_TYPE_MIFARE_2K> : MifareClassicGeometry
+{
+	// 32 setores * 4 blocos/setor * 16 bytes/bloco = 2048 bytes.
+	static constexpr byte SECTOR_COUNT = 32;
+	static constexpr uint16_t BLOCK_COUNT = 128;
+};
+
+template <>
+struct MifareClassicLayout<MFRC522::PICC_TYPE_MIFARE_4K> : MifareClassicGeometry
+{
+	// (32 setores * 4 blocos/setor + 8 setores * 16 blocos/setor) * 16 bytes/bloco = 4096 bytes.
+	static constexpr byte SECTOR_COUNT = 40;
+	static constexpr uint16_t BLOCK_COUNT = 256;
+};
+
+// Número de setores para um tipo conhecido apenas em tempo de execução, 0 se não for MIFARE Classic.
+constexpr byte MifareClassicSectorCount(MFRC522::PICC_Type piccType)
+{
+	return (piccType == MFRC522::PICC_TYPE_MIFARE_MINI) ? MifareClassicLayout<MFRC522::PICC_TYPE_MIFARE_MINI>::SECTOR_COUNT
+		   : (piccType == MFRC522::PICC_TYPE_MIFARE_1K) ? MifareClassicLayout<MFRC522::PICC_TYPE_MIFARE_1K>::SECTOR_COUNT
+		   : (piccType == MFRC522::PICC_TYPE_MIFARE_2K) ? MifareClassicLayout<MFRC522::PICC_TYPE_MIFARE_2K>::SECTOR_COUNT
+		   : (piccType == MFRC522::PICC_TYPE_MIFARE_4K) ? MifareClassicLayout<MFRC522::PICC_TYPE_MIFARE_4K>::SECTOR_COUNT
+														 : 0;
+}
+
+#endif
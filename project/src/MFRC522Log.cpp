@@ -0,0 +1,59 @@
+/*
+ * MFRC522Log.cpp - Registro (log) da biblioteca com nível escolhido em tempo de compilação.
+ * NOTA: Por favor, verifique também os comentários em MFRC522Log.h
+ * Liberado para o domínio público.
+ */
+
+#include "MFRC522Log.h"
+
+#if MFRC522_LOG_LEVEL > MFRC522_LOG_OFF
+
+Print *MFRC522Log::_saida = &Serial;
+
+/**
+ * Escreve uma mensagem de erro em uma linha.
+ */
+void MFRC522Log::Error(const __FlashStringHelper *texto)
+{
+	_saida->println(texto);
+} // Fim Error()
+
+/**
+ * Escreve uma mensagem de erro seguida de um detalhe, normalmente GetStatusCodeName().
+ */
+void MFRC522Log::Error(const __FlashStringHelper *texto, const __FlashStringHelper *detalhe)
+{
+	_saida->print(texto);
+	_saida->println(detalhe);
+} // Fim Error()
+
+/**
+ * Escreve uma mensagem de erro seguida de um byte em hexadecimal.
+ */
+void MFRC522Log::ErrorHex(const __FlashStringHelper *texto, byte valor)
+{
+	_saida->print(texto);
+	_saida->print(F("0x"));
+	if (valor < 0x10)
+	{
+		_saida->print(F("0"));
+	}
+	_saida->println(valor, HEX);
+} // Fim ErrorHex()
+
+/**
+ * Escreve o registro binário de um quadro trocado com o PICC (formato em MFRC522Log.h).
+ */
+void MFRC522Log::Frame(byte comando, byte enviados, byte recebidos, byte status, uint32_t tempoUs)
+{
+	if (tempoUs > 0xFFFFFF)
+	{
+		tempoUs = 0xFFFFFF;
+	}
+	const byte registro[TAMANHO_REGISTRO] = {
+		MARCA_REGISTRO, comando, enviados, recebidos, status,
+		(byte)(tempoUs & 0xFF), (byte)((tempoUs >> 8) & 0xFF), (byte)((tempoUs >> 16) & 0xFF)};
+	_saida->write(registro, sizeof(registro));
+} // Fim Frame()
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * Registro (log) da biblioteca com nível escolhido em tempo de compilação.
+ *
+ * MFRC522_LOG_LEVEL seleciona o que é compilado:
+ *   MFRC522_LOG_OFF   - nada: as macros não geram código nem textos na flash.
+ *   MFRC522_LOG_ERROR - mensagens de erro das funções que recebem logErrors (padrão, como nas versões anteriores).
+ *   MFRC522_LOG_TRACE - também um registro binário de cada quadro trocado com o PICC (veja MFRC522Log::Frame()).
+ * Defina MFRC522_LOG_LEVEL nas opções de compilação (ex.: -DMFRC522_LOG_LEVEL=0) ou altere o padrão abaixo.
+ *
+ * A saída padrão é Serial; qualquer Print (outra serial, um arquivo no cartão SD, ...) pode ser usado com
+ * MFRC522Log::SetSink().
+ *
+ * Registro de quadro (TAMANHO_REGISTRO bytes):
+ *   0    MARCA_REGISTRO
+ *   1    primeiro byte enviado (o comando), 0 se nada foi enviado
+ *   2    bytes enviados
+ *   3    bytes recebidos
+ *   4    StatusCode
+ *   5-7  tempo da troca em microssegundos, 24 bits LSB primeiro, saturado em 0xFFFFFF
+ */
+#ifndef MFRC522Log_h
+#define MFRC522Log_h
+
+#include <Arduino.h>
+
+#define MFRC522_LOG_OFF 0
+#define MFRC522_LOG_ERROR 1
+#define MFRC522_LOG_TRACE 2
+
+#ifndef MFRC522_LOG_LEVEL
+#define MFRC522_LOG_LEVEL MFRC522_LOG_ERROR
+#endif
+
+class MFRC522Log
+{
+public:
+	static constexpr byte MARCA_REGISTRO = 0xA5;
+	static constexpr byte TAMANHO_REGISTRO = 8;
+
+#if MFRC522_LOG_LEVEL > MFRC522_LOG_OFF
+	static void SetSink(Print &saida) { _saida = &saida; };
+	static Print &GetSink() { return *_saida; };
+#else
+	// Sem registro não há destino: SetSink() não faz nada e _saida não existe
+	static void SetSink(Print &) {};
+	static Print &GetSink() { return Serial; };
+#endif
+
+	static void Error(const __FlashStringHelper *texto);
+	static void Error(const __FlashStringHelper *texto, const __FlashStringHelper *detalhe);
+	static void ErrorHex(const __FlashStringHelper *texto, byte valor);
+	static void Frame(byte comando, byte enviados, byte recebidos, byte status, uint32_t tempoUs);
+
+#if MFRC522_LOG_LEVEL > MFRC522_LOG_OFF
+protected:
+	static Print *_saida;
+#endif
+};
+
+#if MFRC522_LOG_LEVEL >= MFRC522_LOG_ERROR
+#define MFRC522_LOG_ERROR_MSG(texto) MFRC522Log::Error(F(texto))
+#define MFRC522_LOG_ERROR_STATUS(texto, status) MFRC522Log::Error(F(texto), MFRC522::GetStatusCodeName(status))
+#define MFRC522_LOG_ERROR_HEX(texto, valor) MFRC522Log::ErrorHex(F(texto), (valor))
+#else
+#define MFRC522_LOG_ERROR_MSG(texto) \
+	do                               \
+	{                                \
+	} while (0)
+#define MFRC522_LOG_ERROR_STATUS(texto, status) \
+	do                                          \
+	{                                           \
+	} while (0)
+#define MFRC522_LOG_ERROR_HEX(texto, valor) \
+	do                                      \
+	{                                       \
+	} while (0)
+#endif
+
+#if MFRC522_LOG_LEVEL >= MFRC522_LOG_TRACE
+#define MFRC522_TRACE_START(inicio) const uint32_t inicio = micros()
+#define MFRC522_TRACE_FRAME(comando, enviados, recebidos, status, inicio) MFRC522Log::Frame((comando), (enviados), (recebidos), (status), micros() - (inicio))
+#else
+#define MFRC522_TRACE_START(inicio) \
+	do                              \
+	{                               \
+	} while (0)
+#define MFRC522_TRACE_FRAME(comando, enviados, recebidos, status, inicio) \
+	do                                                                     \
+	{                                                                      \
+	} while (0)
+#endif
+
+#endif
@@ -0,0 +1,350 @@
+/*
+ * MFRC522Magic.cpp - Identificação de cartões MIFARE Classic "mágicos" e escrita do bloco 0.
+ * NOTA: Por favor, verifique também os comentários em MFRC522Magic.h
+ * Liberado para o domínio público.
+ */
+
+#include "MFRC522Magic.h"
+
+// Os comandos 0x40 e 0x43 da porta dos fundos são respondidos em bem menos de 1 ms
+static constexpr uint32_t TIMEOUT_PORTA_US = 2000;
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Construtores
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Construtor.
+ */
+MFRC522Magic::MFRC522Magic(MFRC522 &leitor ///< Instância MFRC522 usada para a comunicação.
+						   )
+	: _leitor(leitor)
+{
+	for (byte i = 0; i < CACHE_SIZE; i++)
+	{
+		_cache[i].tamanhoUid = 0;
+	}
+	_proximaEntrada = 0;
+} // Fim do construtor
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de identificação
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Identifica a geração de um PICC MIFARE Classic.
+ *
+ * Se o UID já foi identificado, o resultado guardado é retornado sem comunicação com o PICC
+ * (um resultado MAGIC_NO_BACKDOOR é refeito se writeTest for pedido).
+ * Caso contrário o PICC é consultado e continua selecionado ao final.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Magic::Identify(MFRC522::Uid *uid,			///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+										   MFRC522::MIFARE_Key *key,	///< Chave A do setor 0, usada apenas no teste de escrita.
+										   bool writeTest,				///< true para testar a escrita do bloco 0 em PICCs sem porta dos fundos.
+										   Generation *generation		///< Recebe a geração identificada.
+)
+{
+	EntradaCache *entrada = Find(uid);
+	if (entrada && !(writeTest && entrada->geracao == MAGIC_NO_BACKDOOR))
+	{
+		*generation = entrada->geracao;
+		return MFRC522::STATUS_OK;
+	}
+
+	MFRC522::StatusCode resultado = Probe(uid, key, writeTest, generation);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	Remember(uid, *generation);
+	return MFRC522::STATUS_OK;
+} // Fim Identify()
+
+/**
+ * Remove o UID da cache, por exemplo depois de trocar o UID ou bloquear um FUID/UFUID.
+ */
+void MFRC522Magic::Forget(const MFRC522::Uid *uid)
+{
+	EntradaCache *entrada = Find(uid);
+	if (entrada)
+	{
+		entrada->tamanhoUid = 0;
+	}
+} // Fim Forget()
+
+/**
+ * Retorna uma string com o nome da geração.
+ *
+ * @return const __FlashStringHelper *
+ */
+const __FlashStringHelper *MFRC522Magic::GetGenerationName(Generation generation ///< Um dos enums Generation.
+)
+{
+	switch (generation)
+	{
+	case MAGIC_GENUINE:
+		return F("Genuíno (bloco 0 somente leitura)");
+	case MAGIC_GEN1A:
+		return F("Gen1a (porta dos fundos 0x40/0x43)");
+	case MAGIC_GEN2:
+		return F("Gen2/CUID (escrita direta do bloco 0)");
+	case MAGIC_NO_BACKDOOR:
+		return F("Sem porta dos fundos (Gen2, FUID ou genuíno)");
+	case MAGIC_UNKNOWN:
+	default:
+		return F("Geração desconhecida");
+	}
+} // Fim GetGenerationName()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de escrita
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Escreve o bloco 0 pelo método da geração do PICC: porta dos fundos no Gen1a, escrita autenticada
+ * com a Chave A do setor 0 nos demais. Um PICC ainda não identificado é identificado sem o teste de escrita.
+ * Com um UID de 4 bytes, o BCC (byte 4) é conferido antes, pois um BCC errado impede a seleção do PICC.
+ *
+ * O UID muda com o bloco 0: ao terminar, chame PICC_HaltA() e selecione o PICC novamente.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_INVALID para um PICC genuíno, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Magic::WriteBlock0(MFRC522::Uid *uid,		 ///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+											  MFRC522::MIFARE_Key *key, ///< Chave A do setor 0 (não usada no Gen1a).
+											  byte *data				 ///< Os 16 bytes do novo bloco 0.
+)
+{
+	if (uid->size == 4 && (data[0] ^ data[1] ^ data[2] ^ data[3]) != data[4])
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+
+	Generation geracao;
+	MFRC522::StatusCode resultado = Identify(uid, key, false, &geracao);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+
+	switch (geracao)
+	{
+	case MAGIC_GENUINE:
+		return MFRC522::STATUS_INVALID;
+
+	case MAGIC_GEN1A:
+		_leitor.PCD_StopCrypto1();
+		if (!_leitor.MIFARE_OpenUidBackdoor(false))
+		{
+			return MFRC522::STATUS_ERROR;
+		}
+		return _leitor.MIFARE_Write(0, data, 16);
+
+	default:
+		resultado = _leitor.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, 0, key, uid);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+		resultado = _leitor.MIFARE_Write(0, data, 16);
+		if (geracao == MAGIC_NO_BACKDOOR)
+		{ // A escrita respondeu o que o teste de escrita responderia
+			if (resultado == MFRC522::STATUS_OK)
+			{
+				Remember(uid, MAGIC_GEN2);
+			}
+			else if (resultado == MFRC522::STATUS_MIFARE_NACK)
+			{
+				Remember(uid, MAGIC_GENUINE);
+			}
+		}
+		return resultado;
+	}
+} // Fim WriteBlock0()
+
+/**
+ * Troca o UID de um PICC mágico, mantendo os demais dados do fabricante do bloco 0 e recalculando o BCC.
+ * Diferente de MIFARE_SetUid(), que sempre autentica e depois abre a porta dos fundos, usa apenas o
+ * método da geração do PICC.
+ *
+ * O UID muda: ao terminar, chame PICC_HaltA() e selecione o PICC novamente.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_INVALID para um PICC genuíno, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Magic::SetUid(MFRC522::Uid *uid,		///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+										 MFRC522::MIFARE_Key *key, ///< Chave A do setor 0 (não usada no Gen1a).
+										 byte *newUid,				///< O novo UID.
+										 byte uidSize				///< Tamanho do novo UID; o BCC é escrito logo depois.
+)
+{
+	// UID + byte BCC não pode ser maior que 16 juntos
+	if (newUid == nullptr || uidSize == 0 || uidSize > 15)
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+
+	Generation geracao;
+	MFRC522::StatusCode resultado = Identify(uid, key, false, &geracao);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	if (geracao == MAGIC_GENUINE)
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+
+	byte bloco0[18];
+	resultado = ReadBlock0(uid, key, geracao, bloco0);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	byte bcc = 0;
+	for (byte i = 0; i < uidSize; i++)
+	{
+		bloco0[i] = newUid[i];
+		bcc ^= newUid[i];
+	}
+	bloco0[uidSize] = bcc;
+	return WriteBlock0(uid, key, bloco0);
+} // Fim SetUid()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de suporte
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Procura o UID na cache.
+ *
+ * @return A entrada do UID, ou nullptr.
+ */
+MFRC522Magic::EntradaCache *MFRC522Magic::Find(const MFRC522::Uid *uid)
+{
+	for (byte i = 0; i < CACHE_SIZE; i++)
+	{
+		if (_cache[i].tamanhoUid == uid->size && memcmp(_cache[i].uid, uid->uidByte, uid->size) == 0)
+		{
+			return &_cache[i];
+		}
+	}
+	return nullptr;
+} // Fim Find()
+
+/**
+ * Guarda a geração do UID, substituindo a entrada existente ou a mais antiga.
+ */
+void MFRC522Magic::Remember(const MFRC522::Uid *uid, Generation generation)
+{
+	EntradaCache *entrada = Find(uid);
+	if (entrada == nullptr)
+	{
+		entrada = &_cache[_proximaEntrada];
+		_proximaEntrada = (_proximaEntrada + 1) % CACHE_SIZE;
+		entrada->tamanhoUid = uid->size;
+		memcpy(entrada->uid, uid->uidByte, uid->size);
+	}
+	entrada->geracao = generation;
+} // Fim Remember()
+
+/**
+ * Consulta o PICC: a porta dos fundos Gen1a com timeouts curtos e, se pedido, o teste de escrita do bloco 0.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Magic::Probe(MFRC522::Uid *uid, MFRC522::MIFARE_Key *key, bool writeTest, Generation *generation)
+{
+	// HLTA, 0x40 e 0x43: um PICC que não é Gen1a não responde e custa apenas os timeouts curtos
+	const uint32_t timeoutAnterior = _leitor.PCD_GetTimeout();
+	_leitor.PCD_StopCrypto1();
+	_leitor.PCD_SetTimeout(TIMEOUT_PORTA_US);
+	const bool gen1a = _leitor.MIFARE_OpenUidBackdoor(false);
+	_leitor.PCD_SetTimeout(timeoutAnterior);
+
+	MFRC522::StatusCode resultado = Reselect(uid);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	if (gen1a)
+	{
+		*generation = MAGIC_GEN1A;
+		return MFRC522::STATUS_OK;
+	}
+	if (!writeTest)
+	{
+		*generation = MAGIC_NO_BACKDOOR;
+		return MFRC522::STATUS_OK;
+	}
+
+	// Escreve o bloco 0 de volta com o mesmo conteúdo
+	byte bloco0[18];
+	resultado = ReadBlock0(uid, key, MAGIC_GEN2, bloco0);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	resultado = _leitor.MIFARE_Write(0, bloco0, 16);
+	if (resultado == MFRC522::STATUS_OK)
+	{
+		*generation = MAGIC_GEN2;
+	}
+	else if (resultado == MFRC522::STATUS_MIFARE_NACK)
+	{
+		*generation = MAGIC_GENUINE;
+	}
+	else
+	{
+		return resultado;
+	}
+	_leitor.PCD_StopCrypto1();
+	return Reselect(uid);
+} // Fim Probe()
+
+/**
+ * Lê o bloco 0 pelo método da geração: porta dos fundos no Gen1a, leitura autenticada nos demais.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Magic::ReadBlock0(MFRC522::Uid *uid, MFRC522::MIFARE_Key *key, Generation generation, byte *buffer)
+{
+	MFRC522::StatusCode resultado;
+	if (generation == MAGIC_GEN1A)
+	{
+		_leitor.PCD_StopCrypto1();
+		if (!_leitor.MIFARE_OpenUidBackdoor(false))
+		{
+			return MFRC522::STATUS_ERROR;
+		}
+	}
+	else
+	{
+		resultado = _leitor.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, 0, key, uid);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+	}
+	byte tamanho = 18;
+	return _leitor.MIFARE_Read(0, buffer, &tamanho);
+} // Fim ReadBlock0()
+
+/**
+ * Coloca o PICC em HALT e o seleciona novamente, saindo da porta dos fundos ou de uma autenticação.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Magic::Reselect(MFRC522::Uid *uid)
+{
+	byte atqa[2];
+	byte tamanho = sizeof(atqa);
+
+	_leitor.PICC_HaltA();
+	MFRC522::StatusCode resultado = _leitor.PICC_WakeupA(atqa, &tamanho);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	return _leitor.PICC_Select(uid, uid->size * 8);
+} // Fim Reselect()
@@ -0,0 +1,84 @@
+/**
+ * Identificação de cartões MIFARE Classic "mágicos" (UID modificável) e escrita do bloco 0.
+ *
+ * Identify() classifica o PICC em uma única sequência curta:
+ *   1. HLTA e os comandos 0x40 (7 bits) e 0x43 da porta dos fundos, com timeouts de poucos milissegundos;
+ *      se ambos forem respondidos, o PICC é Gen1a.
+ *   2. Caso contrário, com writeTest, o bloco 0 é lido e escrito de volta com o mesmo conteúdo: se a escrita
+ *      for aceita o PICC é Gen2 (CUID), se for recusada com NAK ele é genuíno.
+ * O PICC termina selecionado e o resultado é guardado por UID, então um mesmo PICC é identificado apenas uma vez.
+ *
+ * Correspondência com os outros nomes usados para esses cartões:
+ *   UFUID ainda não bloqueado -> MAGIC_GEN1A (responde à porta dos fundos)
+ *   FUID ainda não escrito    -> MAGIC_GEN2; ATENÇÃO: o teste de escrita grava o bloco 0 e bloqueia o FUID
+ *                                (com o mesmo conteúdo). Sem writeTest o resultado é MAGIC_NO_BACKDOOR.
+ *   FUID e UFUID bloqueados   -> MAGIC_GENUINE
+ *
+ * WriteBlock0() e SetUid() usam o resultado guardado para ir direto ao método certo: porta dos fundos
+ * no Gen1a, escrita autenticada no Gen2, e STATUS_INVALID sem nenhum comando no genuíno.
+ *
+ * Ex.:
+ *   MFRC522Magic magico(mfrc522);
+ *   MFRC522Magic::Generation geracao;
+ *   if (magico.Identify(&mfrc522.uid, &chave, false, &geracao) == MFRC522::STATUS_OK && geracao == MFRC522Magic::MAGIC_GEN1A) { ... }
+ */
+#ifndef MFRC522Magic_h
+#define MFRC522Magic_h
+
+#include <Arduino.h>
+#include "MFRC522.h"
+
+class MFRC522Magic
+{
+public:
+	// Gerações identificadas. Lembre-se de atualizar GetGenerationName() se adicionar mais.
+	enum Generation : byte
+	{
+		MAGIC_UNKNOWN = 0,
+		MAGIC_GENUINE,	   // O bloco 0 não pode ser escrito
+		MAGIC_GEN1A,	   // Porta dos fundos 0x40/0x43: todos os blocos sem autenticação
+		MAGIC_GEN2,		   // Bloco 0 escrito diretamente, com autenticação (CUID)
+		MAGIC_NO_BACKDOOR  // Sem porta dos fundos, escrita do bloco 0 não testada (Gen2, FUID ou genuíno)
+	};
+
+	// Número de UIDs guardados com a geração identificada
+	static constexpr byte CACHE_SIZE = 4;
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Construtores
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522Magic(MFRC522 &leitor);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções de identificação
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522::StatusCode Identify(MFRC522::Uid *uid, MFRC522::MIFARE_Key *key, bool writeTest, Generation *generation);
+	void Forget(const MFRC522::Uid *uid);
+	static const __FlashStringHelper *GetGenerationName(Generation generation);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções de escrita
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522::StatusCode WriteBlock0(MFRC522::Uid *uid, MFRC522::MIFARE_Key *key, byte *data);
+	MFRC522::StatusCode SetUid(MFRC522::Uid *uid, MFRC522::MIFARE_Key *key, byte *newUid, byte uidSize);
+
+protected:
+	typedef struct
+	{
+		byte tamanhoUid; // 0 se a entrada estiver livre
+		byte uid[10];
+		Generation geracao;
+	} EntradaCache;
+
+	MFRC522 &_leitor;
+	EntradaCache _cache[CACHE_SIZE];
+	byte _proximaEntrada; // Próxima entrada a substituir (circular)
+
+	EntradaCache *Find(const MFRC522::Uid *uid);
+	void Remember(const MFRC522::Uid *uid, Generation generation);
+	MFRC522::StatusCode Probe(MFRC522::Uid *uid, MFRC522::MIFARE_Key *key, bool writeTest, Generation *generation);
+	MFRC522::StatusCode ReadBlock0(MFRC522::Uid *uid, MFRC522::MIFARE_Key *key, Generation generation, byte *buffer);
+	MFRC522::StatusCode Reselect(MFRC522::Uid *uid);
+};
+
+#endif
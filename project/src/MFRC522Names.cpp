@@ -0,0 +1,143 @@
+/*
+ * MFRC522Names.cpp - Nomes dos códigos de status e dos tipos de PICC.
+ * NOTA: Por favor, verifique também os comentários em MFRC522.h
+ * Liberado para o domínio público.
+ *
+ * Em uma unidade de compilação separada, os textos só entram no programa se GetStatusCodeName() ou
+ * PICC_GetTypeName() forem usados (pelo programa, pelos despejos ou pelo log de erros). Com
+ * MFRC522_NAMES igual a MFRC522_NAMES_SHORT, os textos são os nomes dos enums, bem mais curtos.
+ */
+
+#include "MFRC522.h"
+
+/**
+ * Retorna um ponteiro __FlashStringHelper para o nome do código de status.
+ *
+ * @return const __FlashStringHelper *
+ */
+const __FlashStringHelper *MFRC522::GetStatusCodeName(MFRC522::StatusCode code ///< Um dos enums StatusCode.
+)
+{
+#if MFRC522_NAMES == MFRC522_NAMES_FULL
+	switch (code)
+	{
+	case STATUS_OK:
+		return F("Sucesso.");
+	case STATUS_ERROR:
+		return F("Erro na comunicação.");
+	case STATUS_COLLISION:
+		return F("Colisão detectada.");
+	case STATUS_TIMEOUT:
+		return F("Timeout na comunicação.");
+	case STATUS_NO_ROOM:
+		return F("Um buffer não tem tamanho suficiente.");
+	case STATUS_INTERNAL_ERROR:
+		return F("Erro interno no código. Não deveria ocorrer.");
+	case STATUS_INVALID:
+		return F("Argumento inválido.");
+	case STATUS_CRC_WRONG:
+		return F("O CRC_A não corresponde.");
+	case STATUS_PENDING:
+		return F("Comando ainda em andamento.");
+	case STATUS_MIFARE_NACK:
+		return F("Um PICC MIFARE respondeu com NAK.");
+	default:
+		return F("Erro desconhecido");
+	}
+#else
+	switch (code)
+	{
+	case STATUS_OK:
+		return F("OK");
+	case STATUS_ERROR:
+		return F("ERROR");
+	case STATUS_COLLISION:
+		return F("COLLISION");
+	case STATUS_TIMEOUT:
+		return F("TIMEOUT");
+	case STATUS_NO_ROOM:
+		return F("NO_ROOM");
+	case STATUS_INTERNAL_ERROR:
+		return F("INTERNAL_ERROR");
+	case STATUS_INVALID:
+		return F("INVALID");
+	case STATUS_CRC_WRONG:
+		return F("CRC_WRONG");
+	case STATUS_PENDING:
+		return F("PENDING");
+	case STATUS_MIFARE_NACK:
+		return F("MIFARE_NACK");
+	default:
+		return F("?");
+	}
+#endif
+} // Fim GetStatusCodeName()
+
+/**
+ * Retorna um ponteiro __FlashStringHelper para o nome do tipo de PICC.
+ *
+ * @return const __FlashStringHelper *
+ */
+const __FlashStringHelper *MFRC522::PICC_GetTypeName(PICC_Type piccType ///< Um dos enums PICC_Type.
+)
+{
+#if MFRC522_NAMES == MFRC522_NAMES_FULL
+	switch (piccType)
+	{
+	case PICC_TYPE_ISO_14443_4:
+		return F("PICC compatível com ISO/IEC 14443-4");
+	case PICC_TYPE_ISO_18092:
+		return F("PICC compatível com ISO/IEC 18092 (NFC)");
+	case PICC_TYPE_MIFARE_MINI:
+		return F("MIFARE Mini, 320 bytes");
+	case PICC_TYPE_MIFARE_1K:
+		return F("MIFARE 1KB");
+	case PICC_TYPE_MIFARE_2K:
+		return F("MIFARE 2KB");
+	case PICC_TYPE_MIFARE_4K:
+		return F("MIFARE 4KB");
+	case PICC_TYPE_MIFARE_UL:
+		return F("MIFARE Ultralight ou Ultralight C");
+	case PICC_TYPE_MIFARE_PLUS:
+		return F("MIFARE Plus");
+	case PICC_TYPE_MIFARE_DESFIRE:
+		return F("MIFARE DESFire");
+	case PICC_TYPE_TNP3XXX:
+		return F("MIFARE TNP3XXX");
+	case PICC_TYPE_NOT_COMPLETE:
+		return F("SAK indica que o UID não está completo.");
+	case PICC_TYPE_UNKNOWN:
+	default:
+		return F("Tipo desconhecido");
+	}
+#else
+	switch (piccType)
+	{
+	case PICC_TYPE_ISO_14443_4:
+		return F("ISO_14443_4");
+	case PICC_TYPE_ISO_18092:
+		return F("ISO_18092");
+	case PICC_TYPE_MIFARE_MINI:
+		return F("MIFARE_MINI");
+	case PICC_TYPE_MIFARE_1K:
+		return F("MIFARE_1K");
+	case PICC_TYPE_MIFARE_2K:
+		return F("MIFARE_2K");
+	case PICC_TYPE_MIFARE_4K:
+		return F("MIFARE_4K");
+	case PICC_TYPE_MIFARE_UL:
+		return F("MIFARE_UL");
+	case PICC_TYPE_MIFARE_PLUS:
+		return F("MIFARE_PLUS");
+	case PICC_TYPE_MIFARE_DESFIRE:
+		return F("MIFARE_DESFIRE");
+	case PICC_TYPE_TNP3XXX:
+		return F("TNP3XXX");
+	case PICC_TYPE_NOT_COMPLETE:
+		return F("NOT_COMPLETE");
+	case PICC_TYPE_UNKNOWN:
+	default:
+		return F("UNKNOWN");
+	}
+#endif
+} // Fim PICC_GetTypeName()
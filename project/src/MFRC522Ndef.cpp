@@ -0,0 +1,509 @@
+/*
+ * MFRC522Ndef.cpp - Leitura e escrita de mensagens NDEF por páginas, sem buffer da mensagem inteira.
+ * NOTA: Por favor, verifique também os comentários em MFRC522Ndef.h
+ * Liberado para o domínio público.
+ */
+
+#include "MFRC522Ndef.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+// MFRC522NdefReader - Construtores
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Construtor.
+ * A área de dados de uma Type 2 Tag começa na página 4; a última página vem da geometria do PICC
+ * (veja MFRC522Ultralight::GetGeometry()) ou do Capability Container (página 3).
+ */
+MFRC522NdefReader::MFRC522NdefReader(MFRC522 &leitor,	  ///< Instância MFRC522 usada para a comunicação.
+									 byte primeiraPagina, ///< Primeira página da área de dados.
+									 byte ultimaPagina,	  ///< Última página da área de dados, inclusive.
+									 bool fastRead		  ///< true para ler com FAST_READ (Ultralight EV1 e NTAG21x), false para MIFARE_Read.
+									 )
+	: _leitor(leitor)
+{
+	_primeiraPagina = primeiraPagina;
+	_ultimaPagina = ultimaPagina;
+	_fastRead = fastRead;
+	_tamanhoJanela = 0;
+	Rewind();
+} // Fim do construtor
+
+/////////////////////////////////////////////////////////////////////////////////////
+// MFRC522NdefReader - Funções de leitura
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Volta ao início da área de dados. A janela já lida continua válida.
+ */
+void MFRC522NdefReader::Rewind()
+{
+	_posicao = 0;
+	_restanteTlv = 0;
+	_restantePayload = 0;
+	_emMensagem = false;
+	_ultimoRegistro = false;
+} // Fim Rewind()
+
+/**
+ * Avança para o próximo TLV. O valor do TLV anterior que não foi consumido é pulado.
+ * TLVs NULL são pulados. Depois de um TLV de mensagem NDEF, use NextRecord() para percorrer os registros.
+ *
+ * @return STATUS_OK em caso de sucesso (tipo NDEF_TLV_TERMINATOR no fim), STATUS_NO_ROOM no fim da área de dados, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NdefReader::NextTlv(byte *tipo,		 ///< Recebe o tipo do TLV, um dos enums NdefTlv.
+											   uint16_t *tamanho ///< Recebe o tamanho do valor do TLV.
+)
+{
+	MFRC522::StatusCode resultado;
+	byte dado;
+
+	resultado = Skip(_restanteTlv);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	_restanteTlv = 0;
+	_restantePayload = 0;
+	_emMensagem = false;
+
+	do
+	{
+		resultado = ReadByte(tipo);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+	} while (*tipo == NDEF_TLV_NULL);
+
+	*tamanho = 0;
+	if (*tipo == NDEF_TLV_TERMINATOR)
+	{
+		return MFRC522::STATUS_OK;
+	}
+
+	// Tamanho: 1 byte, ou 0xFF seguido de 2 bytes (MSB primeiro)
+	resultado = ReadByte(&dado);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	if (dado == 0xFF)
+	{
+		byte msb, lsb;
+		resultado = ReadByte(&msb);
+		if (resultado == MFRC522::STATUS_OK)
+		{
+			resultado = ReadByte(&lsb);
+		}
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+		*tamanho = ((uint16_t)msb << 8) | lsb;
+	}
+	else
+	{
+		*tamanho = dado;
+	}
+	_restanteTlv = *tamanho;
+	_emMensagem = (*tipo == NDEF_TLV_MESSAGE);
+	_ultimoRegistro = false;
+	return MFRC522::STATUS_OK;
+} // Fim NextTlv()
+
+/**
+ * Avança para o próximo registro NDEF. Se nenhum TLV de mensagem estiver aberto, procura o próximo.
+ * O payload do registro anterior que não foi lido é pulado; o ID do registro é pulado.
+ *
+ * Registros em partes são retornados parte a parte: enquanto NDEF_FLAG_CF estiver no cabeçalho, a próxima
+ * parte (TNF NDEF_TNF_UNCHANGED) continua o payload.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_NO_ROOM se não houver mais registros, STATUS_INVALID se o registro não couber no TLV, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NdefReader::NextRecord(NdefRecord *registro ///< Recebe o cabeçalho e o tipo do registro.
+)
+{
+	MFRC522::StatusCode resultado;
+	byte dado;
+
+	if (_emMensagem)
+	{
+		resultado = Skip(_restantePayload);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+		_restanteTlv -= _restantePayload;
+		_restantePayload = 0;
+	}
+
+	// Procura um TLV de mensagem com registros restantes
+	while (!_emMensagem || _ultimoRegistro || _restanteTlv == 0)
+	{
+		byte tipo;
+		uint16_t tamanho;
+		resultado = NextTlv(&tipo, &tamanho);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+		if (tipo == NDEF_TLV_TERMINATOR)
+		{
+			return MFRC522::STATUS_NO_ROOM;
+		}
+	}
+
+	// Cabeçalho: flags, tamanho do tipo, tamanho do payload (1 ou 4 bytes), tamanho do ID (opcional)
+	uint16_t inicio = _posicao;
+	resultado = ReadByte(&registro->header);
+	if (resultado == MFRC522::STATUS_OK)
+	{
+		resultado = ReadByte(&registro->typeLength);
+	}
+	registro->payloadLength = 0;
+	for (byte i = 0; resultado == MFRC522::STATUS_OK && i < ((registro->header & NDEF_FLAG_SR) ? 1 : 4); i++)
+	{
+		resultado = ReadByte(&dado);
+		registro->payloadLength = (registro->payloadLength << 8) | dado;
+	}
+	byte tamanhoId = 0;
+	if (resultado == MFRC522::STATUS_OK && (registro->header & NDEF_FLAG_IL))
+	{
+		resultado = ReadByte(&tamanhoId);
+	}
+	for (byte i = 0; resultado == MFRC522::STATUS_OK && i < registro->typeLength; i++)
+	{
+		resultado = ReadByte(&dado);
+		if (i < MAX_TYPE_LENGTH)
+		{
+			registro->type[i] = dado;
+		}
+	}
+	if (resultado == MFRC522::STATUS_OK)
+	{
+		resultado = Skip(tamanhoId);
+	}
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+
+	uint16_t consumido = _posicao - inicio;
+	if (consumido > _restanteTlv || registro->payloadLength > (uint32_t)(_restanteTlv - consumido))
+	{ // O registro não cabe no TLV: mensagem corrompida
+		_emMensagem = false;
+		return MFRC522::STATUS_INVALID;
+	}
+	_restanteTlv -= consumido;
+	_restantePayload = registro->payloadLength;
+	_ultimoRegistro = (registro->header & NDEF_FLAG_ME) && !(registro->header & NDEF_FLAG_CF);
+	return MFRC522::STATUS_OK;
+} // Fim NextRecord()
+
+/**
+ * Lê o próximo pedaço do payload do registro atual.
+ *
+ * @return STATUS_OK em caso de sucesso (*length == 0 no fim do payload), STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NdefReader::ReadPayload(byte *buffer,		///< Buffer para o pedaço do payload.
+												   uint16_t bufferSize, ///< Tamanho do buffer.
+												   uint16_t *length		///< Recebe o número de bytes lidos.
+)
+{
+	uint16_t quantidade = (_restantePayload < bufferSize) ? _restantePayload : bufferSize;
+	for (uint16_t i = 0; i < quantidade; i++)
+	{
+		MFRC522::StatusCode resultado = ReadByte(&buffer[i]);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+	}
+	_restantePayload -= quantidade;
+	_restanteTlv -= quantidade;
+	*length = quantidade;
+	return MFRC522::STATUS_OK;
+} // Fim ReadPayload()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// MFRC522NdefReader - Funções de suporte
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Lê o próximo byte da área de dados, lendo uma nova janela quando necessário.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_NO_ROOM no fim da área de dados, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NdefReader::ReadByte(byte *dado)
+{
+	if (_tamanhoJanela == 0 || _posicao < _inicioJanela || _posicao >= _inicioJanela + _tamanhoJanela)
+	{
+		MFRC522::StatusCode resultado = FillWindow();
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+	}
+	*dado = _janela[_posicao - _inicioJanela];
+	_posicao++;
+	return MFRC522::STATUS_OK;
+} // Fim ReadByte()
+
+/**
+ * Pula bytes da área de dados. Janelas inteiras puladas não são lidas do PICC.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_NO_ROOM se passar do fim da área de dados.
+ */
+MFRC522::StatusCode MFRC522NdefReader::Skip(uint32_t quantidade)
+{
+	const uint32_t fim = ((uint32_t)_ultimaPagina - _primeiraPagina + 1) * 4;
+	if (_posicao + quantidade > fim)
+	{
+		_posicao = fim;
+		return MFRC522::STATUS_NO_ROOM;
+	}
+	_posicao += quantidade;
+	return MFRC522::STATUS_OK;
+} // Fim Skip()
+
+/**
+ * Lê a janela que contém a posição atual: WINDOW_PAGES páginas com FAST_READ ou 4 páginas com MIFARE_Read.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_NO_ROOM no fim da área de dados, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NdefReader::FillWindow()
+{
+	MFRC522::StatusCode resultado;
+	uint16_t pagina = _primeiraPagina + _posicao / 4;
+	if (pagina > _ultimaPagina)
+	{
+		return MFRC522::STATUS_NO_ROOM;
+	}
+
+	_tamanhoJanela = 0;
+	if (_fastRead)
+	{
+		uint16_t ultima = pagina + WINDOW_PAGES - 1;
+		if (ultima > _ultimaPagina)
+		{
+			ultima = _ultimaPagina;
+		}
+		uint16_t tamanho = sizeof(_janela);
+		resultado = _leitor.MIFARE_Ultralight_FastRead(pagina, (byte)ultima, _janela, &tamanho);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+		_tamanhoJanela = tamanho;
+	}
+	else
+	{
+		byte tamanho = sizeof(_janela); // MIFARE_Read precisa de 18 bytes: 16 de dados e o CRC_A
+		resultado = _leitor.MIFARE_Read(pagina, _janela, &tamanho);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+		// MIFARE_Read retorna 4 páginas; no fim da memória o PICC volta à página 0, então descarte o excesso.
+		uint16_t paginasValidas = _ultimaPagina - pagina + 1;
+		_tamanhoJanela = (paginasValidas < 4) ? paginasValidas * 4 : 16;
+	}
+	_inicioJanela = (pagina - _primeiraPagina) * 4;
+	return MFRC522::STATUS_OK;
+} // Fim FillWindow()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// MFRC522NdefWriter - Construtores
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Construtor.
+ */
+MFRC522NdefWriter::MFRC522NdefWriter(MFRC522 &leitor,	  ///< Instância MFRC522 usada para a comunicação.
+									 byte primeiraPagina, ///< Primeira página da área de dados.
+									 byte ultimaPagina	  ///< Última página da área de dados, inclusive.
+									 )
+	: _leitor(leitor)
+{
+	_primeiraPagina = primeiraPagina;
+	_ultimaPagina = ultimaPagina;
+	_bytesPagina = 0;
+	_proximaPagina = primeiraPagina;
+	_semEspaco = false;
+} // Fim do construtor
+
+/////////////////////////////////////////////////////////////////////////////////////
+// MFRC522NdefWriter - Funções de escrita
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Calcula o tamanho de um registro (cabeçalho, tipo e payload), para informar o tamanho da mensagem a Begin().
+ * Registros com payload de até 255 bytes usam o formato curto.
+ */
+uint32_t MFRC522NdefWriter::RecordSize(byte typeLength, uint32_t payloadLength)
+{
+	return 2 + (payloadLength <= 0xFF ? 1 : 4) + typeLength + payloadLength;
+} // Fim RecordSize()
+
+/**
+ * Começa uma mensagem NDEF na primeira página: grava o TLV de mensagem com o tamanho informado.
+ * O tamanho é a soma de RecordSize() de todos os registros.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NdefWriter::Begin(uint16_t messageLength ///< Tamanho da mensagem NDEF, em bytes.
+)
+{
+	MFRC522::StatusCode resultado;
+
+	_bytesPagina = 0;
+	_proximaPagina = _primeiraPagina;
+	_semEspaco = false;
+
+	resultado = WriteByte(NDEF_TLV_MESSAGE);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	if (messageLength < 0xFF)
+	{
+		return WriteByte(messageLength);
+	}
+	resultado = WriteByte(0xFF);
+	if (resultado == MFRC522::STATUS_OK)
+	{
+		resultado = WriteByte(messageLength >> 8);
+	}
+	if (resultado == MFRC522::STATUS_OK)
+	{
+		resultado = WriteByte(messageLength & 0xFF);
+	}
+	return resultado;
+} // Fim Begin()
+
+/**
+ * Grava o cabeçalho e o tipo de um registro. O payload é gravado em seguida com Write().
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NdefWriter::AddRecord(byte flags,			///< TNF e NDEF_FLAG_MB/ME/CF. SR e IL são definidos aqui.
+												 const byte *type,		///< Tipo do registro.
+												 byte typeLength,		///< Tamanho do tipo.
+												 uint32_t payloadLength ///< Tamanho do payload.
+)
+{
+	MFRC522::StatusCode resultado;
+	const bool curto = (payloadLength <= 0xFF);
+
+	flags &= ~(NDEF_FLAG_SR | NDEF_FLAG_IL);
+	if (curto)
+	{
+		flags |= NDEF_FLAG_SR;
+	}
+	resultado = WriteByte(flags);
+	if (resultado == MFRC522::STATUS_OK)
+	{
+		resultado = WriteByte(typeLength);
+	}
+	for (int8_t i = curto ? 0 : 3; resultado == MFRC522::STATUS_OK && i >= 0; i--)
+	{
+		resultado = WriteByte((payloadLength >> (8 * i)) & 0xFF);
+	}
+	if (resultado == MFRC522::STATUS_OK)
+	{
+		resultado = Write(type, typeLength);
+	}
+	return resultado;
+} // Fim AddRecord()
+
+/**
+ * Grava bytes do payload. Cada página completada é gravada imediatamente.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_NO_ROOM se a área de dados acabar, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NdefWriter::Write(const byte *data, ///< Bytes a gravar.
+											 uint16_t length   ///< Número de bytes.
+)
+{
+	for (uint16_t i = 0; i < length; i++)
+	{
+		MFRC522::StatusCode resultado = WriteByte(data[i]);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+	}
+	return MFRC522::STATUS_OK;
+} // Fim Write()
+
+/**
+ * Termina a mensagem: grava o TLV terminador e a última página, completada com zeros.
+ * Se a área de dados acabar exatamente no fim da mensagem, o terminador é omitido.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NdefWriter::End()
+{
+	if (_semEspaco && _bytesPagina == 0)
+	{
+		return MFRC522::STATUS_OK;
+	}
+	MFRC522::StatusCode resultado = WriteByte(NDEF_TLV_TERMINATOR);
+	if (resultado != MFRC522::STATUS_OK || _bytesPagina == 0)
+	{
+		return resultado;
+	}
+	while (_bytesPagina < 4)
+	{
+		_pagina[_bytesPagina++] = 0x00;
+	}
+	return Flush();
+} // Fim End()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// MFRC522NdefWriter - Funções de suporte
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Acrescenta um byte à página em montagem e a grava quando completa.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_NO_ROOM se a área de dados acabar, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NdefWriter::WriteByte(byte dado)
+{
+	if (_semEspaco)
+	{
+		return MFRC522::STATUS_NO_ROOM;
+	}
+	_pagina[_bytesPagina++] = dado;
+	if (_bytesPagina < 4)
+	{
+		return MFRC522::STATUS_OK;
+	}
+	return Flush();
+} // Fim WriteByte()
+
+/**
+ * Grava a página em montagem com MIFARE_Ultralight_Write().
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NdefWriter::Flush()
+{
+	MFRC522::StatusCode resultado = _leitor.MIFARE_Ultralight_Write(_proximaPagina, _pagina, 4);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	_bytesPagina = 0;
+	if (_proximaPagina == _ultimaPagina)
+	{
+		_semEspaco = true;
+	}
+	else
+	{
+		_proximaPagina++;
+	}
+	return MFRC522::STATUS_OK;
+} // Fim Flush()
@@ -0,0 +1,140 @@
+/**
+ * Leitura e escrita de mensagens NDEF (NFC Forum Type 2 Tag) em PICCs MIFARE Ultralight e NTAG21x, sem
+ * guardar a mensagem inteira na RAM.
+ *
+ * MFRC522NdefReader percorre os TLVs e os registros NDEF (curtos, longos e em partes) a partir de uma
+ * janela de páginas: a memória usada não depende do tamanho da mensagem. O objeto guarda a janela
+ * (WINDOW_PAGES páginas, 4 * WINDOW_PAGES bytes); durante a leitura com FAST_READ, PCD_TransceiveLong()
+ * usa ainda um buffer de FIFO_SIZE bytes na pilha para esvaziar a FIFO, então o pico é a janela mais
+ * FIFO_SIZE. Com MIFARE_Read apenas 4 páginas da janela são usadas. O payload é entregue em pedaços do
+ * tamanho que o chamador escolher.
+ *
+ * MFRC522NdefWriter gera o TLV da mensagem e os registros e grava cada página com MIFARE_Ultralight_Write()
+ * assim que ela é completada; apenas uma página (4 bytes) fica na RAM.
+ *
+ * Ex.: ler todos os registros
+ *   MFRC522NdefReader ndef(mfrc522, 4, 0x27, true);
+ *   MFRC522NdefReader::NdefRecord registro;
+ *   while (ndef.NextRecord(&registro) == MFRC522::STATUS_OK) {
+ *     while (ndef.ReadPayload(pedaco, sizeof(pedaco), &n) == MFRC522::STATUS_OK && n) { ... }
+ *   }
+ */
+#ifndef MFRC522Ndef_h
+#define MFRC522Ndef_h
+
+#include <Arduino.h>
+#include "MFRC522.h"
+
+// Tipos de TLV de uma Type 2 Tag
+enum NdefTlv : byte
+{
+	NDEF_TLV_NULL = 0x00,
+	NDEF_TLV_LOCK_CONTROL = 0x01,
+	NDEF_TLV_MEMORY_CONTROL = 0x02,
+	NDEF_TLV_MESSAGE = 0x03,
+	NDEF_TLV_PROPRIETARY = 0xFD,
+	NDEF_TLV_TERMINATOR = 0xFE
+};
+
+// Bits do cabeçalho de um registro NDEF
+enum NdefFlag : byte
+{
+	NDEF_FLAG_MB = 0x80, // Primeiro registro da mensagem
+	NDEF_FLAG_ME = 0x40, // Último registro da mensagem
+	NDEF_FLAG_CF = 0x20, // O payload continua no próximo registro (registro em partes)
+	NDEF_FLAG_SR = 0x10, // Registro curto: tamanho do payload em 1 byte
+	NDEF_FLAG_IL = 0x08, // Campo de tamanho do ID presente
+	NDEF_TNF_MASK = 0x07
+};
+
+// Type Name Format
+enum NdefTnf : byte
+{
+	NDEF_TNF_EMPTY = 0x00,
+	NDEF_TNF_WELL_KNOWN = 0x01,
+	NDEF_TNF_MIME = 0x02,
+	NDEF_TNF_URI = 0x03,
+	NDEF_TNF_EXTERNAL = 0x04,
+	NDEF_TNF_UNKNOWN = 0x05,
+	NDEF_TNF_UNCHANGED = 0x06 // Partes seguintes de um registro em partes
+};
+
+class MFRC522NdefReader
+{
+public:
+	// Tamanho da janela de leitura com FAST_READ, em páginas
+	static constexpr byte WINDOW_PAGES = 16;
+	// Bytes do tipo de registro guardados em NdefRecord::type; tipos maiores são truncados
+	static constexpr byte MAX_TYPE_LENGTH = 8;
+
+	typedef struct
+	{
+		byte header;			// MB ME CF SR IL TNF
+		byte typeLength;		// Tamanho real do tipo (apenas os primeiros MAX_TYPE_LENGTH bytes ficam em type)
+		byte type[MAX_TYPE_LENGTH];
+		uint32_t payloadLength;
+	} NdefRecord;
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Construtores
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522NdefReader(MFRC522 &leitor, byte primeiraPagina, byte ultimaPagina, bool fastRead);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções de leitura
+	/////////////////////////////////////////////////////////////////////////////////////
+	void Rewind();
+	MFRC522::StatusCode NextTlv(byte *tipo, uint16_t *tamanho);
+	MFRC522::StatusCode NextRecord(NdefRecord *registro);
+	MFRC522::StatusCode ReadPayload(byte *buffer, uint16_t bufferSize, uint16_t *length);
+
+protected:
+	MFRC522 &_leitor;
+	byte _primeiraPagina;
+	byte _ultimaPagina;
+	bool _fastRead;
+	byte _janela[4 * WINDOW_PAGES];
+	uint16_t _posicao;		   // Próximo byte a ler, contado a partir de primeiraPagina
+	uint16_t _inicioJanela;	   // Posição do primeiro byte da janela
+	uint16_t _tamanhoJanela;   // Bytes válidos na janela, 0 se vazia
+	uint16_t _restanteTlv;	   // Bytes do valor do TLV atual ainda não consumidos
+	uint32_t _restantePayload; // Bytes do payload do registro atual ainda não lidos
+	bool _emMensagem;		   // true dentro do valor de um TLV de mensagem NDEF
+	bool _ultimoRegistro;	   // true depois do registro com ME
+
+	MFRC522::StatusCode ReadByte(byte *dado);
+	MFRC522::StatusCode Skip(uint32_t quantidade);
+	MFRC522::StatusCode FillWindow();
+};
+
+class MFRC522NdefWriter
+{
+public:
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Construtores
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522NdefWriter(MFRC522 &leitor, byte primeiraPagina, byte ultimaPagina);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções de escrita
+	/////////////////////////////////////////////////////////////////////////////////////
+	static uint32_t RecordSize(byte typeLength, uint32_t payloadLength);
+	MFRC522::StatusCode Begin(uint16_t messageLength);
+	MFRC522::StatusCode AddRecord(byte flags, const byte *type, byte typeLength, uint32_t payloadLength);
+	MFRC522::StatusCode Write(const byte *data, uint16_t length);
+	MFRC522::StatusCode End();
+
+protected:
+	MFRC522 &_leitor;
+	byte _primeiraPagina;
+	byte _ultimaPagina;
+	byte _pagina[4];	   // Página em montagem
+	byte _bytesPagina;	   // Bytes válidos em _pagina
+	byte _proximaPagina;   // Página que recebe _pagina
+	bool _semEspaco;	   // true depois que a última página foi gravada
+
+	MFRC522::StatusCode WriteByte(byte dado);
+	MFRC522::StatusCode Flush();
+};
+
+#endif
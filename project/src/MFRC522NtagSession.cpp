@@ -0,0 +1,336 @@
+/*
+ * MFRC522NtagSession.cpp - Sessão autenticada com PWD_AUTH em PICCs NTAG21x e Ultralight EV1.
+ * NOTA: Por favor, verifique também os comentários em MFRC522NtagSession.h
+ * Liberado para o domínio público.
+ */
+
+#include "MFRC522NtagSession.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Construtores
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Construtor.
+ * Use em attemptLimit um valor menor que o AUTHLIM configurado no PICC, para que sempre reste uma tentativa.
+ */
+MFRC522NtagSession::MFRC522NtagSession(MFRC522 &leitor,	  ///< Instância MFRC522 usada para a comunicação.
+									   byte attemptLimit ///< Senhas recusadas aceitas por UID, ou 0 para não limitar.
+									   )
+	: _leitor(leitor)
+{
+	_limiteTentativas = attemptLimit;
+	_autenticado = false;
+	_semFastRead = false;
+	_tamanhoUid = 0;
+	for (byte i = 0; i < CACHE_SIZE; i++)
+	{
+		_cache[i].tamanhoUid = 0;
+	}
+	_proximaEntrada = 0;
+} // Fim do construtor
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções da sessão
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Inicia a sessão de uma nova seleção do PICC. Deve ser chamado após cada PICC_Select() ou PICC_ReadCardSerial(),
+ * mesmo com o mesmo UID: o PICC selecionado novamente não está mais no estado AUTHENTICATED.
+ * As senhas recusadas contadas para o UID são mantidas.
+ */
+void MFRC522NtagSession::Begin(const MFRC522::Uid *uid ///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+)
+{
+	_tamanhoUid = uid->size;
+	memcpy(_uid, uid->uidByte, uid->size);
+	_autenticado = false;
+	_semFastRead = false;
+} // Fim Begin()
+
+/**
+ * Autentica o PICC com PWD_AUTH, se ainda não foi autenticado nesta seleção, e verifica o PACK.
+ * Um UID diferente do passado a Begin() é tratado como uma nova seleção.
+ *
+ * Senha recusada: STATUS_MIFARE_NACK; o PICC volta ao estado IDLE e precisa ser selecionado novamente.
+ * PACK diferente do esperado: STATUS_INVALID e a sessão não é aberta.
+ * Limite de tentativas atingido para o UID: STATUS_INVALID, sem comunicação com o PICC.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NtagSession::Authenticate(MFRC522::Uid *uid,		///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+													 const byte *password, ///< Senha de 4 bytes.
+													 const byte *pack	   ///< PACK esperado, 2 bytes, ou nullptr para não verificar.
+)
+{
+	if (!IsCurrent(uid))
+	{
+		Begin(uid);
+	}
+	else if (_autenticado)
+	{
+		return MFRC522::STATUS_OK;
+	}
+
+	if (_limiteTentativas && GetFailedAttempts() >= _limiteTentativas)
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+
+	return SendPassword(password, pack);
+} // Fim Authenticate()
+
+/**
+ * Lê um intervalo de páginas com MIFARE_Ultralight_FastRead() dentro da sessão.
+ * Se o PICC recusar FAST_READ, ele é selecionado e autenticado de novo e a leitura segue com MIFARE_Read().
+ * Em caso de erro o PICC deixa o estado AUTHENTICATED e a sessão é encerrada.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NtagSession::Read(byte startPage,	  ///< Primeira página.
+											 byte endPage,		  ///< Última página, inclusive.
+											 byte *buffer,		  ///< Buffer para as páginas.
+											 uint16_t *bufferSize ///< Tamanho do buffer. Também é o número de bytes retornados se STATUS_OK.
+)
+{
+	MFRC522::StatusCode resultado;
+	if (!_semFastRead)
+	{
+		resultado = _leitor.MIFARE_Ultralight_FastRead(startPage, endPage, buffer, bufferSize);
+		if (resultado != MFRC522::STATUS_MIFARE_NACK)
+		{
+			if (resultado != MFRC522::STATUS_OK)
+			{
+				Invalidate();
+			}
+			return resultado;
+		}
+
+		// FAST_READ recusado: o PICC voltou ao estado IDLE. Seleciona e autentica de novo e segue com READ.
+		_semFastRead = true;
+		Invalidate();
+		resultado = Reauthenticate();
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+	}
+
+	resultado = ReadPages(startPage, endPage, buffer, bufferSize);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		Invalidate();
+	}
+	return resultado;
+} // Fim Read()
+
+/**
+ * Escreve páginas consecutivas com MIFARE_Ultralight_WritePages() dentro da sessão.
+ * Em caso de erro o PICC deixa o estado AUTHENTICATED e a sessão é encerrada.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NtagSession::Write(byte startPage,		  ///< Primeira página.
+											  const byte *data,		  ///< Dados, um múltiplo de 4 bytes.
+											  uint16_t length,		  ///< Tamanho dos dados.
+											  uint16_t *pagesWritten ///< Se não for nullptr, recebe o número de páginas escritas.
+)
+{
+	MFRC522::StatusCode resultado = _leitor.MIFARE_Ultralight_WritePages(startPage, data, length, pagesWritten);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		Invalidate();
+	}
+	return resultado;
+} // Fim Write()
+
+/**
+ * Esquece a autenticação, por exemplo depois de um comando enviado sem passar pela sessão que recebeu um NAK.
+ * O contador de senhas recusadas do UID é mantido.
+ */
+void MFRC522NtagSession::Invalidate()
+{
+	_autenticado = false;
+} // Fim Invalidate()
+
+/**
+ * Encerra a sessão e envia HALT ao PICC.
+ */
+void MFRC522NtagSession::End()
+{
+	_leitor.PICC_HaltA();
+	Invalidate();
+} // Fim End()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de suporte
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @return true se o UID é o do PICC da sessão.
+ */
+bool MFRC522NtagSession::IsCurrent(const MFRC522::Uid *uid) const
+{
+	return _tamanhoUid == uid->size && memcmp(_uid, uid->uidByte, uid->size) == 0;
+} // Fim IsCurrent()
+
+/**
+ * Envia PWD_AUTH ao PICC da sessão, conta a senha se for recusada e verifica o PACK.
+ * A senha e o PACK aceitos são guardados para Reauthenticate().
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NtagSession::SendPassword(const byte *password, const byte *pack)
+{
+	byte packRecebido[2];
+	MFRC522::StatusCode resultado = _leitor.PCD_NTAG216_AUTH(password, packRecebido);
+	if (resultado == MFRC522::STATUS_MIFARE_NACK)
+	{
+		CountFailure();
+		return resultado;
+	}
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+
+	// O PICC aceitou a senha e zerou seu contador de falhas.
+	EntradaCache *entrada = Find(_uid, _tamanhoUid);
+	if (entrada)
+	{
+		entrada->tamanhoUid = 0;
+	}
+	if (pack && (packRecebido[0] != pack[0] || packRecebido[1] != pack[1]))
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+	memcpy(_senha, password, sizeof(_senha));
+	memcpy(_pack, packRecebido, sizeof(_pack));
+	_autenticado = true;
+	return MFRC522::STATUS_OK;
+} // Fim SendPassword()
+
+/**
+ * Seleciona de novo o PICC da sessão (WUPA e SELECT com o UID conhecido) e repete a autenticação com a senha
+ * já aceita, exigindo o mesmo PACK.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NtagSession::Reauthenticate()
+{
+	MFRC522::Uid uid;
+	byte atqa[2];
+	byte tamanho = sizeof(atqa);
+
+	uid.size = _tamanhoUid;
+	memcpy(uid.uidByte, _uid, _tamanhoUid);
+	MFRC522::StatusCode resultado = _leitor.PICC_WakeupA(atqa, &tamanho);
+	if (resultado == MFRC522::STATUS_OK)
+	{
+		resultado = _leitor.PICC_Select(&uid, uid.size * 8);
+	}
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	byte pack[2];
+	memcpy(pack, _pack, sizeof(pack));
+	return SendPassword(_senha, pack);
+} // Fim Reauthenticate()
+
+/**
+ * Lê um intervalo de páginas com MIFARE_Read(), 4 páginas por comando, para PICCs que recusam FAST_READ.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522NtagSession::ReadPages(byte startPage, byte endPage, byte *buffer, uint16_t *bufferSize)
+{
+	if (endPage < startPage)
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+	const uint16_t total = ((uint16_t)endPage - startPage + 1) * 4;
+	if (buffer == nullptr || *bufferSize < total)
+	{
+		return MFRC522::STATUS_NO_ROOM;
+	}
+
+	byte bloco[18];
+	for (uint16_t deslocamento = 0; deslocamento < total; deslocamento += 16)
+	{
+		byte tamanho = sizeof(bloco);
+		MFRC522::StatusCode resultado = _leitor.MIFARE_Read((byte)(startPage + deslocamento / 4), bloco, &tamanho);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+		uint16_t restante = total - deslocamento;
+		memcpy(&buffer[deslocamento], bloco, restante < 16 ? restante : 16);
+	}
+	*bufferSize = total;
+	return MFRC522::STATUS_OK;
+} // Fim ReadPages()
+
+/**
+ * @return Senhas recusadas desde a última autenticação bem-sucedida do PICC da sessão.
+ */
+byte MFRC522NtagSession::GetFailedAttempts() const
+{
+	for (byte i = 0; i < CACHE_SIZE; i++)
+	{
+		if (_tamanhoUid && _cache[i].tamanhoUid == _tamanhoUid && memcmp(_cache[i].uid, _uid, _tamanhoUid) == 0)
+		{
+			return _cache[i].falhas;
+		}
+	}
+	return 0;
+} // Fim GetFailedAttempts()
+
+/**
+ * Procura o UID na cache.
+ *
+ * @return A entrada do UID, ou nullptr.
+ */
+MFRC522NtagSession::EntradaCache *MFRC522NtagSession::Find(const byte *uid, byte uidSize)
+{
+	for (byte i = 0; i < CACHE_SIZE; i++)
+	{
+		if (_cache[i].tamanhoUid == uidSize && memcmp(_cache[i].uid, uid, uidSize) == 0)
+		{
+			return &_cache[i];
+		}
+	}
+	return nullptr;
+} // Fim Find()
+
+/**
+ * Conta uma senha recusada para o PICC da sessão. Um UID novo ocupa uma entrada livre; com a cache cheia,
+ * substitui a entrada mais antiga, de modo que a contagem de um UID nunca é zerada por causa de outro PICC
+ * enquanto houver até CACHE_SIZE UIDs com senhas recusadas.
+ */
+void MFRC522NtagSession::CountFailure()
+{
+	EntradaCache *entrada = Find(_uid, _tamanhoUid);
+	if (entrada == nullptr)
+	{
+		for (byte i = 0; i < CACHE_SIZE && entrada == nullptr; i++)
+		{
+			if (_cache[i].tamanhoUid == 0)
+			{
+				entrada = &_cache[i];
+			}
+		}
+		if (entrada == nullptr)
+		{
+			entrada = &_cache[_proximaEntrada];
+			_proximaEntrada = (_proximaEntrada + 1) % CACHE_SIZE;
+		}
+		entrada->tamanhoUid = _tamanhoUid;
+		memcpy(entrada->uid, _uid, _tamanhoUid);
+		entrada->falhas = 0;
+	}
+	if (entrada->falhas < 0xFF)
+	{
+		entrada->falhas++;
+	}
+} // Fim CountFailure()
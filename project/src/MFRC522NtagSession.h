@@ -0,0 +1,80 @@
+/**
+ * Sessão autenticada com PWD_AUTH em PICCs NTAG213/215/216 e MIFARE Ultralight EV1.
+ *
+ * A autenticação com senha vale até o PICC sair do estado AUTHENTICATED: HALT, perda do campo ou qualquer
+ * comando respondido com NAK. Begin() deve ser chamado após cada seleção do PICC (PICC_Select() ou
+ * PICC_ReadCardSerial()), mesmo que o UID seja o mesmo: ele encerra a autenticação da seleção anterior.
+ * Authenticate() envia PWD_AUTH apenas uma vez por seleção, verifica o PACK retornado (um PICC que responde
+ * outro PACK não é o que recebeu a senha) e conta as senhas recusadas por UID, para não esgotar o limite
+ * AUTHLIM configurado no PICC, que o bloquearia para sempre. As contagens de até CACHE_SIZE UIDs são
+ * mantidas enquanto outros PICCs são usados e só são zeradas quando o PICC aceita a senha.
+ * Read() e Write() executam FAST_READ e WRITE em lote dentro da sessão e a encerram em caso de erro.
+ * Se o PICC recusar FAST_READ com NAK, Read() seleciona e autentica o PICC de novo (com a senha já aceita) e
+ * passa a usar READ, 4 páginas por comando, até a próxima seleção.
+ *
+ * Ex.: uma autenticação por passagem do cartão
+ *   MFRC522NtagSession sessao(mfrc522, 3);
+ *   sessao.Begin(&mfrc522.uid); // Após PICC_ReadCardSerial()
+ *   if (sessao.Authenticate(&mfrc522.uid, senha, pack) == MFRC522::STATUS_OK) {
+ *     sessao.Read(4, 0x27, buffer, &tamanho);
+ *     sessao.Write(0x10, dados, sizeof(dados));
+ *   }
+ *   sessao.End();
+ */
+#ifndef MFRC522NtagSession_h
+#define MFRC522NtagSession_h
+
+#include <Arduino.h>
+#include "MFRC522.h"
+
+class MFRC522NtagSession
+{
+public:
+	// Número de UIDs com a contagem de senhas recusadas guardada
+	static constexpr byte CACHE_SIZE = 4;
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Construtores
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522NtagSession(MFRC522 &leitor, byte attemptLimit = 0);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções da sessão
+	/////////////////////////////////////////////////////////////////////////////////////
+	void Begin(const MFRC522::Uid *uid);
+	MFRC522::StatusCode Authenticate(MFRC522::Uid *uid, const byte *password, const byte *pack);
+	MFRC522::StatusCode Read(byte startPage, byte endPage, byte *buffer, uint16_t *bufferSize);
+	MFRC522::StatusCode Write(byte startPage, const byte *data, uint16_t length, uint16_t *pagesWritten = nullptr);
+	void Invalidate();
+	void End();
+	bool IsAuthenticated() const { return _autenticado; };
+	byte GetFailedAttempts() const;
+
+protected:
+	typedef struct
+	{
+		byte tamanhoUid; // 0 se a entrada estiver livre
+		byte uid[10];
+		byte falhas;	 // Senhas recusadas desde a última autenticação bem-sucedida do UID
+	} EntradaCache;
+
+	MFRC522 &_leitor;
+	byte _limiteTentativas; // Senhas recusadas aceitas por UID antes de recusar novas tentativas; 0 = sem limite
+	bool _autenticado;		// PWD_AUTH aceito na seleção atual
+	bool _semFastRead;		// O PICC da seleção atual recusou FAST_READ: Read() usa READ
+	byte _senha[4];			// Senha e PACK aceitos, para autenticar de novo depois de um NAK do FAST_READ
+	byte _pack[2];
+	byte _tamanhoUid;		// UID da seleção atual; 0 se nenhum PICC foi selecionado
+	byte _uid[10];
+	EntradaCache _cache[CACHE_SIZE];
+	byte _proximaEntrada; // Próxima entrada a substituir (circular)
+
+	bool IsCurrent(const MFRC522::Uid *uid) const;
+	EntradaCache *Find(const byte *uid, byte uidSize);
+	void CountFailure();
+	MFRC522::StatusCode SendPassword(const byte *password, const byte *pack);
+	MFRC522::StatusCode Reauthenticate();
+	MFRC522::StatusCode ReadPages(byte startPage, byte endPage, byte *buffer, uint16_t *bufferSize);
+};
+
+#endif
@@ -0,0 +1,277 @@
+/*
+ * MFRC522Purse.cpp - Carteira com backup sobre Blocos de Valor do MIFARE Classic.
+ * NOTA: Por favor, verifique também os comentários em MFRC522Purse.h
+ * Liberado para o domínio público.
+ */
+
+#include "MFRC522Purse.h"
+#include "MFRC522Layout.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Construtores
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Construtor.
+ * Os dois blocos precisam estar no mesmo setor, para que uma única autenticação cubra a transação.
+ */
+MFRC522Purse::MFRC522Purse(MFRC522 &leitor, ///< Instância MFRC522 usada para a comunicação.
+						   byte blocoValor, ///< Bloco de Valor com o saldo.
+						   byte blocoBackup ///< Bloco de Valor com a cópia de segurança do saldo.
+						   )
+	: _leitor(leitor)
+{
+	_blocoValor = blocoValor;
+	_blocoBackup = blocoBackup;
+	_saldo = 0;
+	_saldoBackup = 0;
+	_pronto = false;
+	_permissoes = 0xFF;
+} // Fim do construtor
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções da carteira
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Autentica o setor da carteira, lê o saldo e o backup e valida o formato dos dois blocos no MCU.
+ *
+ * Se o Bloco de Valor estiver corrompido (cartão removido durante uma transação), ele é reconstruído
+ * a partir do backup; se o backup estiver corrompido, ele é reconstruído a partir do Bloco de Valor.
+ *
+ * Lembre-se de chamar PICC_HaltA() e PCD_StopCrypto1() ao terminar a comunicação com o PICC.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_CRC_WRONG se nenhum dos blocos for um Bloco de Valor, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Purse::Begin(MFRC522::Uid *uid,		  ///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+										byte authCommand,		  ///< PICC_CMD_MF_AUTH_KEY_A ou PICC_CMD_MF_AUTH_KEY_B
+										MFRC522::MIFARE_Key *key  ///< Chave do setor da carteira.
+)
+{
+	MFRC522::StatusCode resultado;
+	byte buffer[18];
+	byte tamanho;
+	bool valorValido;
+	bool backupValido;
+
+	_pronto = false;
+
+	// Verificação de sanidade
+	if (_blocoValor == _blocoBackup || MifareClassicGeometry::SectorStart(_blocoValor) != MifareClassicGeometry::SectorStart(_blocoBackup))
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+
+	resultado = _leitor.PCD_Authenticate(authCommand, _blocoValor, key, uid);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+
+	tamanho = sizeof(buffer);
+	resultado = _leitor.MIFARE_Read(_blocoValor, buffer, &tamanho);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	valorValido = MFRC522::MIFARE_DecodeValueBlock(buffer, &_saldo);
+
+	tamanho = sizeof(buffer);
+	resultado = _leitor.MIFARE_Read(_blocoBackup, buffer, &tamanho);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	backupValido = MFRC522::MIFARE_DecodeValueBlock(buffer, &_saldoBackup);
+
+	// Os bits de acesso sempre podem ser lidos com a Chave A. Com eles, uma operação que o setor não
+	// permite é recusada no MCU, em vez de terminar em NAK no meio da transação.
+	_permissoes = 0xFF;
+	if (authCommand == MFRC522::PICC_CMD_MF_AUTH_KEY_A)
+	{
+		byte g[4];
+		tamanho = sizeof(buffer);
+		resultado = _leitor.MIFARE_Read(MifareClassicGeometry::TrailerBlock(MifareClassicGeometry::SectorOf(_blocoValor)), buffer, &tamanho);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+		if (MFRC522::MIFARE_GetAccessBits(&buffer[6], g))
+		{
+			_permissoes = 0;
+			for (byte op = MifareClassicGeometry::ACCESS_READ; op <= MifareClassicGeometry::ACCESS_DECREMENT; op++)
+			{
+				if (MifareClassicGeometry::BlockAllows(g, _blocoValor, (MifareClassicGeometry::DataOperation)op, false) &&
+					MifareClassicGeometry::BlockAllows(g, _blocoBackup, (MifareClassicGeometry::DataOperation)op, false))
+				{
+					_permissoes |= 1 << op;
+				}
+			}
+		}
+	}
+
+	if (!valorValido && !backupValido)
+	{
+		return MFRC522::STATUS_CRC_WRONG;
+	}
+	_pronto = true;
+
+	// Reparo: a transação interrompida não é aplicada, o saldo volta ao valor do backup.
+	if (!valorValido)
+	{
+		return Move(_blocoBackup, _blocoValor);
+	}
+	if (!backupValido)
+	{
+		return Move(_blocoValor, _blocoBackup);
+	}
+	return MFRC522::STATUS_OK;
+} // Fim Begin()
+
+/**
+ * Debita um valor do saldo. O saldo anterior é guardado no backup antes da alteração.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_INVALID se o saldo for insuficiente ou o setor não permitir o débito, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Purse::Debit(int32_t amount ///< Valor a debitar, maior que zero.
+)
+{
+	if (amount <= 0 || amount > _saldo || !Allows(MifareClassicGeometry::ACCESS_DECREMENT))
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+	return Change(MFRC522::PICC_CMD_MF_DECREMENT, amount);
+} // Fim Debit()
+
+/**
+ * Credita um valor no saldo. O saldo anterior é guardado no backup antes da alteração.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_INVALID se o saldo ultrapassar o limite de int32_t ou o setor não permitir o crédito, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Purse::Credit(int32_t amount ///< Valor a creditar, maior que zero.
+)
+{
+	if (amount <= 0 || _saldo > INT32_MAX - amount || !Allows(MifareClassicGeometry::ACCESS_INCREMENT) || !Allows(MifareClassicGeometry::ACCESS_DECREMENT))
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+	return Change(MFRC522::PICC_CMD_MF_INCREMENT, amount);
+} // Fim Credit()
+
+/**
+ * Copia um Bloco de Valor para outro bloco do mesmo setor com MIFARE_Restore() e MIFARE_Transfer(),
+ * sem passar os dados pelo MCU.
+ *
+ * Ex.: Move(blocoBackup, blocoValor) desfaz a última operação.
+ * O saldo local é atualizado quando os blocos envolvidos são o Bloco de Valor e o backup.
+ * Se o destino for o Bloco de Valor e a origem for outro bloco, chame Begin() novamente para ler o saldo.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Purse::Move(byte fromBlock, ///< Bloco de Valor de origem.
+									   byte toBlock	   ///< Bloco de destino, no mesmo setor.
+)
+{
+	if (!_pronto || !Allows(MifareClassicGeometry::ACCESS_DECREMENT) || MifareClassicGeometry::SectorStart(fromBlock) != MifareClassicGeometry::SectorStart(_blocoValor) || MifareClassicGeometry::SectorStart(toBlock) != MifareClassicGeometry::SectorStart(_blocoValor))
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+	MFRC522::StatusCode resultado = CopyValue(fromBlock, toBlock);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		_pronto = false;
+		return resultado;
+	}
+
+	if (toBlock == _blocoValor)
+	{
+		if (fromBlock == _blocoBackup)
+		{
+			_saldo = _saldoBackup;
+		}
+		else if (fromBlock != _blocoValor)
+		{
+			_pronto = false;
+		}
+	}
+	else if (toBlock == _blocoBackup)
+	{
+		if (fromBlock == _blocoValor)
+		{
+			_saldoBackup = _saldo;
+		}
+		else if (fromBlock != _blocoBackup)
+		{
+			_pronto = false;
+		}
+	}
+	return MFRC522::STATUS_OK;
+} // Fim Move()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de suporte
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Copia o Bloco de Valor de origem para o bloco de destino: MIFARE_Restore() + MIFARE_Transfer().
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Purse::CopyValue(byte fromBlock, byte toBlock)
+{
+	MFRC522::StatusCode resultado = _leitor.MIFARE_Restore(fromBlock);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	return _leitor.MIFARE_Transfer(toBlock);
+} // Fim CopyValue()
+
+/**
+ * Executa uma transação: atualiza o backup com o saldo atual e então aplica o decremento ou incremento.
+ * Falhas deixam a carteira fora do estado pronto; chame Begin() novamente, que também faz o reparo.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Purse::Change(byte command, int32_t amount)
+{
+	MFRC522::StatusCode resultado;
+
+	if (!_pronto)
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+
+	// Passo 1: backup = valor. Se o backup já contém o saldo atual, a cópia é desnecessária.
+	if (_saldoBackup != _saldo)
+	{
+		resultado = Move(_blocoValor, _blocoBackup);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+	}
+
+	// Passo 2: valor = valor -/+ quantia
+	if (command == MFRC522::PICC_CMD_MF_DECREMENT)
+	{
+		resultado = _leitor.MIFARE_Decrement(_blocoValor, amount);
+	}
+	else
+	{
+		resultado = _leitor.MIFARE_Increment(_blocoValor, amount);
+	}
+	if (resultado == MFRC522::STATUS_OK)
+	{
+		resultado = _leitor.MIFARE_Transfer(_blocoValor);
+	}
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		_pronto = false;
+		return resultado;
+	}
+
+	// O PICC confirmou a transferência: atualiza o saldo local sem ler o bloco novamente.
+	_saldo = (command == MFRC522::PICC_CMD_MF_DECREMENT) ? _saldo - amount : _saldo + amount;
+	return MFRC522::STATUS_OK;
+} // Fim Change()
@@ -0,0 +1,56 @@
+/**
+ * Carteira (purse) sobre Blocos de Valor do MIFARE Classic.
+ *
+ * O saldo fica em um Bloco de Valor e uma cópia de segurança (backup) fica em outro Bloco de Valor
+ * do mesmo setor. Antes de cada operação o valor atual é copiado para o backup com
+ * MIFARE_Restore()/MIFARE_Transfer(); em seguida o valor é alterado com MIFARE_Decrement() ou
+ * MIFARE_Increment() e MIFARE_Transfer(). Se o cartão for removido durante a operação, Begin()
+ * detecta um Bloco de Valor corrompido e o reconstrói a partir do backup.
+ *
+ * Begin() lê os dois blocos uma única vez e valida o formato no MCU. Depois disso o saldo é mantido
+ * localmente: as operações não fazem uma nova leitura com MIFARE_GetValue(), pois MIFARE_Transfer()
+ * só retorna STATUS_OK depois que o PICC confirmou a escrita.
+ *
+ * Os dois blocos precisam estar formatados como Blocos de Valor (veja MIFARE_SetValue()) e o
+ * setor precisa permitir leitura, decremento, incremento e transferência com a chave usada.
+ * Com a Chave A, Begin() também lê os bits de acesso e as operações não permitidas são recusadas no MCU.
+ */
+#ifndef MFRC522Purse_h
+#define MFRC522Purse_h
+
+#include <Arduino.h>
+#include "MFRC522.h"
+
+class MFRC522Purse
+{
+public:
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Construtores
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522Purse(MFRC522 &leitor, byte blocoValor, byte blocoBackup);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções da carteira
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522::StatusCode Begin(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key);
+	MFRC522::StatusCode Debit(int32_t amount);
+	MFRC522::StatusCode Credit(int32_t amount);
+	MFRC522::StatusCode Move(byte fromBlock, byte toBlock);
+	int32_t GetBalance() const { return _saldo; };
+	bool IsReady() const { return _pronto; };
+
+protected:
+	MFRC522 &_leitor;
+	byte _blocoValor;
+	byte _blocoBackup;
+	int32_t _saldo;		  // Valor atual do Bloco de Valor
+	int32_t _saldoBackup; // Valor atual do bloco de backup
+	bool _pronto;		  // true depois de um Begin() bem-sucedido
+	byte _permissoes;	  // Bit (1 << MifareClassicGeometry::DataOperation) para operações permitidas nos dois blocos
+
+	MFRC522::StatusCode CopyValue(byte fromBlock, byte toBlock);
+	MFRC522::StatusCode Change(byte command, int32_t amount);
+	bool Allows(byte operation) const { return _permissoes & (1 << operation); };
+};
+
+#endif
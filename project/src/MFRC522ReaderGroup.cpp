@@ -0,0 +1,149 @@
+/*
+ * MFRC522ReaderGroup.cpp - Varredura de vários leitores MFRC522 com as esperas de RF sobrepostas.
+ * NOTA: Por favor, verifique também os comentários em MFRC522ReaderGroup.h
+ * Liberado para o domínio público.
+ */
+
+#include "MFRC522ReaderGroup.h"
+
+// ComIEnReg: IRqInv (IRQ ativo em nível baixo), RxIEn, IdleIEn e TimerIEn, os bits que encerram o REQA
+static constexpr byte IRQ_REQA = 0xB1;
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Construtores
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Construtor.
+ */
+MFRC522ReaderGroup::MFRC522ReaderGroup(MFRC522 *leitores, ///< Matriz de leitores já inicializados com PCD_Init().
+									   byte quantidade	  ///< Número de leitores na matriz, no máximo MAX_READERS.
+									   )
+	: _leitores(leitores), _quantidade(quantidade > MAX_READERS ? MAX_READERS : quantidade)
+{
+	for (byte i = 0; i < MAX_READERS; i++)
+	{
+		_pinoIrq[i] = NO_IRQ_PIN;
+		_status[i] = MFRC522::STATUS_TIMEOUT;
+	}
+	_pendentes = 0;
+	_presentes = 0;
+	_prazo = 0;
+} // Fim do construtor
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de configuração
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Associa o pino IRQ de um leitor e o configura para sinalizar o fim do REQA.
+ * Deve ser chamado após PCD_Init(), que restaura ComIEnReg.
+ */
+void MFRC522ReaderGroup::SetIrqPin(byte reader, ///< Índice do leitor na matriz.
+								   byte pin		///< Pino do Arduino ligado ao IRQ do MFRC522, ou NO_IRQ_PIN.
+)
+{
+	if (reader >= _quantidade)
+	{
+		return;
+	}
+	_pinoIrq[reader] = pin;
+	if (pin != NO_IRQ_PIN)
+	{
+		pinMode(pin, INPUT_PULLUP); // O IRQ é dreno aberto por padrão (DivIEnReg.IRQPushPull = 0)
+		_leitores[reader].PCD_WriteRegister(MFRC522::ComIEnReg, IRQ_REQA);
+	}
+} // Fim SetIrqPin()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de varredura
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Procura novos cartões em todos os leitores, como PICC_IsNewCardPresent() em cada um, mas com as esperas
+ * de RF sobrepostas.
+ *
+ * @return Máscara dos leitores com um cartão presente (bit i para o leitor i).
+ */
+byte MFRC522ReaderGroup::Scan()
+{
+	StartScan();
+	while (!PollScan())
+	{
+		yield();
+	}
+	return _presentes;
+} // Fim Scan()
+
+/**
+ * Inicia o REQA em todos os leitores e retorna sem esperar. Conclua com PollScan().
+ */
+void MFRC522ReaderGroup::StartScan()
+{
+	uint32_t maiorTimeoutUs = 0;
+
+	_pendentes = 0;
+	_presentes = 0;
+	for (byte i = 0; i < _quantidade; i++)
+	{
+		MFRC522 &leitor = _leitores[i];
+
+		leitor.PICC_StartRequestA();
+		_status[i] = MFRC522::STATUS_PENDING;
+		_pendentes |= (1 << i);
+		if (leitor.PCD_GetTimeout() > maiorTimeoutUs)
+		{
+			maiorTimeoutUs = leitor.PCD_GetTimeout();
+		}
+	}
+	// Mesma margem de PCD_StartCommand(): depois dela o SPI é consultado mesmo com o IRQ em repouso
+	_prazo = millis() + (maiorTimeoutUs / 1000) + 11;
+} // Fim StartScan()
+
+/**
+ * Faz uma varredura de polling pelos leitores com o REQA em andamento.
+ * Leitores com pino IRQ em repouso são pulados sem acessar o SPI.
+ *
+ * @return true quando todos os leitores terminaram; o resultado está em GetPresent() e GetStatus().
+ */
+bool MFRC522ReaderGroup::PollScan()
+{
+	bool prazoPassou = static_cast<uint32_t>(millis()) >= _prazo;
+
+	for (byte i = 0; i < _quantidade; i++)
+	{
+		if (!(_pendentes & (1 << i)))
+		{
+			continue;
+		}
+		if (_pinoIrq[i] != NO_IRQ_PIN && digitalRead(_pinoIrq[i]) == HIGH && !prazoPassou)
+		{
+			continue; // IRQ ainda não acionado
+		}
+		Harvest(i);
+	}
+	return _pendentes == 0;
+} // Fim PollScan()
+
+/**
+ * Verifica se o REQA de um leitor terminou e registra o resultado.
+ */
+void MFRC522ReaderGroup::Harvest(byte reader ///< Índice do leitor na matriz.
+)
+{
+	byte bufferATQA[2];
+	byte tamanhoBuffer = sizeof(bufferATQA);
+
+	MFRC522::StatusCode resultado = _leitores[reader].PICC_CheckRequestA(bufferATQA, &tamanhoBuffer);
+	if (resultado == MFRC522::STATUS_PENDING)
+	{
+		return;
+	}
+
+	_status[reader] = resultado;
+	_pendentes &= ~(1 << reader);
+	if (resultado == MFRC522::STATUS_OK || resultado == MFRC522::STATUS_COLLISION)
+	{
+		_presentes |= (1 << reader);
+	}
+} // Fim Harvest()
@@ -0,0 +1,68 @@
+/**
+ * Varredura de vários leitores MFRC522 no mesmo barramento SPI com as esperas de RF sobrepostas.
+ *
+ * Chamar PICC_IsNewCardPresent() em cada leitor, um após o outro, deixa o microcontrolador parado durante
+ * toda a troca de RF de cada chip; um leitor vazio gasta o timeout inteiro (25 ms por padrão), então a
+ * varredura leva a soma dos tempos de todos os leitores. Cada MFRC522 conduz a troca de RF sozinho:
+ * Scan() inicia o REQA em todos os leitores com PICC_StartRequestA() e depois colhe as conclusões com
+ * PICC_CheckRequestA() em varreduras de polling, de modo que a varredura leva o tempo do leitor mais lento.
+ *
+ * Com SetIrqPin() o pino IRQ do leitor é consultado antes do SPI: enquanto ele não for acionado o leitor
+ * não é lido, o que deixa o barramento livre para os outros.
+ *
+ * Os leitores com cartão ficam no estado READY, prontos para PICC_ReadCardSerial().
+ *
+ * Ex.:
+ *   MFRC522 mfrc522[NR_OF_READERS];
+ *   MFRC522ReaderGroup grupo(mfrc522, NR_OF_READERS);
+ *   byte presentes = grupo.Scan();
+ *   for (byte i = 0; i < NR_OF_READERS; i++) {
+ *     if ((presentes & (1 << i)) && mfrc522[i].PICC_ReadCardSerial()) { ... }
+ *   }
+ */
+#ifndef MFRC522ReaderGroup_h
+#define MFRC522ReaderGroup_h
+
+#include <Arduino.h>
+#include "MFRC522.h"
+
+class MFRC522ReaderGroup
+{
+public:
+	// Número máximo de leitores, um bit por leitor na máscara retornada por Scan()
+	static constexpr byte MAX_READERS = 8;
+	// Sem pino IRQ: o leitor é consultado pelo SPI
+	static constexpr byte NO_IRQ_PIN = 0xFF;
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Construtores
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522ReaderGroup(MFRC522 *leitores, byte quantidade);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções de configuração
+	/////////////////////////////////////////////////////////////////////////////////////
+	void SetIrqPin(byte reader, byte pin);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções de varredura
+	/////////////////////////////////////////////////////////////////////////////////////
+	byte Scan();
+	void StartScan();
+	bool PollScan();
+	byte GetPresent() const { return _presentes; };
+	MFRC522::StatusCode GetStatus(byte reader) const { return reader < _quantidade ? _status[reader] : MFRC522::STATUS_INVALID; };
+
+protected:
+	MFRC522 *_leitores;
+	byte _quantidade;
+	byte _pinoIrq[MAX_READERS];
+	MFRC522::StatusCode _status[MAX_READERS]; // STATUS_PENDING enquanto o REQA estiver em andamento
+	byte _pendentes;						   // Máscara dos leitores com o REQA em andamento
+	byte _presentes;						   // Máscara dos leitores que receberam um ATQA
+	uint32_t _prazo;						   // millis() após o qual os pinos IRQ não são mais considerados
+
+	void Harvest(byte reader);
+};
+
+#endif
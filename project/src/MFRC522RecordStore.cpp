@@ -0,0 +1,593 @@
+/*
+ * MFRC522RecordStore.cpp - Registros com versão e cópia sombra sobre MIFARE_Write().
+ * NOTA: Por favor, verifique também os comentários em MFRC522RecordStore.h
+ * Liberado para o domínio público.
+ */
+
+#include "MFRC522RecordStore.h"
+#include "MFRC522Layout.h"
+
+// Formato do bloco de diretório (16 bytes):
+//  0..1   Assinatura 'R' 'S'
+//  2      Cópia ativa (0 = A, 1 = B)
+//  3      CRC-16 do diretório, LSB
+//  4..9   Entrada da cópia A: versão (2 bytes, LSB primeiro), tamanho, CRC-16 do diretório (MSB), CRC-16 da cópia (2 bytes, LSB primeiro)
+// 10..15  Entrada da cópia B: versão, tamanho, reservado (0x00), CRC-16 da cópia
+// O CRC-16 do diretório é calculado sobre os 16 bytes com os bytes 3 e 7 em zero.
+static constexpr byte ASSINATURA_0 = 'R';
+static constexpr byte ASSINATURA_1 = 'S';
+
+// Valor de *ativa retornado por ReadDirectory() quando o bloco não tem a assinatura (diretório ainda não formatado)
+static constexpr byte DIRETORIO_VAZIO = 0xFF;
+// Valor inicial de *ativa em Recover(): diretório com a assinatura, mas sem cópia ativa confiável
+static constexpr byte ATIVA_DESCONHECIDA = 0xFE;
+// Posições do CRC-16 do diretório no bloco
+static constexpr byte CRC_DIRETORIO_LSB = 3;
+static constexpr byte CRC_DIRETORIO_MSB = 4 + 3;
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Construtores
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Construtor.
+ * Os blocos de cada cópia começam no bloco indicado e seguem em ordem crescente, pulando os trailers de setor.
+ */
+MFRC522RecordStore::MFRC522RecordStore(MFRC522 &leitor,		///< Instância MFRC522 usada para a comunicação.
+									   byte blocoDiretorio, ///< Bloco que recebe o diretório (a escrita de confirmação).
+									   byte inicioCopiaA,	///< Primeiro bloco da cópia A.
+									   byte inicioCopiaB,	///< Primeiro bloco da cópia B.
+									   byte blocosPorCopia	///< Número de blocos de dados por cópia, 1..MAX_BLOCKS_PER_COPY.
+									   )
+	: _leitor(leitor)
+{
+	_blocoDiretorio = blocoDiretorio;
+	_inicioCopia[0] = inicioCopiaA;
+	_inicioCopia[1] = inicioCopiaB;
+	_blocosPorCopia = blocosPorCopia > MAX_BLOCKS_PER_COPY ? MAX_BLOCKS_PER_COPY : blocosPorCopia;
+	_setorAutenticado = 0xFF;
+} // Fim do construtor
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de acesso ao registro
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Escreve um novo registro.
+ *
+ * Os dados vão para a cópia que não é a mais recente consistente (normalmente a inativa; a ativa se o CRC dela
+ * não conferir e a outra for a única consistente, a mesma que Read() usaria). Em seguida o diretório é reescrito
+ * com a versão da cópia ativa mais um (módulo 65536) e passa a apontar para essa cópia. Se o cartão for removido
+ * antes da escrita do diretório, a versão anterior continua válida.
+ *
+ * Apenas um bloco sem a assinatura é tratado como diretório não formatado. Um diretório com a assinatura mas
+ * inconsistente (CRC do diretório errado ou cópia ativa inválida) retorna STATUS_CRC_WRONG sem nenhuma escrita,
+ * para não sobrescrever uma cópia que ainda pode ser lida; use Recover() ou Format() para reconstruí-lo.
+ *
+ * Lembre-se de chamar PICC_HaltA() e PCD_StopCrypto1() ao terminar a comunicação com o PICC.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522RecordStore::Write(MFRC522::Uid *uid,			 ///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+											  byte authCommand,				 ///< PICC_CMD_MF_AUTH_KEY_A ou PICC_CMD_MF_AUTH_KEY_B
+											  MFRC522::MIFARE_Key *key,		 ///< Chave para o diretório e para as cópias.
+											  const byte *data,				 ///< Conteúdo do registro.
+											  byte length,					 ///< Tamanho do registro, no máximo GetCapacity().
+											  uint16_t *version				 ///< Se não for nullptr, recebe a versão gravada.
+)
+{
+	MFRC522::StatusCode resultado;
+	EntradaDiretorio entradas[2];
+	byte ativa;
+	byte buffer[18];
+
+	// Verificação de sanidade
+	if (data == nullptr || length > GetCapacity())
+	{
+		return MFRC522::STATUS_INVALID;
+	}
+
+	_setorAutenticado = 0xFF;
+	resultado = ReadDirectory(uid, authCommand, key, entradas, &ativa);
+	byte destino;
+	if (resultado == MFRC522::STATUS_CRC_WRONG && ativa == DIRETORIO_VAZIO)
+	{ // Diretório ainda não formatado: começa do zero na cópia A
+		memset(entradas, 0, sizeof(entradas));
+		ativa = 0;
+		destino = 0;
+	}
+	else if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	else
+	{
+		// Preserva a cópia mais recente consistente: a ativa, ou a outra se apenas ela for consistente.
+		destino = ativa ^ 1;
+		resultado = ReadCopy(uid, authCommand, key, ativa, &entradas[ativa], nullptr, nullptr);
+		if (resultado == MFRC522::STATUS_CRC_WRONG)
+		{
+			resultado = ReadCopy(uid, authCommand, key, destino, &entradas[destino], nullptr, nullptr);
+			if (resultado == MFRC522::STATUS_OK)
+			{
+				destino = ativa;
+			}
+			else if (resultado != MFRC522::STATUS_CRC_WRONG)
+			{
+				return resultado;
+			}
+		}
+		else if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+	}
+
+	// Passo 1: escreve os dados na cópia de destino, uma autenticação por setor.
+	for (byte i = 0; i < _blocosPorCopia; i++)
+	{
+		byte bloco = CopyBlock(destino, i);
+		resultado = AuthenticateSector(uid, authCommand, key, bloco);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+		memset(buffer, 0, 16);
+		if (i * 16 < length)
+		{
+			byte restante = length - i * 16;
+			memcpy(buffer, &data[i * 16], restante < 16 ? restante : 16);
+		}
+		resultado = _leitor.MIFARE_Write(bloco, buffer, 16);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+	}
+
+	// Passo 2: confirma com uma única escrita do bloco de diretório.
+	// A cópia ativa é sempre a última confirmada, então a nova versão é a dela mais um, mesmo depois de dar a volta.
+	entradas[destino].versao = entradas[ativa].versao + 1;
+	entradas[destino].tamanho = length;
+	entradas[destino].crc = Crc16(data, length);
+
+	resultado = WriteDirectory(uid, authCommand, key, entradas, destino);
+	if (resultado == MFRC522::STATUS_OK && version)
+	{
+		*version = entradas[destino].versao;
+	}
+	return resultado;
+} // Fim Write()
+
+/**
+ * Lê o registro mais recente e consistente.
+ *
+ * O diretório indica a cópia ativa; se o CRC dela não conferir, a outra cópia é usada,
+ * desde que seja consistente. Com diretório e cópias no mesmo setor, a leitura usa uma única autenticação.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_CRC_WRONG se nenhuma cópia for consistente, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522RecordStore::Read(MFRC522::Uid *uid,		   ///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+											 byte authCommand,		   ///< PICC_CMD_MF_AUTH_KEY_A ou PICC_CMD_MF_AUTH_KEY_B
+											 MFRC522::MIFARE_Key *key, ///< Chave para o diretório e para as cópias.
+											 byte *data,			   ///< Buffer para o registro, pelo menos GetCapacity() bytes.
+											 byte *length,			   ///< Recebe o tamanho do registro.
+											 uint16_t *version		   ///< Se não for nullptr, recebe a versão lida.
+)
+{
+	_setorAutenticado = 0xFF;
+	return ReadRecord(uid, authCommand, key, false, 0, data, length, version, nullptr);
+} // Fim Read()
+
+/**
+ * Lê o registro apenas se a versão ativa for diferente de uma versão já conhecida (por exemplo, em cache).
+ *
+ * Primeiro o diretório é lido (uma autenticação e uma leitura). Se a versão ativa for igual a knownVersion,
+ * *changed recebe false e data e length não são alterados. Caso contrário a leitura continua como em Read(),
+ * na mesma autenticação, e *changed recebe true.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_CRC_WRONG se nenhuma cópia for consistente, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522RecordStore::ReadIfChanged(MFRC522::Uid *uid,		///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+													  byte authCommand,			///< PICC_CMD_MF_AUTH_KEY_A ou PICC_CMD_MF_AUTH_KEY_B
+													  MFRC522::MIFARE_Key *key, ///< Chave para o diretório e para as cópias.
+													  uint16_t knownVersion,	///< Versão já conhecida pelo chamador.
+													  byte *data,				///< Buffer para o registro, pelo menos GetCapacity() bytes.
+													  byte *length,				///< Recebe o tamanho do registro, se ele mudou.
+													  uint16_t *version,		///< Se não for nullptr, recebe a versão do registro.
+													  bool *changed				///< Recebe true se o registro foi lido, false se a versão não mudou.
+)
+{
+	_setorAutenticado = 0xFF;
+	return ReadRecord(uid, authCommand, key, true, knownVersion, data, length, version, changed);
+} // Fim ReadIfChanged()
+
+/**
+ * Lê apenas a versão da cópia ativa, com uma autenticação e uma leitura.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522RecordStore::ReadVersion(MFRC522::Uid *uid,		  ///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+													byte authCommand,		  ///< PICC_CMD_MF_AUTH_KEY_A ou PICC_CMD_MF_AUTH_KEY_B
+													MFRC522::MIFARE_Key *key, ///< Chave para o diretório.
+													uint16_t *version		  ///< Recebe a versão da cópia ativa.
+)
+{
+	EntradaDiretorio entradas[2];
+	byte ativa;
+
+	_setorAutenticado = 0xFF;
+	MFRC522::StatusCode resultado = ReadDirectory(uid, authCommand, key, entradas, &ativa);
+	if (resultado == MFRC522::STATUS_OK)
+	{
+		*version = entradas[ativa].versao;
+	}
+	return resultado;
+} // Fim ReadVersion()
+
+/**
+ * Reconstrói um diretório com a assinatura mas inconsistente, que faz Write() e Read() retornarem
+ * STATUS_CRC_WRONG (por exemplo, um bit trocado no bloco ou um diretório gravado antes do CRC do diretório).
+ *
+ * As entradas gravadas no bloco são conferidas contra as duas cópias. A cópia ativa passa a ser a consistente;
+ * se as duas forem, vale a indicada no diretório ou, se ela for inválida, a de versão mais recente (comparação
+ * de número de série, que tolera a volta do contador). Um diretório já válido com a cópia ativa consistente
+ * não é reescrito.
+ *
+ * Lembre-se de chamar PICC_HaltA() e PCD_StopCrypto1() ao terminar a comunicação com o PICC.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_CRC_WRONG se o diretório não estiver formatado ou nenhuma cópia for consistente (veja Format()), STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522RecordStore::Recover(MFRC522::Uid *uid,			///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+												byte authCommand,			///< PICC_CMD_MF_AUTH_KEY_A ou PICC_CMD_MF_AUTH_KEY_B
+												MFRC522::MIFARE_Key *key,	///< Chave para o diretório e para as cópias.
+												uint16_t *version			///< Se não for nullptr, recebe a versão da cópia ativa.
+)
+{
+	EntradaDiretorio entradas[2];
+	byte ativa = ATIVA_DESCONHECIDA;
+
+	_setorAutenticado = 0xFF;
+	MFRC522::StatusCode resultado = ReadDirectory(uid, authCommand, key, entradas, &ativa);
+	bool diretorioValido = (resultado == MFRC522::STATUS_OK);
+	if (resultado == MFRC522::STATUS_CRC_WRONG && ativa == DIRETORIO_VAZIO)
+	{
+		return resultado;
+	}
+	if (resultado != MFRC522::STATUS_OK && resultado != MFRC522::STATUS_CRC_WRONG)
+	{
+		return resultado;
+	}
+
+	bool consistente[2];
+	for (byte c = 0; c < 2; c++)
+	{
+		resultado = ReadCopy(uid, authCommand, key, c, &entradas[c], nullptr, nullptr);
+		if (resultado != MFRC522::STATUS_OK && resultado != MFRC522::STATUS_CRC_WRONG)
+		{
+			return resultado;
+		}
+		consistente[c] = (resultado == MFRC522::STATUS_OK);
+	}
+
+	byte escolhida;
+	if (consistente[0] && consistente[1])
+	{
+		escolhida = (ativa <= 1) ? ativa : (IsNewer(entradas[1].versao, entradas[0].versao) ? 1 : 0);
+	}
+	else if (consistente[0] || consistente[1])
+	{
+		escolhida = consistente[0] ? 0 : 1;
+	}
+	else
+	{
+		return MFRC522::STATUS_CRC_WRONG;
+	}
+
+	if (!diretorioValido || escolhida != ativa)
+	{
+		resultado = WriteDirectory(uid, authCommand, key, entradas, escolhida);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+	}
+	if (version)
+	{
+		*version = entradas[escolhida].versao;
+	}
+	return MFRC522::STATUS_OK;
+} // Fim Recover()
+
+/**
+ * Grava um diretório vazio: as duas cópias com versão 0 e tamanho 0, cópia A ativa.
+ * O registro anterior é descartado; use quando Recover() não encontrar nenhuma cópia consistente.
+ * Caches da versão, como MFRC522CardCache, devem ser invalidadas para este UID.
+ *
+ * Lembre-se de chamar PICC_HaltA() e PCD_StopCrypto1() ao terminar a comunicação com o PICC.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522RecordStore::Format(MFRC522::Uid *uid,		  ///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+											   byte authCommand,		  ///< PICC_CMD_MF_AUTH_KEY_A ou PICC_CMD_MF_AUTH_KEY_B
+											   MFRC522::MIFARE_Key *key	  ///< Chave para o diretório.
+)
+{
+	EntradaDiretorio entradas[2];
+	for (byte c = 0; c < 2; c++)
+	{
+		entradas[c].versao = 0;
+		entradas[c].tamanho = 0;
+		entradas[c].crc = Crc16(nullptr, 0);
+	}
+	_setorAutenticado = 0xFF;
+	return WriteDirectory(uid, authCommand, key, entradas, 0);
+} // Fim Format()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de suporte
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Lê o diretório e o registro mais recente e consistente. Veja Read() e ReadIfChanged().
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_CRC_WRONG se nenhuma cópia for consistente, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522RecordStore::ReadRecord(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, bool compararVersao, uint16_t versaoConhecida,
+												   byte *data, byte *length, uint16_t *version, bool *changed)
+{
+	MFRC522::StatusCode resultado;
+	EntradaDiretorio entradas[2];
+	byte ativa;
+
+	resultado = ReadDirectory(uid, authCommand, key, entradas, &ativa);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	if (changed)
+	{
+		*changed = !(compararVersao && entradas[ativa].versao == versaoConhecida);
+		if (!*changed)
+		{
+			if (version)
+			{
+				*version = versaoConhecida;
+			}
+			return MFRC522::STATUS_OK;
+		}
+	}
+
+	// Tenta a cópia ativa e, se necessário, a anterior.
+	for (byte tentativa = 0; tentativa < 2; tentativa++)
+	{
+		byte copia = ativa ^ tentativa;
+		resultado = ReadCopy(uid, authCommand, key, copia, &entradas[copia], data, length);
+		if (resultado == MFRC522::STATUS_OK)
+		{
+			if (version)
+			{
+				*version = entradas[copia].versao;
+			}
+			return MFRC522::STATUS_OK;
+		}
+		if (resultado != MFRC522::STATUS_CRC_WRONG)
+		{
+			return resultado;
+		}
+	}
+	return MFRC522::STATUS_CRC_WRONG;
+} // Fim ReadRecord()
+
+/**
+ * Autentica o setor que contém o bloco, a menos que ele já seja o setor autenticado.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522RecordStore::AuthenticateSector(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, byte blockAddr)
+{
+	byte inicioSetor = MifareClassicGeometry::SectorStart(blockAddr);
+	if (inicioSetor == _setorAutenticado)
+	{
+		return MFRC522::STATUS_OK;
+	}
+	MFRC522::StatusCode resultado = _leitor.PCD_Authenticate(authCommand, blockAddr, key, uid);
+	_setorAutenticado = (resultado == MFRC522::STATUS_OK) ? inicioSetor : 0xFF;
+	return resultado;
+} // Fim AuthenticateSector()
+
+/**
+ * Lê e decodifica o bloco de diretório.
+ *
+ * Sem a assinatura, *ativa recebe DIRETORIO_VAZIO (diretório não formatado); com a assinatura mas com o CRC
+ * do diretório errado ou a cópia ativa inválida, *ativa não é alterado. Com a assinatura, as entradas são
+ * decodificadas mesmo que o diretório seja inválido, para Recover().
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_CRC_WRONG se o bloco não contém um diretório válido, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522RecordStore::ReadDirectory(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, EntradaDiretorio *entradas, byte *ativa)
+{
+	byte buffer[18];
+	byte tamanho = sizeof(buffer);
+
+	MFRC522::StatusCode resultado = AuthenticateSector(uid, authCommand, key, _blocoDiretorio);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	resultado = _leitor.MIFARE_Read(_blocoDiretorio, buffer, &tamanho);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+
+	if (buffer[0] != ASSINATURA_0 || buffer[1] != ASSINATURA_1)
+	{
+		*ativa = DIRETORIO_VAZIO;
+		return MFRC522::STATUS_CRC_WRONG;
+	}
+	for (byte c = 0; c < 2; c++)
+	{
+		const byte *e = &buffer[4 + 6 * c];
+		entradas[c].versao = (uint16_t)e[0] | ((uint16_t)e[1] << 8);
+		entradas[c].tamanho = e[2];
+		entradas[c].crc = (uint16_t)e[4] | ((uint16_t)e[5] << 8);
+	}
+	uint16_t crcDiretorio = (uint16_t)buffer[CRC_DIRETORIO_LSB] | ((uint16_t)buffer[CRC_DIRETORIO_MSB] << 8);
+	if (crcDiretorio != DirectoryCrc(buffer) || buffer[2] > 1)
+	{
+		return MFRC522::STATUS_CRC_WRONG;
+	}
+	*ativa = buffer[2];
+	return MFRC522::STATUS_OK;
+} // Fim ReadDirectory()
+
+/**
+ * Codifica e grava o bloco de diretório, com o CRC do diretório. É a escrita que confirma um registro.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522RecordStore::WriteDirectory(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, const EntradaDiretorio *entradas, byte ativa)
+{
+	byte buffer[16];
+
+	buffer[0] = ASSINATURA_0;
+	buffer[1] = ASSINATURA_1;
+	buffer[2] = ativa;
+	for (byte c = 0; c < 2; c++)
+	{
+		byte *e = &buffer[4 + 6 * c];
+		e[0] = entradas[c].versao & 0xFF;
+		e[1] = entradas[c].versao >> 8;
+		e[2] = entradas[c].tamanho;
+		e[4] = entradas[c].crc & 0xFF;
+		e[5] = entradas[c].crc >> 8;
+	}
+	buffer[CRC_DIRETORIO_LSB] = 0x00;
+	buffer[CRC_DIRETORIO_MSB] = 0x00;
+	buffer[4 + 6 + 3] = 0x00; // Reservado na entrada B
+	uint16_t crcDiretorio = DirectoryCrc(buffer);
+	buffer[CRC_DIRETORIO_LSB] = crcDiretorio & 0xFF;
+	buffer[CRC_DIRETORIO_MSB] = crcDiretorio >> 8;
+
+	MFRC522::StatusCode resultado = AuthenticateSector(uid, authCommand, key, _blocoDiretorio);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	return _leitor.MIFARE_Write(_blocoDiretorio, buffer, 16);
+} // Fim WriteDirectory()
+
+/**
+ * Lê uma cópia e confere o tamanho e o CRC registrados no diretório.
+ * Com data e length nullptr, apenas confere a cópia, calculando o CRC bloco a bloco.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_CRC_WRONG se a cópia não for consistente, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522RecordStore::ReadCopy(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, byte copia, EntradaDiretorio *entrada, byte *data, byte *length)
+{
+	byte buffer[18];
+	byte tamanho;
+	uint16_t crc = 0xFFFF;
+
+	if (entrada->tamanho > GetCapacity())
+	{
+		return MFRC522::STATUS_CRC_WRONG;
+	}
+
+	// Lê apenas os blocos que contêm bytes válidos
+	for (byte i = 0; i * 16 < entrada->tamanho; i++)
+	{
+		byte bloco = CopyBlock(copia, i);
+		MFRC522::StatusCode resultado = AuthenticateSector(uid, authCommand, key, bloco);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+		tamanho = sizeof(buffer);
+		resultado = _leitor.MIFARE_Read(bloco, buffer, &tamanho);
+		if (resultado != MFRC522::STATUS_OK)
+		{
+			return resultado;
+		}
+		byte restante = entrada->tamanho - i * 16;
+		if (restante > 16)
+		{
+			restante = 16;
+		}
+		crc = Crc16(buffer, restante, crc);
+		if (data)
+		{
+			memcpy(&data[i * 16], buffer, restante);
+		}
+	}
+
+	if (crc != entrada->crc)
+	{
+		return MFRC522::STATUS_CRC_WRONG;
+	}
+	if (length)
+	{
+		*length = entrada->tamanho;
+	}
+	return MFRC522::STATUS_OK;
+} // Fim ReadCopy()
+
+/**
+ * Retorna o endereço do bloco de dados de número indice dentro de uma cópia, pulando os trailers de setor.
+ */
+byte MFRC522RecordStore::CopyBlock(byte copia, byte indice) const
+{
+	byte bloco = _inicioCopia[copia];
+	for (;;)
+	{
+		if (!MifareClassicGeometry::IsTrailer(bloco))
+		{
+			if (indice == 0)
+			{
+				return bloco;
+			}
+			indice--;
+		}
+		bloco++;
+	}
+} // Fim CopyBlock()
+
+/**
+ * Calcula o CRC-16 do diretório: os 16 bytes do bloco com os dois bytes do próprio CRC em zero.
+ */
+uint16_t MFRC522RecordStore::DirectoryCrc(const byte *bloco)
+{
+	byte zero = 0x00;
+	uint16_t crc = Crc16(bloco, CRC_DIRETORIO_LSB);
+	crc = Crc16(&zero, 1, crc);
+	crc = Crc16(&bloco[CRC_DIRETORIO_LSB + 1], CRC_DIRETORIO_MSB - CRC_DIRETORIO_LSB - 1, crc);
+	crc = Crc16(&zero, 1, crc);
+	return Crc16(&bloco[CRC_DIRETORIO_MSB + 1], 16 - CRC_DIRETORIO_MSB - 1, crc);
+} // Fim DirectoryCrc()
+
+/**
+ * Retorna true se a versão a for mais recente que b, com comparação de número de série (RFC 1982): o contador
+ * de 16 bits pode dar a volta, e a é mais recente se estiver até 32767 escritas à frente de b.
+ */
+bool MFRC522RecordStore::IsNewer(uint16_t a, uint16_t b)
+{
+	return a != b && (uint16_t)(a - b) < 0x8000;
+} // Fim IsNewer()
+
+/**
+ * Calcula o CRC-16/CCITT (polinômio 0x1021, valor inicial 0xFFFF) no MCU.
+ * Passe o resultado anterior em crc para continuar o cálculo sobre mais dados.
+ */
+uint16_t MFRC522RecordStore::Crc16(const byte *data, byte length, uint16_t crc)
+{
+	for (byte i = 0; i < length; i++)
+	{
+		crc ^= (uint16_t)data[i] << 8;
+		for (byte bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+		}
+	}
+	return crc;
+} // Fim Crc16()
@@ -0,0 +1,73 @@
+/**
+ * Armazenamento de registros à prova de remoção do cartão para PICCs MIFARE Classic.
+ *
+ * Um registro é mantido em duas cópias (A e B) e em um bloco de diretório. A escrita nunca
+ * sobrescreve a cópia mais recente consistente e só é confirmada pela escrita final do bloco de diretório, que
+ * contém o contador de versão, o tamanho e o CRC de cada cópia. Como a escrita de um único
+ * bloco MIFARE Classic é atômica, um cartão removido no meio da escrita mantém a cópia anterior
+ * intacta e referenciada pelo diretório. O próprio diretório tem um CRC-16; um diretório danificado é
+ * recusado por Read() e Write() e pode ser reconstruído a partir da cópia consistente com Recover(), ou
+ * descartado com Format().
+ *
+ * A versão é um contador de 16 bits que dá a volta depois de 65535 escritas: compare versões por igualdade
+ * (como ReadIfChanged()), nunca por maior ou menor.
+ *
+ * Para que a leitura precise de uma única autenticação, coloque o diretório e as duas cópias
+ * no mesmo setor. Ex.: MIFARE 1K, setor 1: diretório no bloco 4, cópia A no bloco 5 e
+ * cópia B no bloco 6 (registros de até 16 bytes).
+ */
+#ifndef MFRC522RecordStore_h
+#define MFRC522RecordStore_h
+
+#include <Arduino.h>
+#include "MFRC522.h"
+
+class MFRC522RecordStore
+{
+public:
+	// Número máximo de blocos de dados por cópia (um setor grande do MIFARE 4K, menos o trailer).
+	static constexpr byte MAX_BLOCKS_PER_COPY = 15;
+
+	// Estrutura de uma entrada do diretório, uma para cada cópia
+	typedef struct
+	{
+		uint16_t versao; // Contador de versão, incrementado (módulo 65536) a cada escrita confirmada
+		byte tamanho;	 // Número de bytes válidos no registro
+		uint16_t crc;	 // CRC-16 dos bytes válidos do registro
+	} EntradaDiretorio;
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Construtores
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522RecordStore(MFRC522 &leitor, byte blocoDiretorio, byte inicioCopiaA, byte inicioCopiaB, byte blocosPorCopia);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções de acesso ao registro
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522::StatusCode Write(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, const byte *data, byte length, uint16_t *version = nullptr);
+	MFRC522::StatusCode Read(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, byte *data, byte *length, uint16_t *version = nullptr);
+	MFRC522::StatusCode ReadIfChanged(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, uint16_t knownVersion, byte *data, byte *length, uint16_t *version, bool *changed);
+	MFRC522::StatusCode ReadVersion(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, uint16_t *version);
+	MFRC522::StatusCode Recover(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, uint16_t *version = nullptr);
+	MFRC522::StatusCode Format(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key);
+	byte GetCapacity() const { return _blocosPorCopia * 16; };
+
+protected:
+	MFRC522 &_leitor;
+	byte _blocoDiretorio;
+	byte _inicioCopia[2];
+	byte _blocosPorCopia;
+	byte _setorAutenticado; // Primeiro bloco do setor autenticado, 0xFF se nenhum
+
+	MFRC522::StatusCode AuthenticateSector(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, byte blockAddr);
+	MFRC522::StatusCode ReadRecord(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, bool compararVersao, uint16_t versaoConhecida, byte *data, byte *length, uint16_t *version, bool *changed);
+	MFRC522::StatusCode ReadDirectory(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, EntradaDiretorio *entradas, byte *ativa);
+	MFRC522::StatusCode WriteDirectory(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, const EntradaDiretorio *entradas, byte ativa);
+	MFRC522::StatusCode ReadCopy(MFRC522::Uid *uid, byte authCommand, MFRC522::MIFARE_Key *key, byte copia, EntradaDiretorio *entrada, byte *data, byte *length);
+	byte CopyBlock(byte copia, byte indice) const;
+	static uint16_t DirectoryCrc(const byte *bloco);
+	static bool IsNewer(uint16_t a, uint16_t b);
+	static uint16_t Crc16(const byte *data, byte length, uint16_t crc = 0xFFFF);
+};
+
+#endif
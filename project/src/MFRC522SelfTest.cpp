@@ -0,0 +1,126 @@
+/*
+ * MFRC522SelfTest.cpp - Autoteste do MFRC522 (PCD_PerformSelfTest()).
+ * NOTA: Por favor, verifique também os comentários em MFRC522.h
+ * Liberado para o domínio público.
+ *
+ * Em uma unidade de compilação separada, o autoteste e as referências só entram no programa se
+ * PCD_PerformSelfTest() for chamado. Cada referência é o CRC32 (IEEE 802.3) dos 64 bytes esperados
+ * no FIFO, e as versões podem ser removidas com MFRC522_SELFTEST_V0_0, _V1_0, _V2_0 e _FM17522.
+ */
+
+#include "MFRC522.h"
+#include "MFRC522Dump.h"
+
+/**
+ * Obtém o CRC32 do resultado esperado do autoteste para uma versão de firmware.
+ *
+ * @return true se a referência da versão foi compilada.
+ */
+static bool ReferenciaAutoteste(byte versao,	 ///< O valor de VersionReg.
+								uint32_t *crc ///< Recebe o CRC32 de referência.
+)
+{
+	switch (versao)
+	{
+#if MFRC522_SELFTEST_FM17522
+	case 0x88: // Clone Fudan Semiconductor FM17522
+		*crc = 0xF4D32EDB;
+		return true;
+#endif
+#if MFRC522_SELFTEST_V0_0
+	case 0x90: // Versão 0.0: Philips Semiconductors; Preliminary Specification Revision 2.0 - 01 August 2005; 16.1
+		*crc = 0xA2AFB23A;
+		return true;
+#endif
+#if MFRC522_SELFTEST_V1_0
+	case 0x91: // Versão 1.0: NXP Semiconductors; Rev. 3.8 - 17 September 2014; 16.1.1
+		*crc = 0x57AB9CA0;
+		return true;
+#endif
+#if MFRC522_SELFTEST_V2_0
+	case 0x92: // Versão 2.0: NXP Semiconductors; Rev. 3.8 - 17 September 2014; 16.1.1
+		*crc = 0x367110C6;
+		return true;
+#endif
+	default:
+		(void)crc;
+		return false;
+	}
+} // Fim ReferenciaAutoteste()
+
+/**
+ * Realiza um autoteste do MFRC522
+ * Consulte a seção 16.1.1 em http://www.nxp.com/documents/data_sheet/MFRC522.pdf
+ *
+ * @return Se o teste passou ou não. Ou falso se nenhuma referência de firmware estiver disponível.
+ */
+bool MFRC522::PCD_PerformSelfTest()
+{
+	// Isso segue diretamente os passos descritos na seção 16.1.1
+	// 1. Realize uma reinicialização suave.
+	PCD_Reset();
+
+	// 2. Limpe o buffer interno escrevendo 25 bytes de 00h
+	byte ZEROES[25] = {0x00};
+	PCD_WriteRegister(FIFOLevelReg, 0x80);		// limpe o buffer FIFO
+	PCD_WriteRegister(FIFODataReg, 25, ZEROES); // escreva 25 bytes de 00h no FIFO
+	PCD_WriteRegister(CommandReg, PCD_Mem);		// transfira para o buffer interno
+
+	// 3. Ative o autoteste
+	PCD_WriteRegister(AutoTestReg, 0x09);
+
+	// 4. Escreva 00h no buffer FIFO
+	PCD_WriteRegister(FIFODataReg, 0x00);
+
+	// 5. Inicie o autoteste emitindo o comando CalcCRC
+	PCD_WriteRegister(CommandReg, PCD_CalcCRC);
+
+	// 6. Aguarde o autoteste ser concluído
+	byte n;
+	for (uint8_t i = 0; i < 0xFF; i++)
+	{
+		// O datasheet não especifica uma condição exata de conclusão, exceto
+		// que o buffer FIFO deve conter 64 bytes.
+		// Embora o autoteste seja iniciado pelo comando CalcCRC
+		// ele se comporta de forma diferente da computação de CRC normal,
+		// então não é possível usar com confiabilidade o DivIrqReg para verificar a conclusão.
+		// Relata-se que alguns dispositivos não acionam a bandeira CRCIRq
+		// durante o autoteste.
+		n = PCD_ReadRegister(FIFOLevelReg);
+		if (n >= 64)
+		{
+			break;
+		}
+	}
+	PCD_WriteRegister(CommandReg, PCD_Idle); // Pare de calcular o CRC para novo conteúdo no FIFO.
+
+	// 7. Leia os 64 bytes resultantes do buffer FIFO.
+	byte result[64];
+	PCD_ReadRegister(FIFODataReg, 64, result, 0);
+
+	// Autoteste automático concluído
+	// Redefina o registro AutoTestReg para 0 novamente. Necessário para operação normal.
+	PCD_WriteRegister(AutoTestReg, 0x00);
+
+	// Determine a versão do firmware (consulte a seção 9.3.4.8 no manual)
+	byte version = PCD_ReadRegister(VersionReg);
+
+	// Compare o CRC32 do resultado com a referência da versão
+	uint32_t referencia;
+	if (!ReferenciaAutoteste(version, &referencia))
+	{
+		return false; // Versão desconhecida ou removida da compilação: abortar teste
+	}
+	if (~MFRC522DumpBinary::UpdateCrc32(0xFFFFFFFF, result, sizeof(result)) != referencia)
+	{
+		return false;
+	}
+
+	// 8. Realize uma reinicialização, pois o PCD não funciona após o teste.
+	// A redefinição não funciona como o esperado.
+	// "Autoteste automático concluído" não funciona como o esperado.
+	PCD_Init();
+
+	// Teste passou; tudo está bom.
+	return true;
+} // Fim PCD_PerformSelfTest()
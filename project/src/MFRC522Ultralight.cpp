@@ -0,0 +1,232 @@
+/*
+ * MFRC522Ultralight.cpp - Identificação de PICCs MIFARE Ultralight e NTAG21x com GET_VERSION.
+ * NOTA: Por favor, verifique também os comentários em MFRC522Ultralight.h
+ * Liberado para o domínio público.
+ */
+
+#include "MFRC522Ultralight.h"
+
+// Comandos usados na identificação
+static constexpr byte CMD_GET_VERSION = 0x60;	  // Ultralight EV1 e NTAG21x
+static constexpr byte CMD_AUTHENTICATE_3DES = 0x1A; // Ultralight C, primeiro passo da autenticação
+
+// Tempo de espera da resposta durante a identificação. Os PICCs respondem em menos de 1ms; um PICC que não
+// conhece o comando não responde ou envia um NAK, e não há motivo para esperar o timeout padrão de 25ms.
+static constexpr uint32_t TIMEOUT_IDENTIFICACAO_US = 5000;
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Construtores
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Construtor.
+ */
+MFRC522Ultralight::MFRC522Ultralight(MFRC522 &leitor ///< Instância MFRC522 usada para a comunicação.
+									 )
+	: _leitor(leitor)
+{
+	for (byte i = 0; i < CACHE_SIZE; i++)
+	{
+		_cache[i].tamanhoUid = 0;
+	}
+	_proximaEntrada = 0;
+} // Fim do construtor
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de identificação
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Identifica o produto exato de um PICC com SAK 0x00 (PICC_TYPE_MIFARE_UL).
+ *
+ * Se o UID já foi identificado, o resultado guardado é retornado sem comunicação com o PICC.
+ * Caso contrário o PICC é consultado e, se precisou ser selecionado novamente, continua selecionado ao final.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Ultralight::Identify(MFRC522::Uid *uid, ///< Ponteiro para a estrutura Uid retornada de um PICC_Select() bem-sucedido.
+												Product *product   ///< Recebe o produto identificado.
+)
+{
+	for (byte i = 0; i < CACHE_SIZE; i++)
+	{
+		if (_cache[i].tamanhoUid == uid->size && memcmp(_cache[i].uid, uid->uidByte, uid->size) == 0)
+		{
+			*product = _cache[i].produto;
+			return MFRC522::STATUS_OK;
+		}
+	}
+
+	uint32_t timeoutAnterior = _leitor.PCD_GetTimeout();
+	_leitor.PCD_SetTimeout(TIMEOUT_IDENTIFICACAO_US);
+	MFRC522::StatusCode resultado = Probe(uid, product);
+	_leitor.PCD_SetTimeout(timeoutAnterior);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+
+	EntradaCache *entrada = &_cache[_proximaEntrada];
+	_proximaEntrada = (_proximaEntrada + 1) % CACHE_SIZE;
+	entrada->tamanhoUid = uid->size;
+	memcpy(entrada->uid, uid->uidByte, uid->size);
+	entrada->produto = *product;
+	return MFRC522::STATUS_OK;
+} // Fim Identify()
+
+/**
+ * Remove o UID da cache, por exemplo depois de alterar a configuração do PICC.
+ */
+void MFRC522Ultralight::Forget(const MFRC522::Uid *uid)
+{
+	for (byte i = 0; i < CACHE_SIZE; i++)
+	{
+		if (_cache[i].tamanhoUid == uid->size && memcmp(_cache[i].uid, uid->uidByte, uid->size) == 0)
+		{
+			_cache[i].tamanhoUid = 0;
+		}
+	}
+} // Fim Forget()
+
+/**
+ * Retorna uma string com o nome do produto.
+ *
+ * @return const __FlashStringHelper *
+ */
+const __FlashStringHelper *MFRC522Ultralight::GetProductName(Product product ///< Um dos enums Product.
+)
+{
+	switch (product)
+	{
+	case PRODUCT_ULTRALIGHT:
+		return F("MIFARE Ultralight (MF0ICU1)");
+	case PRODUCT_ULTRALIGHT_C:
+		return F("MIFARE Ultralight C (MF0ICU2)");
+	case PRODUCT_ULTRALIGHT_EV1_MF0UL11:
+		return F("MIFARE Ultralight EV1 (MF0UL11), 48 bytes");
+	case PRODUCT_ULTRALIGHT_EV1_MF0UL21:
+		return F("MIFARE Ultralight EV1 (MF0UL21), 128 bytes");
+	case PRODUCT_NTAG210:
+		return F("NTAG210, 48 bytes");
+	case PRODUCT_NTAG212:
+		return F("NTAG212, 128 bytes");
+	case PRODUCT_NTAG213:
+		return F("NTAG213, 144 bytes");
+	case PRODUCT_NTAG215:
+		return F("NTAG215, 504 bytes");
+	case PRODUCT_NTAG216:
+		return F("NTAG216, 888 bytes");
+	case PRODUCT_UNKNOWN:
+	default:
+		return F("Produto desconhecido");
+	}
+} // Fim GetProductName()
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Funções de suporte
+/////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Consulta o PICC: GET_VERSION e, se não for suportado, o primeiro passo da autenticação 3DES.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Ultralight::Probe(MFRC522::Uid *uid, Product *product)
+{
+	MFRC522::StatusCode resultado;
+	byte comando[4];
+	byte resposta[12];
+	byte tamanho;
+
+	// GET_VERSION: 8 bytes + CRC_A
+	comando[0] = CMD_GET_VERSION;
+	MFRC522::CalculateCRC_A(comando, 1, &comando[1]);
+	tamanho = sizeof(resposta);
+	resultado = _leitor.PCD_TransceiveData(comando, 3, resposta, &tamanho, nullptr, 0, true);
+	if (resultado == MFRC522::STATUS_OK && tamanho == 10)
+	{
+		*product = DecodeVersion(resposta);
+		return MFRC522::STATUS_OK;
+	}
+
+	// Sem GET_VERSION: o PICC voltou ao estado IDLE e precisa ser selecionado novamente.
+	resultado = Reselect(uid);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+
+	// AUTHENTICATE (3DES), primeiro passo: o Ultralight C responde 0xAF + ek(RndB) (8 bytes) + CRC_A.
+	comando[0] = CMD_AUTHENTICATE_3DES;
+	comando[1] = 0x00;
+	MFRC522::CalculateCRC_A(comando, 2, &comando[2]);
+	tamanho = sizeof(resposta);
+	resultado = _leitor.PCD_TransceiveData(comando, 4, resposta, &tamanho, nullptr, 0, true);
+	if (resultado == MFRC522::STATUS_OK && tamanho == 11 && resposta[0] == 0xAF)
+	{
+		*product = PRODUCT_ULTRALIGHT_C;
+	}
+	else
+	{
+		*product = PRODUCT_ULTRALIGHT;
+	}
+
+	// Abandona a autenticação iniciada (Ultralight C) ou o comando recusado (Ultralight).
+	return Reselect(uid);
+} // Fim Probe()
+
+/**
+ * Seleciona novamente o PICC com o UID conhecido, depois de um comando que o levou ao estado IDLE.
+ *
+ * @return STATUS_OK em caso de sucesso, STATUS_??? caso contrário.
+ */
+MFRC522::StatusCode MFRC522Ultralight::Reselect(MFRC522::Uid *uid)
+{
+	byte atqa[2];
+	byte tamanho = sizeof(atqa);
+
+	_leitor.PICC_HaltA();
+	MFRC522::StatusCode resultado = _leitor.PICC_WakeupA(atqa, &tamanho);
+	if (resultado != MFRC522::STATUS_OK)
+	{
+		return resultado;
+	}
+	return _leitor.PICC_Select(uid, uid->size * 8);
+} // Fim Reselect()
+
+/**
+ * Decodifica a resposta de GET_VERSION:
+ * cabeçalho fixo, fabricante, tipo de produto, subtipo, versão maior, versão menor, tamanho, protocolo.
+ */
+MFRC522Ultralight::Product MFRC522Ultralight::DecodeVersion(const byte *versao)
+{
+	const byte tipo = versao[2];	   // 0x03 = Ultralight, 0x04 = NTAG
+	const byte armazenamento = versao[6];
+	if (tipo == 0x03)
+	{
+		switch (armazenamento)
+		{
+		case 0x0B:
+			return PRODUCT_ULTRALIGHT_EV1_MF0UL11;
+		case 0x0E:
+			return PRODUCT_ULTRALIGHT_EV1_MF0UL21;
+		}
+	}
+	else if (tipo == 0x04)
+	{
+		switch (armazenamento)
+		{
+		case 0x0B:
+			return PRODUCT_NTAG210;
+		case 0x0E:
+			return PRODUCT_NTAG212;
+		case 0x0F:
+			return PRODUCT_NTAG213;
+		case 0x11:
+			return PRODUCT_NTAG215;
+		case 0x13:
+			return PRODUCT_NTAG216;
+		}
+	}
+	return PRODUCT_UNKNOWN;
+} // Fim DecodeVersion()
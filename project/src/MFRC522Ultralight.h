@@ -0,0 +1,102 @@
+/**
+ * Identificação exata de PICCs MIFARE Ultralight e NTAG21x.
+ *
+ * PICC_GetType() usa apenas o SAK, que é igual (0x00) para todos os Ultralight, Ultralight C,
+ * Ultralight EV1 e NTAG21x. Identify() envia GET_VERSION (0x60); os PICCs que não o suportam
+ * (Ultralight e Ultralight C) respondem com NAK, são selecionados novamente e então o primeiro
+ * passo da autenticação 3DES (0x1A) separa o Ultralight C do Ultralight original.
+ *
+ * O resultado é guardado por UID, então um mesmo PICC é identificado apenas uma vez, e GetGeometry()
+ * descreve a memória de cada produto (páginas de usuário, configuração, PWD/PACK, suporte a FAST_READ),
+ * calculada em tempo de compilação quando o produto é constante.
+ */
+#ifndef MFRC522Ultralight_h
+#define MFRC522Ultralight_h
+
+#include <Arduino.h>
+#include "MFRC522.h"
+
+class MFRC522Ultralight
+{
+public:
+	// Produtos identificados. Lembre-se de atualizar GetGeometry() e GetProductName() se adicionar mais.
+	enum Product : byte
+	{
+		PRODUCT_UNKNOWN = 0,
+		PRODUCT_ULTRALIGHT,			  // MF0ICU1
+		PRODUCT_ULTRALIGHT_C,		  // MF0ICU2
+		PRODUCT_ULTRALIGHT_EV1_MF0UL11,
+		PRODUCT_ULTRALIGHT_EV1_MF0UL21,
+		PRODUCT_NTAG210,
+		PRODUCT_NTAG212,
+		PRODUCT_NTAG213,
+		PRODUCT_NTAG215,
+		PRODUCT_NTAG216
+	};
+
+	// Organização da memória de um produto. Páginas ausentes são 0.
+	typedef struct
+	{
+		byte totalPaginas;			// Número de páginas endereçáveis
+		byte primeiraPaginaUsuario; // Primeira página de dados do usuário
+		byte ultimaPaginaUsuario;	// Última página de dados do usuário, inclusive
+		byte paginaAuth0;			// Página com o byte AUTH0 (CFG0 no EV1/NTAG, 0x2A no Ultralight C)
+		byte paginaPwd;				// Página com a senha de PWD_AUTH
+		byte paginaPack;			// Página com o PACK de PWD_AUTH
+		bool fastRead;				// true se o PICC suporta FAST_READ (0x3A)
+	} Geometria;
+
+	// Número de UIDs guardados com o produto identificado
+	static constexpr byte CACHE_SIZE = 4;
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Construtores
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522Ultralight(MFRC522 &leitor);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Funções de identificação
+	/////////////////////////////////////////////////////////////////////////////////////
+	MFRC522::StatusCode Identify(MFRC522::Uid *uid, Product *product);
+	void Forget(const MFRC522::Uid *uid);
+	static const __FlashStringHelper *GetProductName(Product product);
+
+	static constexpr Geometria GetGeometry(Product product)
+	{
+		//                                        total  1ª usr  últ usr AUTH0  PWD   PACK  FAST_READ
+		return (product == PRODUCT_ULTRALIGHT)				? Geometria{16, 4, 0x0F, 0, 0, 0, false}
+			   : (product == PRODUCT_ULTRALIGHT_C)			? Geometria{48, 4, 0x27, 0x2A, 0, 0, false}
+			   : (product == PRODUCT_ULTRALIGHT_EV1_MF0UL11) ? Geometria{20, 4, 0x0F, 0x10, 0x12, 0x13, true}
+			   : (product == PRODUCT_ULTRALIGHT_EV1_MF0UL21) ? Geometria{41, 4, 0x23, 0x25, 0x27, 0x28, true}
+			   : (product == PRODUCT_NTAG210)				? Geometria{20, 4, 0x0F, 0x10, 0x12, 0x13, true}
+			   : (product == PRODUCT_NTAG212)				? Geometria{41, 4, 0x23, 0x25, 0x27, 0x28, true}
+			   : (product == PRODUCT_NTAG213)				? Geometria{45, 4, 0x27, 0x29, 0x2B, 0x2C, true}
+			   : (product == PRODUCT_NTAG215)				? Geometria{135, 4, 0x81, 0x83, 0x85, 0x86, true}
+			   : (product == PRODUCT_NTAG216)				? Geometria{231, 4, 0xE1, 0xE3, 0xE5, 0xE6, true}
+															: Geometria{16, 4, 0x0F, 0, 0, 0, false}; // Desconhecido: apenas o que todo Ultralight tem
+	};
+
+	// true se todas as páginas do intervalo existem no produto.
+	static constexpr bool IsPageRangeValid(Product product, byte firstPage, byte lastPage)
+	{
+		return firstPage <= lastPage && lastPage < GetGeometry(product).totalPaginas;
+	};
+
+protected:
+	typedef struct
+	{
+		byte tamanhoUid; // 0 se a entrada estiver livre
+		byte uid[10];
+		Product produto;
+	} EntradaCache;
+
+	MFRC522 &_leitor;
+	EntradaCache _cache[CACHE_SIZE];
+	byte _proximaEntrada; // Próxima entrada a substituir (circular)
+
+	MFRC522::StatusCode Probe(MFRC522::Uid *uid, Product *product);
+	MFRC522::StatusCode Reselect(MFRC522::Uid *uid);
+	static Product DecodeVersion(const byte *versao);
+};
+
+#endif
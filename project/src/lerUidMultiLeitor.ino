@@ -28,6 +28,7 @@
 
 #include <SPI.h>
 #include <MFRC522.h>
+#include <MFRC522ReaderGroup.h>
 
 #define RST_PIN 9   // Configurável, veja o layout típico dos pinos acima
 #define SS_1_PIN 10 // Configurável, use um pino não utilizado, apenas HIGH/LOW necessário, deve ser diferente do SS 2
@@ -38,6 +39,7 @@
 byte ssPins[] = {SS_1_PIN, SS_2_PIN};
 
 MFRC522 mfrc522[NR_OF_READERS]; // Crie instâncias MFRC522.
+MFRC522ReaderGroup leitores(mfrc522, NR_OF_READERS); // Procura cartões em todos os leitores de uma vez
 
 /**
  * Inicialização.
@@ -67,11 +69,13 @@ void setup()
 void loop()
 {
 
+    // Procure por novos cartões em todos os leitores de uma vez: a varredura leva o tempo do leitor mais lento,
+    // e não a soma de todos (um leitor vazio espera o timeout inteiro).
+    byte presentes = leitores.Scan();
+
     for (uint8_t leitor = 0; leitor < NR_OF_READERS; leitor++)
     {
-        // Procure por novos cartões
-
-        if (mfrc522[leitor].PICC_IsNewCardPresent() && mfrc522[leitor].PICC_ReadCardSerial())
+        if ((presentes & (1 << leitor)) && mfrc522[leitor].PICC_ReadCardSerial())
         {
             Serial.print(F("Leitor "));
             Serial.print(leitor);
@@ -87,7 +91,7 @@ void loop()
             mfrc522[leitor].PICC_HaltA();
             // Parar a criptografia no PCD
             mfrc522[leitor].PCD_StopCrypto1();
-        } // if (mfrc522[leitor].PICC_IsNewC
+        } // if ((presentes & (1 << leitor))
     }     // for(uint8_t leitor
 }
 
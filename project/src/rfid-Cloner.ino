@@ -1,28 +1,33 @@
 /*
- * Gravação na EEPROM
+ * Copiador de cartões MIFARE Classic 1K
  *
- * Armazena valores lidos da entrada analógica 0 na EEPROM.
- * Esses valores permanecerão na EEPROM quando a placa for
- * desligada e podem ser recuperados posteriormente por outro esboço.
+ * Lê o cartão de origem inteiro (uma autenticação por setor, tentando as chaves padrão conhecidas)
+ * para a memória e o copia para um novo cartão com MFRC522Clone. MFRC522Magic identifica o cartão de destino:
+ *   - cartões "mágicos" Gen1a (UID modificável): o cartão inteiro, incluindo o bloco 0 (UID) e os
+ *     trailers, é escrito em uma única passagem, sem autenticação;
+ *   - demais cartões: uma autenticação por setor com a chave padrão de fábrica; o bloco 0 (UID) é
+ *     escrito por último se o cartão permitir (Gen2/CUID).
  */
 
 #include <SPI.h>
 #include <MFRC522.h>
+#include <MFRC522Clone.h>
+#include <MFRC522Magic.h>
 
 #define RST_PIN 9 // Configurável, veja o layout típico dos pinos acima
 #define SS_PIN 10 // Configurável, veja o layout típico dos pinos acima
 
 MFRC522 mfrc522(SS_PIN, RST_PIN); // Cria uma instância MFRC522.
+MFRC522Clone clone(mfrc522);
+MFRC522Magic magico(mfrc522);
 
-byte buffer[18];
-byte bloco;
-byte dados[64][16];
+const MFRC522::PICC_Type TIPO = MFRC522::PICC_TYPE_MIFARE_1K;
+byte imagem[MFRC522Clone::GetImageSize(TIPO)]; // 64 blocos de 16 bytes
+bool imagemLida = false;
 MFRC522::StatusCode status;
 
-MFRC522::MIFARE_Key chave;
-
 // Número de chaves padrão conhecidas (codificadas em duro)
-// NOTA: Sincronize a definição NR_CHAVE_CONHECIDA com a matriz defaultKeys[]
+// NOTA: Sincronize a definição NR_CHAVE_CONHECIDA com a matriz chavesConhecidas[]
 #define NR_CHAVE_CONHECIDA 8
 // Chaves conhecidas, consulte: https://code.google.com/p/mfcuk/wiki/MifareClassicDefaultKeys
 byte chavesConhecidas[NR_CHAVE_CONHECIDA][MFRC522::MF_KEY_SIZE] = {
@@ -36,7 +41,6 @@ byte chavesConhecidas[NR_CHAVE_CONHECIDA][MFRC522::MF_KEY_SIZE] = {
     {0x00, 0x00, 0x00, 0x00, 0x00, 0x00}  // 00 00 00 00 00 00
 };
 
-char escolha;
 /*
  * Inicialização.
  */
@@ -47,13 +51,12 @@ void setup()
         ;               // Não faz nada se nenhuma porta serial estiver aberta (adicionado para Arduinos baseados no ATMEGA32U4)
     SPI.begin();        // Inicializa barramento SPI
     mfrc522.PCD_Init(); // Inicializa o cartão MFRC522
-    Serial.println(F("Tente as chaves padrão mais usadas para ler o bloco 0 a 63 de um MIFARE PICC."));
-    Serial.println("1.Ler cartão \n2.Escrever no cartão \n3.Copiar os dados.");
+    exibir_menu();
+}
 
-    for (byte i = 0; i < 6; i++)
-    {
-        chave.keyByte[i] = 0xFF;
-    }
+void exibir_menu()
+{
+    Serial.println(F("1.Ler cartão \n2.Exibir os dados lidos \n3.Copiar para um novo cartão"));
 }
 
 void exibir_array_de_bytes(byte *buffer, byte tamanhoBuffer)
@@ -64,80 +67,52 @@ void exibir_array_de_bytes(byte *buffer, byte tamanhoBuffer)
         Serial.print(buffer[i], HEX);
     }
 }
-// Lê bytes do buffer e exibe como ASCII no monitor serial
 
-void exibir_array_de_bytes_como_ascii(byte *buffer, byte tamanhoBuffer)
+/*
+ * Aguarda um cartão e o seleciona.
+ */
+bool aguardar_cartao()
 {
-    for (byte i = 0; i < tamanhoBuffer; i++)
+    Serial.println(F("Aproxime o cartão..."));
+    while (!mfrc522.PICC_IsNewCardPresent() || !mfrc522.PICC_ReadCardSerial())
     {
-        Serial.print(buffer[i] < 0x10 ? " 0" : " ");
-        Serial.write(buffer[i]);
+        delay(50);
+    }
+    Serial.print(F("UID do Cartão:"));
+    exibir_array_de_bytes(mfrc522.uid.uidByte, mfrc522.uid.size);
+    Serial.println();
+    MFRC522::PICC_Type piccType = mfrc522.PICC_GetType(mfrc522.uid.sak);
+    Serial.print(F("Tipo PICC: "));
+    Serial.println(mfrc522.PICC_GetTypeName(piccType));
+    if (piccType != TIPO)
+    {
+        Serial.println(F("Este exemplo só copia cartões MIFARE Classic 1K."));
+        mfrc522.PICC_HaltA();
+        return false;
     }
+    return true;
 }
 
 /*
- * Tenta usar o PICC (o tag/cartão) com a chave fornecida para acessar o bloco 0 a 63.
- * Em caso de sucesso, mostrará os detalhes da chave e exibirá os dados do bloco no Serial.
- *
- * @return true quando a chave fornecida funcionar, false caso contrário.
+ * Encerra a comunicação com o cartão e exibe o resultado.
  */
-
-bool tentar_chave(MFRC522::MIFARE_Key *chave)
+void encerrar(const __FlashStringHelper *operacao)
 {
-    bool resultado = false;
-
-    for (byte bloco = 0; bloco < 64; bloco++)
-    {
-
-        // Serial.println(F("Autenticando usando chave A..."));
-        status = mfrc522.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, bloco, chave, &(mfrc522.uid));
-        if (status != MFRC522::STATUS_OK)
-        {
-            Serial.print(F("Falha em PCD_Authenticate(): "));
-            Serial.println(mfrc522.GetStatusCodeName(status));
-            return false;
-        }
-
-        // Ler bloco
-        byte contagemBytes = sizeof(buffer);
-        status = mfrc522.MIFARE_Read(bloco, buffer, &contagemBytes);
-        if (status != MFRC522::STATUS_OK)
-        {
-            Serial.print(F("Falha em MIFARE_Read(): "));
-            Serial.println(mfrc522.GetStatusCodeName(status));
-        }
-        else
-        {
-            // Leitura bem-sucedida
-            resultado = true;
-            Serial.print(F("Sucesso com a chave:"));
-            dump_byte_array((*chave).keyByte, MFRC522::MF_KEY_SIZE);
-            Serial.println();
-
-            // Dump dos dados do bloco
-            Serial.print(F("Bloco "));
-            Serial.print(bloco);
-            Serial.print(F(":"));
-            dump_byte_array1(buffer, 16); // converter de hexadecimal para ASCII
-            Serial.println();
-
-            for (int p = 0; p < 16; p++) // Ler os 16 bits do bloco
-            {
-                dados[bloco][p] = buffer[p];
-                Serial.print(dados[bloco][p]);
-                Serial.print(" ");
-            }
-        }
-    }
-    Serial.println();
-
-    Serial.println("1.Ler cartão \n2.Escrever no cartão \n3.Copiar os dados.");
-
     mfrc522.PICC_HaltA();      // Parar PICC
     mfrc522.PCD_StopCrypto1(); // Parar criptografia no PCD
-    return resultado;
-
-    start();
+    Serial.print(operacao);
+    if (status == MFRC522::STATUS_OK)
+    {
+        Serial.println(F(": sucesso."));
+    }
+    else
+    {
+        Serial.print(F(" falhou no bloco "));
+        Serial.print(clone.GetLastBlock());
+        Serial.print(F(": "));
+        Serial.println(mfrc522.GetStatusCodeName(status));
+    }
+    exibir_menu();
 }
 
 /*
@@ -145,175 +120,109 @@ bool tentar_chave(MFRC522::MIFARE_Key *chave)
  */
 void loop()
 {
-    iniciar();
-}
-
-void iniciar()
-{
-    choice = Serial.read();
-
-    if (choice == '1')
+    switch (Serial.read())
     {
-        Serial.println("Ler o cartão");
+    case '1':
         escolha1();
-    }
-    else if (choice == '2')
-    {
-        Serial.println("Verificar o que está nas variáveis");
+        break;
+    case '2':
         escolha2();
-    }
-    else if (choice == '3')
-    {
-        Serial.println("Copiar os dados para o novo cartão");
+        break;
+    case '3':
         escolha3();
+        break;
     }
 }
 
-void escolha2()
-{ // Testar valores nos blocos
+void escolha1()
+{ // Ler cartão, tentando as chaves padrão conhecidas
+    if (!aguardar_cartao())
+        return;
 
-    for (block = 4; block <= 62; block++)
+    MFRC522::MIFARE_Key chave;
+    for (byte k = 0; k < NR_CHAVE_CONHECIDA; k++)
     {
-        if (block == 7 || block == 11 || block == 15 || block == 19 || block == 23 || block == 27 || block == 31 || block == 35 || block == 39 || block == 43 || block == 47 || block == 51 || block == 55 || block == 59)
+        // Copiar a chave conhecida para a estrutura MIFARE_Key
+        for (byte i = 0; i < MFRC522::MF_KEY_SIZE; i++)
         {
-            block++;
+            chave.keyByte[i] = chavesConhecidas[k][i];
         }
-
-        Serial.print(F("Escrevendo dados no bloco "));
-        Serial.print(block);
-        Serial.println("\n");
-
-        for (int j = 0; j < 16; j++)
+        status = clone.ReadImage(&(mfrc522.uid), TIPO, &chave, imagem);
+        if (status == MFRC522::STATUS_OK)
         {
-            Serial.print(dados[block][j]);
-            Serial.print(" ");
+            Serial.print(F("Sucesso com a chave:"));
+            exibir_array_de_bytes(chave.keyByte, MFRC522::MF_KEY_SIZE);
+            Serial.println();
+            imagemLida = true;
+            break;
         }
-        Serial.println("\n");
+        // Uma autenticação que falha tira o cartão do estado ativo: selecione-o novamente para a próxima chave
+        mfrc522.PCD_StopCrypto1();
+        byte atqa[2];
+        byte tamanhoAtqa = sizeof(atqa);
+        mfrc522.PICC_WakeupA(atqa, &tamanhoAtqa);
+        mfrc522.PICC_Select(&(mfrc522.uid));
     }
+    encerrar(F("Leitura"));
+}
 
-    Serial.println("1. Ler o cartão \n2. Escrever no cartão \n3. Copiar os dados.");
-    iniciar();
+void escolha2()
+{ // Exibir a imagem lida
+    for (byte bloco = 0; bloco < MFRC522Clone::GetBlockCount(TIPO); bloco++)
+    {
+        Serial.print(F("Bloco "));
+        Serial.print(bloco);
+        Serial.print(F(":"));
+        exibir_array_de_bytes(&imagem[bloco * 16], 16);
+        Serial.println();
+    }
+    exibir_menu();
 }
 
 void escolha3()
-{ // Copiar os dados no novo cartão
-    Serial.println("Insira o novo cartão...");
-
-    // Procurar por novos cartões
-    if (!mfrc522.PICC_IsNewCardPresent())
+{ // Copiar para um novo cartão pelo método da sua geração
+    if (!imagemLida)
+    {
+        Serial.println(F("Leia um cartão primeiro."));
         return;
-
-    // Selecionar um dos cartões
-    if (!mfrc522.PICC_ReadCardSerial())
+    }
+    if (!aguardar_cartao())
         return;
 
-    // Mostrar alguns detalhes do PICC (ou seja, o tag/cartão)
-    Serial.print(F("UID do Cartão:"));
-    dump_byte_array(mfrc522.uid.uidByte, mfrc522.uid.size);
-    Serial.println();
-    Serial.print(F("Tipo PICC: "));
-    MFRC522::PICC_Type piccType = mfrc522.PICC_GetType(mfrc522.uid.sak);
-    Serial.println(mfrc522.PICC_GetTypeName(piccType));
-
-    // Tentar as chaves padrão conhecidas
-    /*MFRC522::MIFARE_Key key;
-    for (byte k = 0; k < NR_CHAVE_CONHECIDA; k++) {
-      // Copiar a chave conhecida para a estrutura MIFARE_Key
-      for (byte i = 0; i < MFRC522::MF_KEY_SIZE; i++) {
-        key.keyByte[i] = knownKeys[k][i];
-      }
-    }*/
-    for (byte i = 0; i < 6; i++)
+    MFRC522::MIFARE_Key chave;
+    for (byte i = 0; i < MFRC522::MF_KEY_SIZE; i++)
     {
-        key.keyByte[i] = 0xFF;
+        chave.keyByte[i] = 0xFF; // Chave padrão de fábrica
     }
-
-    for (int i = 4; i <= 62; i++)
-    { // Copiar os blocos 4 até 62, excluindo os blocos mencionados (pois são blocos de autenticação)
-        if (i == 7 || i == 11 || i == 15 || i == 19 || i == 23 || i == 27 || i == 31 || i == 35 || i == 39 || i == 43 || i == 47 || i == 51 || i == 55 || i == 59)
-        {
-            i++;
-        }
-        block = i;
-
-        // Autenticar usando a chave A
-        Serial.println(F("Autenticando usando chave A..."));
-        status = (MFRC522::StatusCode)mfrc522.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, block, &key, &(mfrc522.uid));
-        if (status != MFRC522::STATUS_OK)
-        {
-            Serial.print(F("PCD_Authenticate() falhou: "));
-            Serial.println(mfrc522.GetStatusCodeName(status));
-            return;
-        }
-
-        // Autenticar usando a chave B
-        Serial.println(F("Autenticando novamente usando chave B..."));
-        status = (MFRC522::StatusCode)mfrc522.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_B, block, &key, &(mfrc522.uid));
-        if (status != MFRC522::STATUS_OK)
-        {
-            Serial.print(F("PCD_Authenticate() falhou: "));
-            Serial.println(mfrc522.GetStatusCodeName(status));
-            return;
-        }
-
-        // Escrever dados no bloco
-        Serial.print(F("Escrevendo dados no bloco "));
-        Serial.print(block);
-        Serial.println("\n");
-
-        dump_byte_array(dados[block], 16);
-
-        status = (MFRC522::StatusCode)mfrc522.MIFARE_Write(block, dados[block], 16);
-        if (status != MFRC522::STATUS_OK)
-        {
-            Serial.print(F("MIFARE_Write() falhou: "));
-            Serial.println(mfrc522.GetStatusCodeName(status));
-        }
-
-        Serial.println("\n");
-    }
-
-    mfrc522.PICC_HaltA();      // Encerrar o PICC
-    mfrc522.PCD_StopCrypto1(); // Encerrar a criptografia no PCD
-
-    Serial.println("1. Ler o cartão \n2. Escrever no cartão \n3. Copiar os dados.");
-    iniciar();
-}
-
-void escolha1()
-{ // Ler cartão
-    Serial.println("Insira o cartão...");
-    // Procurar por novos cartões
-    if (!mfrc522.PICC_IsNewCardPresent())
-        return;
-
-    // Selecionar um dos cartões
-    if (!mfrc522.PICC_ReadCardSerial())
+    MFRC522Magic::Generation geracao;
+    status = magico.Identify(&(mfrc522.uid), &chave, false, &geracao);
+    if (status != MFRC522::STATUS_OK)
+    {
+        encerrar(F("Identificação"));
         return;
+    }
+    Serial.println(MFRC522Magic::GetGenerationName(geracao));
 
-    // Mostrar alguns detalhes do PICC (ou seja, o tag/cartão)
-    Serial.print(F("UID do Cartão:"));
-    dump_byte_array(mfrc522.uid.uidByte, mfrc522.uid.size);
-    Serial.println();
-    Serial.print(F("Tipo PICC: "));
-    MFRC522::PICC_Type piccType = mfrc522.PICC_GetType(mfrc522.uid.sak);
-    Serial.println(mfrc522.PICC_GetTypeName(piccType));
-
-    // Tentar as chaves padrão conhecidas
-    MFRC522::MIFARE_Key key;
-    for (byte k = 0; k < NR_CHAVE_CONHECIDA; k++)
+    if (geracao == MFRC522Magic::MAGIC_GEN1A)
     {
-        // Copiar a chave conhecida para a estrutura MIFARE_Key
-        for (byte i = 0; i < MFRC522::MF_KEY_SIZE; i++)
-        {
-            key.keyByte[i] = knownKeys[k][i];
-        }
-        // Tentar a chave
-        if (tentar_chave(&key))
+        // O cartão inteiro em uma passagem, sem autenticação
+        status = clone.WriteMagic(imagem, TIPO, true);
+    }
+    else
+    {
+        // Uma autenticação por setor; o bloco 0 fica por último, com a Chave A do setor 0 já copiada
+        byte escritos = 0;
+        status = clone.WriteSectors(&(mfrc522.uid), imagem, TIPO, &chave, &escritos);
+        Serial.print(escritos);
+        Serial.println(F(" blocos escritos."));
+        if (status == MFRC522::STATUS_OK && geracao != MFRC522Magic::MAGIC_GENUINE)
         {
-            // Chave encontrada e relatada juntamente com o bloco,
-            // não é necessário tentar outras chaves para este PICC
-            break;
+            memcpy(chave.keyByte, &imagem[3 * 16], MFRC522::MF_KEY_SIZE);
+            if (magico.WriteBlock0(&(mfrc522.uid), &chave, imagem) != MFRC522::STATUS_OK)
+            {
+                Serial.println(F("O bloco 0 (UID) não pode ser escrito neste cartão."));
+            }
         }
     }
+    encerrar(F("Cópia"));
 }